@@ -0,0 +1,307 @@
+#ifndef INCREMENTALLEXER_HPP
+#define INCREMENTALLEXER_HPP
+
+// Incremental relexing on top of the flex scanner.
+// This file is included from the user code section of 2105120.l, so it sees the
+// scanner internals (yylex, yy_scan_buffer, yy_c_buf_p, yy_hold_char, BEGIN).
+// Build the scanner with -DLEXER_NO_MAIN to use it from an editor.
+//
+// Every INITIAL state rule stops at the next newline, so no token's lookahead crosses
+// a line break outside comments and strings. After an edit, relexing restarts at the
+// last token boundary at or before the start of the edited line and stops at the first
+// boundary after the edit that also exists in the old stream with the same start condition.
+//
+// Neither the text nor the tokens are shifted as a whole on an edit: the text is a gap
+// buffer with the gap where relexing starts, and the tokens are kept in blocks holding
+// offsets and lines relative to the block, so only the start of each later block moves.
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+struct RelexResult {
+    int first;    // index of the first token that changed
+    int removed;  // number of old tokens replaced
+    int inserted; // number of new tokens in their place
+};
+
+class IncrementalLexer {
+    static const int GAP = 4096;  // room for insertions made on a new document
+    static const int BLOCK = 512; // tokens per block, a block holds BLOCK to 2 * BLOCK but the last
+
+    // text[0, gap) and text[gap_end, ...) are the document, followed by the two NULs
+    // yy_scan_buffer needs, so the text after the gap can be scanned in place
+    string text;
+    int gap = 0, gap_end = 0;
+    int length = 0; // of the document
+
+    struct Block {
+        int offset, line;        // of the first token
+        vector<LexToken> tokens; // offsets and lines relative to the first token
+    };
+    vector<Block> blocks;
+    int count = 0; // tokens in all the blocks
+
+    // the old token the relexed stream joined, while relexing after an edit of delta characters
+    int delta = 0;
+    int join_block = 0, join_index = 0;
+    static inline IncrementalLexer *relexed = nullptr;
+
+    char at(int offset) const {
+        return offset < gap ? text[offset] : text[offset + gap_end - gap];
+    }
+
+    // move the gap so that it starts at document offset to
+    void move_gap(int to) {
+        if(to < gap) memmove(&text[gap_end - (gap - to)], &text[to], gap - to);
+        else if(to > gap) memmove(&text[gap], &text[gap_end], to - gap);
+        gap_end += to - gap;
+        gap = to;
+    }
+
+    void grow_gap(int needed) {
+        if(gap_end - gap >= needed) return;
+        int extra = max(needed, (int)text.size());
+        text.insert(gap, extra, '\0');
+        gap_end += extra;
+    }
+
+    LexToken absolute(const Block &block, int index) const {
+        LexToken t = block.tokens[index];
+        t.offset += block.offset;
+        t.line += block.line;
+        return t;
+    }
+
+    // the last block starting at or before offset, -1 if there is none
+    int block_at(int offset) const {
+        int low = 0, high = (int)blocks.size();
+        while(low < high) {
+            int middle = (low + high) / 2;
+            if(blocks[middle].offset <= offset) low = middle + 1;
+            else high = middle;
+        }
+        return low - 1;
+    }
+
+    static bool join(int offset, int state) {
+        return relexed->join_at(offset - relexed->delta, state);
+    }
+
+    // whether an old token starts at old_offset in this state, found through resync_at
+    bool join_at(int old_offset, int state) {
+        int b = block_at(old_offset);
+        if(b < 0) return false;
+        const vector<LexToken> &tokens = blocks[b].tokens;
+        auto it = lower_bound(tokens.begin(), tokens.end(), old_offset - blocks[b].offset,
+            [](const LexToken &t, int off) { return t.offset < off; });
+        if(it == tokens.end() || it->offset != old_offset - blocks[b].offset || it->state != state) return false;
+        join_block = b;
+        join_index = (int)(it - tokens.begin());
+        return true;
+    }
+
+    // replace blocks[first, last] with blocks made of tokens, which hold their own offsets and
+    // lines; returns the number of blocks made
+    int rebuild(int first, int last, const vector<LexToken> &tokens) {
+        int size = (int)tokens.size();
+        int made = max(1, size / BLOCK);
+        if(size == 0) made = 0;
+        vector<Block> fresh(made);
+        for(int k = 0, begin = 0; k < made; k++) {
+            int end = (int)((long long)size * (k + 1) / made);
+            Block &block = fresh[k];
+            block.offset = tokens[begin].offset;
+            block.line = tokens[begin].line;
+            for(int i = begin; i < end; i++) {
+                LexToken t = tokens[i];
+                t.offset -= block.offset;
+                t.line -= block.line;
+                block.tokens.push_back(t);
+            }
+            begin = end;
+        }
+        blocks.erase(blocks.begin() + first, blocks.begin() + (last + 1));
+        blocks.insert(blocks.begin() + first, fresh.begin(), fresh.end());
+        return made;
+    }
+
+    // relex the text after the gap, which starts at document offset gap, from line on;
+    // stops at a boundary the old stream also has, after offset from, when resync is set
+    void scan(int line, vector<LexToken> &out, bool resync, int from) {
+        static FILE *null_file = fopen("/dev/null", "w");
+        FILE *saved_log = log_file, *saved_token = token_file;
+        int saved_line = line_count, saved_errors = error_count;
+        log_file = null_file;
+        token_file = null_file;
+        relexing = true;
+        line_count = line;
+
+        string scanned;
+        token_sink = &out;
+        scanned_text = &scanned;
+        relexed = this;
+        resync_at = resync ? join : nullptr;
+        resync_from = from;
+        resynced = false;
+        scan_base = &text[gap_end];
+        scan_base_offset = gap;
+
+        BEGIN(INITIAL);
+        YY_BUFFER_STATE state = yy_scan_buffer(&text[gap_end], text.size() - gap_end);
+        yylex();
+        if(resynced) *yy_c_buf_p = yy_hold_char; // the scan stopped inside the buffer, undo flex's NUL
+        yy_delete_buffer(state);
+
+        // some actions cut yytext in place, put the scanned text back
+        memcpy(&text[gap_end], scanned.data(), scanned.size());
+
+        token_sink = nullptr;
+        scanned_text = nullptr;
+        resync_at = nullptr;
+        relexing = false;
+        log_file = saved_log;
+        token_file = saved_token;
+        line_count = saved_line;
+        error_count = saved_errors;
+    }
+
+    public:
+        IncrementalLexer() {
+            reset("");
+        }
+
+        // full lex of a new document
+        void reset(const string &source) {
+            text.assign(GAP, '\0');
+            text += source;
+            text.append(2, '\0');
+            gap = 0;
+            gap_end = GAP;
+            length = (int)source.size();
+            vector<LexToken> tokens;
+            scan(1, tokens, false, 0);
+            blocks.clear();
+            rebuild(0, -1, tokens);
+            count = (int)tokens.size();
+        }
+
+        // replace removed characters at offset with inserted and relex the affected tokens only
+        RelexResult edit(int offset, int removed, const string &inserted) {
+            int line_start = offset;
+            while(line_start > 0 && at(line_start - 1) != '\n') line_start--;
+
+            // last token boundary at or before the start of the edited line
+            int b = max(block_at(line_start), 0), i = 0;
+            if(!blocks.empty()) {
+                const vector<LexToken> &tokens = blocks[b].tokens;
+                i = (int)(upper_bound(tokens.begin(), tokens.end(), line_start - blocks[b].offset,
+                    [](int off, const LexToken &t) { return off < t.offset; }) - tokens.begin()) - 1;
+                if(i < 0) i = 0;
+                while((b > 0 || i > 0) && blocks[b].tokens[i].state != INITIAL) {
+                    if(--i < 0) i = (int)blocks[--b].tokens.size() - 1;
+                }
+            }
+            int start = 0, line = 1, first = i;
+            if(!blocks.empty()) {
+                LexToken t = absolute(blocks[b], i);
+                start = t.offset;
+                line = t.line;
+            }
+            for(int k = 0; k < b; k++) first += (int)blocks[k].tokens.size();
+
+            move_gap(offset);
+            gap_end += removed;
+            grow_gap((int)inserted.size());
+            memcpy(&text[gap], inserted.data(), inserted.size());
+            gap += (int)inserted.size();
+            length += (int)inserted.size() - removed;
+            move_gap(start);
+
+            delta = (int)inserted.size() - removed;
+            vector<LexToken> fresh;
+            scan(line, fresh, true, offset + (int)inserted.size());
+            int added = (int)fresh.size();
+
+            // the old tokens from the joined one on move by delta and the lines it gained
+            int last = (int)blocks.size() - 1, replaced = count - first, line_delta = 0;
+            if(resynced) {
+                line_delta = resync_line - absolute(blocks[join_block], join_index).line;
+                replaced = join_index - i;
+                for(int k = b; k < join_block; k++) replaced += (int)blocks[k].tokens.size();
+                last = join_block;
+            }
+            count += added - replaced;
+
+            int made = 1;
+            bool inside = resynced && join_block == b && (i > 0 || added > 0);
+            int kept = inside ? i + added + (int)blocks[b].tokens.size() - join_index : 0;
+            if(inside && kept >= BLOCK / 2 && kept <= 2 * BLOCK) {
+                // the edit stays inside one block, which keeps its first token: splice it there
+                Block &block = blocks[b];
+                for(int j = join_index; j < (int)block.tokens.size(); j++) {
+                    block.tokens[j].offset += delta;
+                    block.tokens[j].line += line_delta;
+                }
+                for(LexToken &t : fresh) {
+                    t.offset -= block.offset;
+                    t.line -= block.line;
+                }
+                block.tokens.erase(block.tokens.begin() + i, block.tokens.begin() + join_index);
+                block.tokens.insert(block.tokens.begin() + i, fresh.begin(), fresh.end());
+            }
+            else {
+                // otherwise the blocks it touched are made again, with the next one if they
+                // come out short, so that blocks do not get small
+                vector<LexToken> tokens;
+                for(int k = 0; k < i; k++) tokens.push_back(absolute(blocks[b], k));
+                tokens.insert(tokens.end(), fresh.begin(), fresh.end());
+                if(resynced) {
+                    int size = (int)tokens.size() + (int)blocks[last].tokens.size() - join_index;
+                    if(size < BLOCK && last + 1 < (int)blocks.size()) last++;
+                    for(int k = join_block, from = join_index; k <= last; k++, from = 0) {
+                        for(int j = from; j < (int)blocks[k].tokens.size(); j++) {
+                            LexToken t = absolute(blocks[k], j);
+                            t.offset += delta;
+                            t.line += line_delta;
+                            tokens.push_back(t);
+                        }
+                    }
+                }
+                made = rebuild(b, last, tokens);
+            }
+            for(int k = b + made; k < (int)blocks.size(); k++) {
+                blocks[k].offset += delta;
+                blocks[k].line += line_delta;
+            }
+            return {first, replaced, added};
+        }
+
+        int size() const {
+            return count;
+        }
+
+        LexToken token(int index) const {
+            int b = 0;
+            while(index >= (int)blocks[b].tokens.size()) index -= (int)blocks[b++].tokens.size();
+            return absolute(blocks[b], index);
+        }
+
+        // copies of the whole stream and text, for checking
+        vector<LexToken> getTokens() const {
+            vector<LexToken> all;
+            for(const Block &block : blocks) {
+                for(int i = 0; i < (int)block.tokens.size(); i++) all.push_back(absolute(block, i));
+            }
+            return all;
+        }
+
+        string getText() const {
+            return text.substr(0, gap) + text.substr(gap_end, length - gap);
+        }
+};
+
+#endif
@@ -0,0 +1,88 @@
+// Times IncrementalLexer edits on a generated source of about 1 MB, then checks the
+// token stream they leave against a full lex of the edited text.
+//  - typing:    characters typed one by one in the middle of the file, then erased
+//  - far jumps: one character changed at random places all over the file
+// usage: ./bench-incremental.out [bytes] [edits]   (built by bench-incremental.sh)
+
+#define LEXER_NO_MAIN
+#include "lex.yy.c"
+
+#include <chrono>
+#include <random>
+
+static const char *unit_text =
+    "int f%d(int a, float b) {\n"
+    "    /* running\n"
+    "       total */\n"
+    "    int s = a * 2 + 3, t[10];\n"
+    "    char c = 'x';\n"
+    "    if(s >= 10 && b < 2.5e1) s = s - 1; // one less\n"
+    "    printf(\"%%d\\n\", s);\n"
+    "    return s;\n"
+    "}\n";
+
+struct EditTimes {
+    int count = 0;
+    double total = 0, longest = 0; // microseconds
+};
+
+void timed_edit(IncrementalLexer &lexer, EditTimes &times, int offset, int removed, const string &inserted) {
+    auto begin = chrono::steady_clock::now();
+    lexer.edit(offset, removed, inserted);
+    double us = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+    times.count++;
+    times.total += us;
+    times.longest = max(times.longest, us);
+}
+
+void print_times(const char *name, const EditTimes &times) {
+    printf("%-10s %6d edits, mean %8.2f us, max %8.2f us\n", name, times.count, times.total / times.count, times.longest);
+}
+
+int main(int argc, char *argv[]) {
+    int bytes = argc > 1 ? atoi(argv[1]) : 1 << 20;
+    int edits = argc > 2 ? atoi(argv[2]) : 2000;
+
+    string source;
+    char unit[512];
+    for(int n = 0; (int)source.size() < bytes; n++) {
+        snprintf(unit, sizeof unit, unit_text, n);
+        source += unit;
+    }
+
+    IncrementalLexer lexer;
+    auto begin = chrono::steady_clock::now();
+    lexer.reset(source);
+    double full_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    printf("document   %d bytes, %d tokens, full lex %.2f ms\n", (int)source.size(), lexer.size(), full_ms);
+
+    EditTimes typing, far;
+    string typed = "s = s + 1; /* more */\n";
+    int cursor = (int)source.size() / 2;
+    while(cursor > 0 && source[cursor - 1] != '\n') cursor--;
+    for(int i = 0; i < edits / 2; i++) {
+        timed_edit(lexer, typing, cursor, 0, string(1, typed[i % typed.size()]));
+        cursor++;
+    }
+    for(int i = 0; i < edits / 2; i++) timed_edit(lexer, typing, --cursor, 1, "");
+
+    mt19937 random(2105120);
+    for(int i = 0; i < edits; i++) {
+        int offset = random() % source.size(); // the length is the same after each edit
+        timed_edit(lexer, far, offset, 1, "q");
+    }
+
+    print_times("typing", typing);
+    print_times("far jumps", far);
+
+    IncrementalLexer full;
+    full.reset(lexer.getText());
+    vector<LexToken> incremental = lexer.getTokens(), expected = full.getTokens();
+    bool same = incremental.size() == expected.size();
+    for(size_t i = 0; same && i < expected.size(); i++) {
+        const LexToken &a = incremental[i], &b = expected[i];
+        same = a.offset == b.offset && a.length == b.length && a.line == b.line && a.state == b.state && a.rule == b.rule;
+    }
+    printf("tokens after the edits %s a full lex\n", same ? "match" : "DO NOT match");
+    return same ? 0 : 1;
+}
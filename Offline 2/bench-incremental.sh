@@ -0,0 +1,7 @@
+#!/usr/bin/bash
+
+# Times incremental relexing on a generated 1 MB source, see bench-incremental.cpp
+# usage: ./bench-incremental.sh [bytes] [edits]
+flex 2105120.l
+g++ -std=c++17 -O2 bench-incremental.cpp -o bench-incremental.out
+./bench-incremental.out "$@"
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "2105120_SymbolTable.hpp"
+#include "2105120_Type.hpp"
+#include "2105120_LogSink.hpp"
+
+using namespace std;
+
+// Everything one compilation of one file reads and writes: its outputs, the symbol table
+// and the values the grammar actions pass between rules. The lexer and the parser point
+// at the compilation they are working on, so a process can check many files, one after
+// another or on several threads at once, each file with a compilation of its own.
+struct Compilation {
+    LogSink parserLogFile;
+    LogSink errorFile;
+    LogSink lexLogFile;
+
+    int syntaxErrorCount = 0;
+
+    SymbolTable symbolTable{7};
+
+    TypeId current_const_type = TYPE_NONE, assign_type = TYPE_NONE, var_type = TYPE_NONE, term_operand_type = TYPE_NONE, unary_e_operand_type = TYPE_NONE;
+    vector<pair<string, SymbolKind>> declaration_list_ids; // names waiting for the type of their declaration
+    bool is_func_declaration = false;
+    bool is_func_definition = false;
+    vector<pair<string, TypeId>> parameter_list_ids;
+    vector<TypeId> argument_list_types;
+
+    SymbolInfo* currentFunction = nullptr; // pointer to the current function being processed
+
+    // open parserLog.txt, errorLog.txt and lexerLog.txt in the directory, which must exist
+    bool open(const string &outputDirectory, bool asyncLog) {
+        if (!parserLogFile.open(outputDirectory + "parserLog.txt", false, asyncLog)) {
+            cerr << "Error opening parser log file: " << outputDirectory << "parserLog.txt" << endl;
+            return false;
+        }
+        if (!errorFile.open(outputDirectory + "errorLog.txt", false, asyncLog)) {
+            cerr << "Error opening error log file: " << outputDirectory << "errorLog.txt" << endl;
+            return false;
+        }
+        if (!lexLogFile.open(outputDirectory + "lexerLog.txt", false, asyncLog)) {
+            cerr << "Error opening lexer log file: " << outputDirectory << "lexerLog.txt" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    // back to where it was before the parse; the lexer log is kept since the token
+    // stream is not lexed again
+    void restart() {
+        syntaxErrorCount = 0;
+        symbolTable.reset();
+        current_const_type = assign_type = var_type = term_operand_type = unary_e_operand_type = TYPE_NONE;
+        declaration_list_ids.clear();
+        is_func_declaration = false;
+        is_func_definition = false;
+        parameter_list_ids.clear();
+        argument_list_types.clear();
+        currentFunction = nullptr;
+
+        parserLogFile.discard();
+        errorFile.discard();
+    }
+
+    void close() {
+        parserLogFile.close();
+        errorFile.close();
+        lexLogFile.close();
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <sys/resource.h>
+#include "antlr4-runtime.h"
+
+using namespace std;
+
+// Numbers printed by --stats, used to compare grammar variants and prediction modes:
+// wall time of the first parse and of the repeated ones (--repeat=N, after the decision
+// DFA is warm), how many parses fell back to full LL, number of rule context objects in
+// the tree, depth of the tree and the peak resident memory of the process. A compile that
+// parses into the AST first (--ast) also reports the AST size and the time of the passes.
+struct ParseStats {
+    double parseMilliseconds = 0;
+    double steadyParseMilliseconds = 0;
+    int runs = 0;
+    int fullLLFallbacks = 0;
+    size_t contexts = 0;
+    size_t depth = 0;
+    long peakMemoryKB = 0;
+    size_t astBytes = 0;
+    double passMilliseconds = 0;
+};
+
+// walks the tree with an explicit stack, a left recursive tree can be deeper than the call stack allows
+inline void countContexts(antlr4::tree::ParseTree *root, ParseStats &stats) {
+    vector<pair<antlr4::tree::ParseTree *, size_t>> pending;
+    if(root != nullptr) pending.push_back({root, 1});
+    while(!pending.empty()) {
+        auto [node, depth] = pending.back();
+        pending.pop_back();
+        if(node->getTreeType() == antlr4::tree::ParseTreeType::RULE) stats.contexts++;
+        if(depth > stats.depth) stats.depth = depth;
+        for(antlr4::tree::ParseTree *child : node->children) pending.push_back({child, depth + 1});
+    }
+}
+
+inline long peakMemoryKB() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// parse 'runs' times, restarting the compilation in between, then collect the numbers
+template <typename Parse, typename Restart>
+void measureParse(ParseStats &stats, Parse parse, Restart restart, int runs = 1) {
+    antlr4::tree::ParseTree *tree = nullptr;
+    double steadyTotal = 0;
+    for(int run = 0; run < runs; run++) {
+        if(run > 0) restart();
+        auto begin = chrono::steady_clock::now();
+        tree = parse();
+        auto end = chrono::steady_clock::now();
+        double milliseconds = chrono::duration<double, milli>(end - begin).count();
+        if(run == 0) stats.parseMilliseconds = milliseconds;
+        else steadyTotal += milliseconds;
+    }
+    stats.runs = runs;
+    if(runs > 1) stats.steadyParseMilliseconds = steadyTotal / (runs - 1);
+    countContexts(tree, stats);
+    stats.peakMemoryKB = peakMemoryKB();
+}
+
+inline void printParseStats(ostream &out, const ParseStats &stats) {
+    out << "first parse time: " << stats.parseMilliseconds << " ms" << endl;
+    if(stats.runs > 1) out << "steady parse time: " << stats.steadyParseMilliseconds << " ms (mean of " << stats.runs - 1 << " runs)" << endl;
+    out << "full LL fallbacks: " << stats.fullLLFallbacks << " of " << stats.runs << " parses" << endl;
+    out << "contexts: " << stats.contexts << endl;
+    out << "tree depth: " << stats.depth << endl;
+    if(stats.astBytes > 0) {
+        out << "AST: " << stats.astBytes << " bytes" << endl;
+        out << "passes over the AST: " << stats.passMilliseconds << " ms" << endl;
+    }
+    out << "peak memory: " << stats.peakMemoryKB << " KB" << endl;
+}
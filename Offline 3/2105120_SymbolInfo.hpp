@@ -2,18 +2,26 @@
 
 #include<iostream>
 #include<string>
+#include "2105120_Type.hpp"
 using namespace std;
 
+// what a declared name stands for; the element type of a variable or array is its type
+enum SymbolKind {
+    KIND_UNKNOWN,  // functions, parameters
+    KIND_VARIABLE,
+    KIND_ARRAY
+};
+
 class SymbolInfo {
     string name, type;
+    TypeId type_id; // interned type; for functions the signature, which holds return and parameter types
     SymbolInfo * next;
+    SymbolKind kind = KIND_UNKNOWN;
 
-    string func_return_type;
     bool declared = false; // flag to check if the symbol is declared
-    vector<pair<string, string>> func_params; // vector of pairs to store parameter name and type
 
     public:
-        SymbolInfo(string name, string type, SymbolInfo * next = nullptr) : name(name), type(type), next(next) {}
+        SymbolInfo(string name, string type, SymbolInfo * next = nullptr) : name(name), type(type), type_id(typeTable.intern(type)), next(next) {}
 
         ~SymbolInfo() {
             if(next != nullptr) {
@@ -29,6 +37,26 @@ class SymbolInfo {
             return type;
         }
 
+        TypeId getTypeId() const {
+            return type_id;
+        }
+
+        bool isFunction() const {
+            return typeTable.isFunction(type_id);
+        }
+
+        SymbolKind getKind() const {
+            return kind;
+        }
+
+        bool isArray() const {
+            return kind == KIND_ARRAY;
+        }
+
+        void setKind(SymbolKind kind) {
+            this->kind = kind;
+        }
+
         SymbolInfo * getNext() const {
             return next;
         }
@@ -39,6 +67,7 @@ class SymbolInfo {
 
         void setType(const string& type) {
             this->type = type;
+            type_id = typeTable.intern(type);
         }
 
         void setNext(SymbolInfo * next) {
@@ -58,24 +87,30 @@ class SymbolInfo {
             return "< " + name + " : " + "ID" + " >";
         }
 
-        string getFuncReturnType() const {
-            return func_return_type;
+        TypeId getFuncReturnType() const {
+            return typeTable.returnType(type_id);
         }
 
-        void setFuncReturnType(const string return_type) {
-            func_return_type = return_type;
+        void setFuncReturnType(TypeId return_type) {
+            if(!isFunction()) return; // only a function symbol has a signature
+            vector<TypeId> params = typeTable.parameters(type_id);
+            type_id = typeTable.signature(return_type, params);
         }
 
-        vector<pair<string, string>> getFuncParams() const {
-            return func_params;
+        const vector<TypeId> &getFuncParamTypes() const {
+            return typeTable.parameters(type_id);
         }
-        
-        void setFuncParams(vector<pair<string, string>> params) {
-            func_params = params;
+
+        // parameters as (name, type) pairs, only the types are part of the signature
+        void setFuncParams(const vector<pair<string, TypeId>> &params) {
+            if(!isFunction()) return;
+            vector<TypeId> param_types;
+            for(const pair<string, TypeId> &param : params) param_types.push_back(param.second);
+            type_id = typeTable.signature(getFuncReturnType(), param_types);
         }
 
         int getFuncParamsSize() const {
-            return func_params.size();
+            return getFuncParamTypes().size();
         }
 
         bool getDeclarationStatus() {
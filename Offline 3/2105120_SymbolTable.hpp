@@ -29,6 +29,15 @@ class SymbolTable {
             // The destructor of ScopeTable will take care of deleting its parent scopes
         }
 
+        // drop every scope and start over from an empty global scope
+        void reset() {
+            delete currentScope; // deletes the parent scopes too
+            currentScope = nullptr;
+            num_scopes = 0;
+            numberOfCollisions = 0;
+            enterScope();
+        }
+
         void enterScope(bool verbose = false) {
             if(currentScope != nullptr) {
                 currentScope->incrementNumChildren();
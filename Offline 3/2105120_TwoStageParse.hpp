@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include "antlr4-runtime.h"
+
+using namespace std;
+
+// Two-stage parse. The first attempt predicts with SLL only and gives up at the first
+// syntax error instead of recovering. Only when it gives up (a real syntax error, or one
+// of the rare inputs that need full context) is the input parsed again with full LL
+// prediction and the usual error recovery.
+// The grammar actions of the abandoned attempt have already run, so restart() must put
+// the compilation state, the outputs and the parser back to where they were before it.
+// rule() parses from any rule, e.g. one top-level unit at a time.
+template <typename Parser, typename Rule, typename Restart>
+auto parseTwoStage(Parser &parser, Rule rule, Restart restart, int &fallbacks) -> decltype(rule()) {
+    antlr4::atn::ParserATNSimulator *interpreter = parser.template getInterpreter<antlr4::atn::ParserATNSimulator>();
+    shared_ptr<antlr4::ANTLRErrorStrategy> recovery = parser.getErrorHandler();
+
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+    parser.setErrorHandler(make_shared<antlr4::BailErrorStrategy>());
+    try {
+        auto tree = rule();
+        parser.setErrorHandler(recovery);
+        return tree;
+    } catch (antlr4::ParseCancellationException &) {
+        fallbacks++;
+        restart();
+        interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
+        parser.setErrorHandler(recovery);
+        return rule();
+    }
+}
+
+// the whole program from the start rule
+template <typename Parser, typename Restart>
+auto parseTwoStage(Parser &parser, Restart restart, int &fallbacks) -> decltype(parser.start()) {
+    return parseTwoStage(parser, [&] { return parser.start(); }, restart, fallbacks);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+using namespace std;
+
+// Interned types for the semantic checks.
+// Every distinct type is stored once and named by a small integer id, so type checks
+// compare ids instead of strings. Function types are signatures: a return type and the
+// parameter types, interned the same way, so two functions with the same signature
+// share one id. Type names are kept only for messages and the symbol table dump.
+typedef int TypeId;
+
+enum BuiltinType : TypeId {
+    TYPE_NONE,  // no type yet, the empty string of the old checks
+    TYPE_INT,
+    TYPE_FLOAT,
+    TYPE_VOID,
+    TYPE_ARRAY, // an array used where a value is expected, e.g. as an argument
+    TYPE_FUNC   // a function whose signature is not known yet
+};
+
+class TypeTable {
+    struct Type {
+        string name;
+        bool function;
+        TypeId returnType;
+        vector<TypeId> parameters;
+    };
+
+    deque<Type> types; // a deque keeps references to parameter lists valid while types are added
+    map<string, TypeId> byName;
+    map<vector<TypeId>, TypeId> bySignature; // key is the return type followed by the parameter types
+
+    public:
+        TypeTable() {
+            for(const char *name : {"", "int", "float", "void", "array"}) intern(name);
+            types.push_back({"func", true, TYPE_NONE, {}});
+            bySignature[{TYPE_NONE}] = TYPE_FUNC;
+        }
+
+        // id of a named type, "func" is the function type without a signature
+        TypeId intern(const string &name) {
+            map<string, TypeId>::iterator it = byName.find(name);
+            if(it != byName.end()) return it->second;
+            if(name == "func") return TYPE_FUNC;
+            TypeId id = types.size();
+            types.push_back({name, false, TYPE_NONE, {}});
+            byName[name] = id;
+            return id;
+        }
+
+        TypeId signature(TypeId returnType, const vector<TypeId> &parameters) {
+            vector<TypeId> key;
+            key.reserve(parameters.size() + 1);
+            key.push_back(returnType);
+            key.insert(key.end(), parameters.begin(), parameters.end());
+            map<vector<TypeId>, TypeId>::iterator it = bySignature.find(key);
+            if(it != bySignature.end()) return it->second;
+            TypeId id = types.size();
+            types.push_back({"func", true, returnType, parameters});
+            bySignature[key] = id;
+            return id;
+        }
+
+        const string &name(TypeId id) const {
+            return types[id].name;
+        }
+
+        bool isFunction(TypeId id) const {
+            return types[id].function;
+        }
+
+        TypeId returnType(TypeId id) const {
+            return types[id].returnType;
+        }
+
+        const vector<TypeId> &parameters(TypeId id) const {
+            return types[id].parameters;
+        }
+};
+
+// one table per thread: files checked on different threads never share TypeIds
+inline thread_local TypeTable typeTable;
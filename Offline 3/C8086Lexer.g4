@@ -5,21 +5,37 @@ lexer grammar C8086Lexer;
     #include <iostream>
     #include <fstream>
     #include <string>
+    #include "2105120_LogSink.hpp"
+    #include "2105120_LogCategory.hpp"
 
-    extern std::ofstream lexLogFile;
+    // token log lines vanish when LOG_LEXER_TOKENS is compiled out or switched off
+    #define LOG_TOKEN(token) LOG_IF(LOG_LEXER_TOKENS) logToken(token)
 }
 
 @lexer::members {
-    void writeIntoLexLogFile(const std::string &message) {
-        if (!lexLogFile.is_open()) {
-            lexLogFile.open("lexLogFile.txt", std::ios::app);
-            if (!lexLogFile) {
+    LogSink *lexLogFile = nullptr; // the lexer log of the file being checked, set by the driver
+
+    bool openLexLogFile() {
+        if (lexLogFile == nullptr) return false;
+        if (!lexLogFile->is_open()) {
+            lexLogFile->open("lexLogFile.txt", true);
+            if (!*lexLogFile) {
                 std::cerr << "Error opening lexLogFile.txt" << std::endl;
-                return;
+                return false;
             }
         }
-        lexLogFile << message << std::endl;
-        lexLogFile.flush();
+        return true;
+    }
+
+    void writeIntoLexLogFile(const std::string &message) {
+        if (!openLexLogFile()) return;
+        *lexLogFile << message << '\n';
+    }
+
+    // one log line per token, formatted straight into the sink
+    void logToken(const char *token) {
+        if (!openLexLogFile()) return;
+        *lexLogFile << "Line# " << getLine() << ": Token <" << token << "> Lexeme " << getText() << '\n';
     }
 }
 
@@ -30,27 +46,14 @@ lexer grammar C8086Lexer;
 // Single-line comments: '//' then anything except newline
 LINE_COMMENT
     : '//' ~[\r\n]* {
-        writeIntoLexLogFile(
-          "Line# " + std::to_string(getLine())
-          + ": Token <SINGLE LINE COMMENT> Lexeme "
-          + getText()
-        );
+        LOG_TOKEN("SINGLE LINE COMMENT");
     } -> skip
     ;
 
 // Multi-line comments
 BLOCK_COMMENT
   : '/*' ( . | '\r' | '\n' )*? '*/' {
-      // extra braces create a new scope for your variables
-      {
-        std::string txt = getText();
-        std::string content = txt.substr(2, txt.size() - 4);
-        writeIntoLexLogFile(
-          "Line# " + std::to_string(getLine())
-          + ": Token <MULTI LINE COMMENT> Lexeme /*"
-          + content + "*/"
-        );
-      }
+      LOG_TOKEN("MULTI LINE COMMENT");
     }
     -> skip
   ;
@@ -63,10 +66,7 @@ BLOCK_COMMENT
 // A basic string rule with escape support :contentReference[oaicite:5]{index=5}
 STRING
     : '"' ( '\\' . | ~["\\\r\n] )* '"' {
-        writeIntoLexLogFile(
-          "Line# " + std::to_string(getLine())
-          + ": Token <STRING> Lexeme " + getText()
-        );
+        LOG_TOKEN("STRING");
     } -> skip
     ;
 
@@ -80,59 +80,50 @@ WS      : [ \t\f\r\n]+ -> skip ;
 // 4) Keywords & Symbols
 // ------------------------------
 
-IF       : 'if' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <IF> Lexeme " + getText()); };
-ELSE     : 'else' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <ELSE> Lexeme " + getText()); };
-FOR      : 'for' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <FOR> Lexeme " + getText()); };
-WHILE    : 'while' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <WHILE> Lexeme " + getText()); };
-PRINTLN  : 'printf' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <PRINTLN> Lexeme " + getText()); };
-RETURN   : 'return' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <RETURN> Lexeme " + getText()); };
-INT      : 'int' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <INT> Lexeme " + getText()); };
-FLOAT    : 'float' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <FLOAT> Lexeme " + getText()); };
-VOID     : 'void' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <VOID> Lexeme " + getText()); };
-
-LPAREN   : '(' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <LPAREN> Lexeme " + getText()); };
-RPAREN   : ')' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <RPAREN> Lexeme " + getText()); };
-LCURL    : '{' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <LCURL> Lexeme " + getText()); };
-RCURL    : '}' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <RCURL> Lexeme " + getText()); };
-LTHIRD   : '[' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <LTHIRD> Lexeme " + getText()); };
-RTHIRD   : ']' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <RTHIRD> Lexeme " + getText()); };
-SEMICOLON: ';' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <SEMICOLON> Lexeme " + getText()); };
-COMMA    : ',' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <COMMA> Lexeme " + getText()); };
-
-
-ADDOP    : [+\-] { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <ADDOP> Lexeme " + getText()); };
-SUBOP    : [+\-] { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <SUBOP> Lexeme " + getText()); };
-MULOP    : [*/%] { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <MULOP> Lexeme " + getText()); };
-INCOP    : '++' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <INCOP> Lexeme " + getText()); };
-DECOP    : '--' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <DECOP> Lexeme " + getText()); };
-NOT      : '!' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <NOT> Lexeme " + getText()); };
-RELOP    : '<=' | '==' | '>=' | '>' | '<' | '!=' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <RELOP> Lexeme " + getText()); };
-LOGICOP  : '&&' | '||' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <LOGICOP> Lexeme " + getText()); };
-ASSIGNOP : '=' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <ASSIGNOP> Lexeme " + getText()); };
-UNRECOGNIZED : '#' { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <UNRECOGNIZED> Lexeme " + getText()); };
+IF       : 'if' { LOG_TOKEN("IF"); };
+ELSE     : 'else' { LOG_TOKEN("ELSE"); };
+FOR      : 'for' { LOG_TOKEN("FOR"); };
+WHILE    : 'while' { LOG_TOKEN("WHILE"); };
+PRINTLN  : 'printf' { LOG_TOKEN("PRINTLN"); };
+RETURN   : 'return' { LOG_TOKEN("RETURN"); };
+INT      : 'int' { LOG_TOKEN("INT"); };
+FLOAT    : 'float' { LOG_TOKEN("FLOAT"); };
+VOID     : 'void' { LOG_TOKEN("VOID"); };
+
+LPAREN   : '(' { LOG_TOKEN("LPAREN"); };
+RPAREN   : ')' { LOG_TOKEN("RPAREN"); };
+LCURL    : '{' { LOG_TOKEN("LCURL"); };
+RCURL    : '}' { LOG_TOKEN("RCURL"); };
+LTHIRD   : '[' { LOG_TOKEN("LTHIRD"); };
+RTHIRD   : ']' { LOG_TOKEN("RTHIRD"); };
+SEMICOLON: ';' { LOG_TOKEN("SEMICOLON"); };
+COMMA    : ',' { LOG_TOKEN("COMMA"); };
+
+
+ADDOP    : [+\-] { LOG_TOKEN("ADDOP"); };
+SUBOP    : [+\-] { LOG_TOKEN("SUBOP"); };
+MULOP    : [*/%] { LOG_TOKEN("MULOP"); };
+INCOP    : '++' { LOG_TOKEN("INCOP"); };
+DECOP    : '--' { LOG_TOKEN("DECOP"); };
+NOT      : '!' { LOG_TOKEN("NOT"); };
+RELOP    : '<=' | '==' | '>=' | '>' | '<' | '!=' { LOG_TOKEN("RELOP"); };
+LOGICOP  : '&&' | '||' { LOG_TOKEN("LOGICOP"); };
+ASSIGNOP : '=' { LOG_TOKEN("ASSIGNOP"); };
+UNRECOGNIZED : '#' { LOG_TOKEN("UNRECOGNIZED"); };
 // ------------------------------
 // 5) Identifiers & Numbers
 // ------------------------------
 
-ID         : [A-Za-z_] [A-Za-z0-9_]* { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <ID> Lexeme " + getText()); };
-CONST_INT  : [0-9]+ { writeIntoLexLogFile("Line# " + std::to_string(getLine()) + ": Token <CONST_INT> Lexeme " + getText()); };
+ID         : [A-Za-z_] [A-Za-z0-9_]* { LOG_TOKEN("ID"); };
+CONST_INT  : [0-9]+ { LOG_TOKEN("CONST_INT"); };
 CONST_FLOAT
     : [0-9]+ ('.' [0-9]*)? ([Ee][+\-]? [0-9]+)? {
-        writeIntoLexLogFile(
-          "Line# " + std::to_string(getLine())
-          + ": Token <CONST_FLOAT> Lexeme " + getText()
-        );
+        LOG_TOKEN("CONST_FLOAT");
     }
     | '.' [0-9]+ {
-        writeIntoLexLogFile(
-          "Line# " + std::to_string(getLine())
-          + ": Token <CONST_FLOAT> Lexeme " + getText()
-        );
+        LOG_TOKEN("CONST_FLOAT");
     }
     | [0-9]+ '.' {
-        writeIntoLexLogFile(
-          "Line# " + std::to_string(getLine())
-          + ": Token <CONST_FLOAT> Lexeme " + getText()
-        );
+        LOG_TOKEN("CONST_FLOAT");
     }
     ;
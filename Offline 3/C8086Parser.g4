@@ -9,115 +9,155 @@ options {
     #include <fstream>
     #include <string>
     #include <cstdlib>
+    #include <sstream>
     #include "C8086Lexer.h"
 	#include "2105120_SymbolTable.hpp"
+	#include "2105120_Type.hpp"
+	#include "2105120_LogSink.hpp"
+	#include "2105120_LogCategory.hpp"
+	#include "2105120_Compilation.hpp"
 	#include <vector>
 	#include <map>
 
-    extern std::ofstream parserLogFile;
-    extern std::ofstream errorFile;
-
-    extern int syntaxErrorCount;
-
-	extern SymbolTable symbolTable;
-	
-	extern std::string current_const_type, assign_type, var_type, term_operand_type, unary_e_operand_type;
-
-	extern vector<string> declaration_list_ids;
-	extern map<string, string> variableTypes;
-	extern bool is_func_declaration, is_func_definition;
-	extern vector<pair<string, string>> parameter_list_ids;
-	extern SymbolInfo *currentFunction;
-	extern vector<string> argument_list_types;
+    // logging statements compile to nothing when their category is compiled out
+    #define LOG_REDUCTION(...) LOG_IF(LOG_PARSER_REDUCTIONS) writeIntoparserLogFile(__VA_ARGS__)
+    #define LOG_RULE_TEXT(start) LOG_IF(LOG_PARSER_REDUCTIONS) writeRuleText(start)
+    #define LOG_ERROR(...) LOG_IF(LOG_ERRORS) { writeIntoparserLogFile(__VA_ARGS__, "\n"); writeIntoErrorFile(__VA_ARGS__, "\n"); }
 }
 
 @parser::members {
-    void writeIntoparserLogFile(const std::string message) {
-        if (!parserLogFile) {
+    Compilation *compilation = nullptr; // the file being checked, set by the driver
+
+    template <typename... Parts>
+    void writeIntoparserLogFile(const Parts &... parts) {
+        if (!compilation->parserLogFile) {
             std::cout << "Error opening parserLogFile.txt" << std::endl;
             return;
         }
 
-        parserLogFile << message << std::endl;
-        parserLogFile.flush();
+        (compilation->parserLogFile << ... << parts) << '\n';
     }
 
-    void writeIntoErrorFile(const std::string message) {
-        if (!errorFile) {
+    template <typename... Parts>
+    void writeIntoErrorFile(const Parts &... parts) {
+        if (!compilation->errorFile) {
             std::cout << "Error opening errorFile.txt" << std::endl;
             return;
         }
-        errorFile << message << std::endl;
-        errorFile.flush();
+        (compilation->errorFile << ... << parts) << '\n';
     }
 
-	void function_def(const std::string name, const std::string ret_type)
+	// rule text is not built as strings; a rule's text is its token interval, rendered
+	// with the separators and hidden tokens the grammar actions recorded per token
+	struct TokenLayout {
+		char separator = 0; // written before the token when it is not the first of an interval
+		bool hidden = false; // tokens dropped from the text by error alternatives
+	};
+	std::vector<TokenLayout> tokenLayout;
+
+	TokenLayout &layoutOf(size_t index) {
+		if(index >= tokenLayout.size()) tokenLayout.resize(index + 1);
+		return tokenLayout[index];
+	}
+
+	void setSeparator(antlr4::Token *token, char separator) {
+		layoutOf(token->getTokenIndex()).separator = separator;
+	}
+
+	// hide every token from 'from' to the last consumed one
+	void hideTokens(antlr4::Token *from) {
+		size_t last = _input->LT(-1)->getTokenIndex();
+		for(size_t i = from->getTokenIndex(); i <= last; i++) {
+			TokenLayout &layout = layoutOf(i);
+			layout.hidden = true;
+			if(i > from->getTokenIndex()) layout.separator = 0;
+		}
+	}
+
+	template <typename Out>
+	void renderTokens(Out &out, antlr4::Token *from, antlr4::Token *to) {
+		if(from == nullptr || to == nullptr) return;
+		size_t first = from->getTokenIndex(), last = to->getTokenIndex();
+		if(last == antlr4::INVALID_INDEX || last < first) return; // empty alternative
+		for(size_t i = first; i <= last; i++) {
+			const TokenLayout &layout = layoutOf(i);
+			if(i > first && layout.separator) out << layout.separator;
+			if(!layout.hidden) out << _input->get(i)->getText();
+		}
+	}
+
+	// log the text of the tokens from 'from' to the last consumed one
+	void writeRuleText(antlr4::Token *from) {
+		if (!compilation->parserLogFile) {
+			std::cout << "Error opening parserLogFile.txt" << std::endl;
+			return;
+		}
+		renderTokens(compilation->parserLogFile, from, _input->LT(-1));
+		compilation->parserLogFile << "\n\n";
+	}
+
+	// text of a finished rule, for the few checks that compare it
+	std::string getRuleText(antlr4::ParserRuleContext *ctx) {
+		std::ostringstream out;
+		renderTokens(out, ctx->start, ctx->stop);
+		return out.str();
+	}
+
+	void function_def(const std::string name, TypeId ret_type)
 	{
-		SymbolInfo *info = symbolTable.lookup(name);
+		SymbolInfo *info = compilation->symbolTable.lookup(name);
 		if(info == nullptr)
 		{
-			symbolTable.insert(name, "func");
-			SymbolInfo *f = symbolTable.lookup(name);
+			compilation->symbolTable.insert(name, "func");
+			SymbolInfo *f = compilation->symbolTable.lookup(name);
 			f->setFuncReturnType(ret_type);
 		}
 	}
 
-	void type_error_check(const std::string name, const std::string ret_type, const std::string line)
+	void type_error_check(const std::string name, TypeId ret_type, const std::string line)
 	{
-		SymbolInfo *info = symbolTable.lookup(name);
-		std::string type = info->getType();
-		if(type != "func")
+		SymbolInfo *info = compilation->symbolTable.lookup(name);
+		if(!info->isFunction())
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + line + ": Multiple declaration of " + name;
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");	
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Multiple declaration of ", name);
 			return;			
 		}
 		int paramCount = info->getFuncParamsSize();
-		if(paramCount != parameter_list_ids.size() && info->getDeclarationStatus() == true)
+		if(paramCount != compilation->parameter_list_ids.size() && info->getDeclarationStatus() == true)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + line + ": Total number of arguments mismatch with declaration in function " + name;
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");	
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Total number of arguments mismatch with declaration in function ", name);
 			return;			
 		}
-		info->setFuncParams(parameter_list_ids);
-		std::string ret = info->getFuncReturnType();
-		if(ret != ret_type)
+		info->setFuncParams(compilation->parameter_list_ids);
+		if(info->getFuncReturnType() != ret_type)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + line + ": Return type mismatch of " + name;
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Return type mismatch of ", name);
 		}
 	}
 
 	void check_argument(const std::string name, const std::string line)
 	{
-		SymbolInfo *info = symbolTable.lookup(name);
+		SymbolInfo *info = compilation->symbolTable.lookup(name);
 		if(info == nullptr) return;
-		vector<pair<string, string>> params = info->getFuncParams();
+		const vector<TypeId> &params = info->getFuncParamTypes();
 		// std::cout << params.size() << " " << argument_list_types.size() << " " << name << "\n";
-		if(params.size() != argument_list_types.size())
+		if(params.size() != compilation->argument_list_types.size())
 		{	
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + line + ": Total number of arguments mismatch with declaration in function " + name;
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Total number of arguments mismatch with declaration in function ", name);
 			return;
 		}
 		else 
 		{
 			for(int i = 0; i < params.size(); i++)
 			{
-				if(params[i].second != argument_list_types[i])
+				if(params[i] != compilation->argument_list_types[i])
 				{
-					syntaxErrorCount++;
-					std::string errorMessage = "Error at line " + line + ": " + std::to_string(i + 1) + "th argument mismatch in function " + name;
-					writeIntoparserLogFile(errorMessage + "\n");
-					writeIntoErrorFile(errorMessage + "\n");
+					compilation->syntaxErrorCount++;
+					LOG_ERROR("Error at line ", line, ": ", i + 1, "th argument mismatch in function ", name);
 					return;
 				}
 			}
@@ -128,217 +168,209 @@ options {
 
 start : p=program
 	{
-		writeIntoparserLogFile("Line " + std::to_string($p.stop->getLine()) + ": start : program\n");
-		writeIntoparserLogFile(symbolTable.getSymbolTableAsString());
-		writeIntoparserLogFile("Total number of lines: " + std::to_string($p.stop->getLine()));
-		writeIntoparserLogFile("Total number of errors: " + std::to_string(syntaxErrorCount));
+		LOG_REDUCTION("Line ", $p.stop->getLine(), ": start : program\n");
+		LOG_IF(LOG_SYMBOL_TABLE) writeIntoparserLogFile(compilation->symbolTable.getSymbolTableAsString());
+		LOG_REDUCTION("Total number of lines: ", $p.stop->getLine());
+		LOG_REDUCTION("Total number of errors: ", compilation->syntaxErrorCount);
 	}
 	;
 
-program returns [std::string program_text]
-	: p=program un=unit 
+program
+	: un=unit 
 	{
-		$program_text = $p.program_text + "\n" + $un.unit_text;
-		writeIntoparserLogFile("Line " + std::to_string($un.stop->getLine()) + ": program : program unit\n");
-		writeIntoparserLogFile($p.program_text + "\n" + $un.unit_text + "\n");
-	} 
-	| un=unit 
-	{
-		$program_text = $un.unit_text;
-		writeIntoparserLogFile("Line " + std::to_string($un.stop->getLine()) + ": program : unit\n");
-		writeIntoparserLogFile($un.unit_text + "\n");
+		LOG_REDUCTION("Line ", $un.stop->getLine(), ": program : unit\n");
+		LOG_RULE_TEXT($start);
 	}
+	( un=unit 
+	{
+		setSeparator($un.start, '\n');
+		LOG_REDUCTION("Line ", $un.stop->getLine(), ": program : program unit\n");
+		LOG_RULE_TEXT($start);
+	} 
+	)*
 	;
 	
-unit returns [std::string unit_text]
+unit
 	: vd=var_declaration 
 	{
-		$unit_text = $vd.vd_text;
-		writeIntoparserLogFile(
-			"Line " + std::to_string($vd.start->getLine()) + ": unit : var_declaration\n"
-		);
-		writeIntoparserLogFile(
-			$vd.vd_text + "\n"
-		);
+		LOG_REDUCTION("Line ", $vd.start->getLine(), ": unit : var_declaration\n");
+		LOG_RULE_TEXT($start);
 	}
     | fd=func_declaration
 	{
-		$unit_text = $fd.fd_text;
-		writeIntoparserLogFile("Line " + std::to_string($fd.start->getLine()) + ": unit : func_declaration\n");
-		writeIntoparserLogFile($fd.fd_text + "\n");
+		LOG_REDUCTION("Line ", $fd.start->getLine(), ": unit : func_declaration\n");
+		LOG_RULE_TEXT($start);
 	}
     | fdef=func_definition
 	{
-		$unit_text = $fdef.fdef_text;
-		writeIntoparserLogFile("Line " + std::to_string($fdef.stop->getLine()) + ": unit : func_definition\n");
-		writeIntoparserLogFile($fdef.fdef_text + "\n");		
+		LOG_REDUCTION("Line ", $fdef.stop->getLine(), ": unit : func_definition\n");
+		LOG_RULE_TEXT($start);
 	}
     ;
      
-func_declaration returns [std::string fd_text]
-		: ts=type_specifier {is_func_declaration = true;} ID LPAREN pl=parameter_list RPAREN SEMICOLON
-		{
-			$fd_text = $ts.ctx->getText() + " " + $ID->getText() + "(" + $pl.pl_text + ");";
-			writeIntoparserLogFile("Line " + std::to_string($ts.start->getLine()) + ": func_declaration : type_specifier ID LPAREN parameter_list RPAREN SEMICOLON\n");
-			writeIntoparserLogFile($fd_text + "\n");
-
-			symbolTable.insert($ID->getText(), "func");
-			SymbolInfo *info = symbolTable.lookup($ID->getText());
-			info->setFuncReturnType($ts.text);
-			info->setFuncParams(parameter_list_ids);
-			parameter_list_ids.clear();
+func_declaration
+		: ts=type_specifier {compilation->is_func_declaration = true;} ID LPAREN pl=parameter_list RPAREN SEMICOLON
+		{
+			setSeparator($ID, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": func_declaration : type_specifier ID LPAREN parameter_list RPAREN SEMICOLON\n");
+			LOG_RULE_TEXT($start);
+
+			compilation->symbolTable.insert($ID->getText(), "func");
+			SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+			info->setFuncReturnType($ts.type);
+			info->setFuncParams(compilation->parameter_list_ids);
+			compilation->parameter_list_ids.clear();
 			info->setDeclarationStatus(true);
-			is_func_declaration = false;			
+			compilation->is_func_declaration = false;			
 		}
-		| ts=type_specifier {is_func_declaration = true;} ID LPAREN RPAREN SEMICOLON 
+		| ts=type_specifier {compilation->is_func_declaration = true;} ID LPAREN RPAREN SEMICOLON 
 		{
-			$fd_text = $ts.ctx->getText() + " " + $ID->getText() + "();";
-			writeIntoparserLogFile("Line " + std::to_string($ts.start->getLine()) + ": func_declaration : type_specifier ID LPAREN RPAREN SEMICOLON\n");
-			writeIntoparserLogFile($ts.ctx->getText() + " " + $ID->getText() + "();\n");
+			setSeparator($ID, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": func_declaration : type_specifier ID LPAREN RPAREN SEMICOLON\n");
+			LOG_RULE_TEXT($start);
 
-			symbolTable.insert($ID->getText(), "func");
-			SymbolInfo *info = symbolTable.lookup($ID->getText());
-			info->setFuncReturnType($ts.text);
+			compilation->symbolTable.insert($ID->getText(), "func");
+			SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+			info->setFuncReturnType($ts.type);
 			info->setDeclarationStatus(true);
-			is_func_declaration = false;
+			compilation->is_func_declaration = false;
 		}
 		;
 		 
-func_definition returns [std::string fdef_text]
-	: ts=type_specifier ID {function_def($ID->getText(), $ts.text); is_func_definition = true;} LPAREN pl=parameter_list {type_error_check($ID->getText(), $ts.text, std::to_string($ID->getLine()));} RPAREN {currentFunction = symbolTable.lookup($ID->getText());} cs=compound_statement
-	{
-		$fdef_text = $ts.text + " " + $ID->getText() + $LPAREN->getText() + $pl.pl_text + $RPAREN->getText() + $cs.cs_text;
-		writeIntoparserLogFile("Line " + std::to_string($cs.stop->getLine()) + ": func_definition : type_specifier ID LPAREN parameter_list RPAREN compound_statement\n");
-		writeIntoparserLogFile($fdef_text + "\n");
-		currentFunction = nullptr;
-		is_func_definition = false;
-	}
-	| ts=type_specifier ID {function_def($ID->getText(), $ts.text);} LPAREN RPAREN cs=compound_statement
-	{
-		$fdef_text = $ts.text + " " + $ID->getText() + $LPAREN->getText() + $RPAREN->getText() + $cs.cs_text;
-		writeIntoparserLogFile("Line " + std::to_string($cs.stop->getLine()) + ": func_definition : type_specifier ID LPAREN RPAREN compound_statement\n");
-		writeIntoparserLogFile($fdef_text + "\n");
-	}
-	| ts=type_specifier ID {function_def($ID->getText(), $ts.text);} LPAREN pl=parameter_list ADDOP RPAREN {
-				syntaxErrorCount++;
-		std::string errorMessage = "Error at line " + std::to_string($ADDOP->getLine()) + ": syntax error, unexpected ADDOP, expecting RPAREN or COMMA";
-		writeIntoparserLogFile(errorMessage + "\n");
-		writeIntoErrorFile(errorMessage + "\n");
+func_definition
+	: ts=type_specifier ID {function_def($ID->getText(), $ts.type); compilation->is_func_definition = true;} LPAREN pl=parameter_list {type_error_check($ID->getText(), $ts.type, std::to_string($ID->getLine()));} RPAREN {compilation->currentFunction = compilation->symbolTable.lookup($ID->getText());} cs=compound_statement
+	{
+		setSeparator($ID, ' ');
+		LOG_REDUCTION("Line ", $cs.stop->getLine(), ": func_definition : type_specifier ID LPAREN parameter_list RPAREN compound_statement\n");
+		LOG_RULE_TEXT($start);
+		compilation->currentFunction = nullptr;
+		compilation->is_func_definition = false;
+	}
+	| ts=type_specifier ID {function_def($ID->getText(), $ts.type);} LPAREN RPAREN cs=compound_statement
+	{
+		setSeparator($ID, ' ');
+		LOG_REDUCTION("Line ", $cs.stop->getLine(), ": func_definition : type_specifier ID LPAREN RPAREN compound_statement\n");
+		LOG_RULE_TEXT($start);
+	}
+	| ts=type_specifier ID {function_def($ID->getText(), $ts.type);} LPAREN pl=parameter_list ADDOP RPAREN {
+				compilation->syntaxErrorCount++;
+		LOG_ERROR("Error at line ", $ADDOP->getLine(), ": syntax error, unexpected ADDOP, expecting RPAREN or COMMA");
+		layoutOf($ADDOP->getTokenIndex()).hidden = true;
 	} cs=compound_statement
 	{
-		$fdef_text = $ts.text + " " + $ID->getText() + $LPAREN->getText() + $pl.pl_text + $RPAREN->getText() + $cs.cs_text;
+		setSeparator($ID, ' ');
 	}
 	;				
 
 
-parameter_list returns [std::string pl_text]
-		: pl=parameter_list COMMA ts=type_specifier ID
+parameter_list
+ 		: ( ts=type_specifier id=ID
+		{
+			setSeparator($id, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": parameter_list : type_specifier ID\n");
+			LOG_RULE_TEXT($start);
+			
+			if(!compilation->is_func_declaration || compilation->is_func_declaration)
+			{
+				// symbolTable.insert($id->getText(), $ts.text);
+				compilation->parameter_list_ids.push_back({$id->getText(), $ts.type});
+			}
+		}
+		| ts=type_specifier
+		{
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": parameter_list : type_specifier\n");
+			LOG_RULE_TEXT($start);			
+		}
+		)
+		( COMMA ts=type_specifier id=ID
 		{
 
-			if(!is_func_declaration || is_func_declaration)
+			if(!compilation->is_func_declaration || compilation->is_func_declaration)
 			{
-				// symbolTable.insert($ID->getText(), $ts.text);
+				// symbolTable.insert($id->getText(), $ts.text);
 				bool found = false;
-				for(int i = 0; i < parameter_list_ids.size(); i++)
-					if(parameter_list_ids[i].first == $ID->getText())
+				for(int i = 0; i < compilation->parameter_list_ids.size(); i++)
+					if(compilation->parameter_list_ids[i].first == $id->getText())
 						found = true;
 				if(found == false)
-					parameter_list_ids.push_back({$ID->getText(), $ts.text});
+					compilation->parameter_list_ids.push_back({$id->getText(), $ts.type});
 				else 
 				{
-					syntaxErrorCount++;
-					std::string errorMessage = "Error at line " + std::to_string($ts.start->getLine()) + ": Multiple declaration of " + $ID->getText() + " in parameter";
-					writeIntoparserLogFile(errorMessage + "\n");
-					writeIntoErrorFile(errorMessage + "\n");
+					compilation->syntaxErrorCount++;
+					LOG_ERROR("Error at line ", $ts.start->getLine(), ": Multiple declaration of ", $id->getText(), " in parameter");
 				}
 			}
 
-			$pl_text = $pl.pl_text + "," + $ts.text + " " + $ID->getText();
-			writeIntoparserLogFile("Line " + std::to_string($ts.start->getLine()) + ": parameter_list : parameter_list COMMA type_specifier ID\n");
-			writeIntoparserLogFile($pl_text + "\n");
+			setSeparator($id, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": parameter_list : parameter_list COMMA type_specifier ID\n");
+			LOG_RULE_TEXT($start);
 		}
-		| parameter_list COMMA type_specifier
- 		| ts=type_specifier ID
-		{
-			$pl_text = $ts.text + " " + $ID->getText();
-			writeIntoparserLogFile("Line " + std::to_string($ts.start->getLine()) + ": parameter_list : type_specifier ID\n");
-			writeIntoparserLogFile($ts.text + " " + $ID->getText() + "\n");
-			
-			if(!is_func_declaration || is_func_declaration)
-			{
-				// symbolTable.insert($ID->getText(), $ts.text);
-				parameter_list_ids.push_back({$ID->getText(), $ts.text});
-			}
-		}
-		| ts=type_specifier
+		| COMMA type_specifier
 		{
-			$pl_text = $ts.text;
-			writeIntoparserLogFile("Line " + std::to_string($ts.start->getLine()) + ": parameter_list : type_specifier\n");
-			writeIntoparserLogFile($ts.text + "\n");			
+			hideTokens($start);
 		}
+		)*
  		;
 
  		
-compound_statement returns [std::string cs_text]
-		: LCURL {symbolTable.enterScope();
-			if(parameter_list_ids.size() > 0) 
+compound_statement
+		: LCURL {compilation->symbolTable.enterScope();
+			if(compilation->parameter_list_ids.size() > 0) 
 			{
-				for(int i = 0; i < parameter_list_ids.size(); i++)
-					symbolTable.insert(parameter_list_ids[i].first, parameter_list_ids[i].second);
+				for(int i = 0; i < compilation->parameter_list_ids.size(); i++)
+					compilation->symbolTable.insert(compilation->parameter_list_ids[i].first, typeTable.name(compilation->parameter_list_ids[i].second));
 				
-				parameter_list_ids.clear();
+				compilation->parameter_list_ids.clear();
 			}
 		} ss=statements RCURL
 		{
-			$cs_text = $LCURL->getText() + "\n" + $ss.statements_text + "\n" + $RCURL->getText();
-			writeIntoparserLogFile("Line " + std::to_string($RCURL->getLine()) + ": compound_statement : LCURL statements RCURL\n");
-			writeIntoparserLogFile($cs_text + "\n");
+			setSeparator($ss.start, '\n');
+			setSeparator($RCURL, '\n');
+			LOG_REDUCTION("Line ", $RCURL->getLine(), ": compound_statement : LCURL statements RCURL\n");
+			LOG_RULE_TEXT($start);
 
-			writeIntoparserLogFile(symbolTable.getSymbolTableAsString());
-			symbolTable.exitScope();
+			LOG_IF(LOG_SYMBOL_TABLE) writeIntoparserLogFile(compilation->symbolTable.getSymbolTableAsString());
+			compilation->symbolTable.exitScope();
 		}
-		| LCURL {symbolTable.enterScope();
-			if(parameter_list_ids.size() > 0) 
+		| LCURL {compilation->symbolTable.enterScope();
+			if(compilation->parameter_list_ids.size() > 0) 
 			{
-				for(int i = 0; i < parameter_list_ids.size(); i++)
-					symbolTable.insert(parameter_list_ids[i].first, parameter_list_ids[i].second);
+				for(int i = 0; i < compilation->parameter_list_ids.size(); i++)
+					compilation->symbolTable.insert(compilation->parameter_list_ids[i].first, typeTable.name(compilation->parameter_list_ids[i].second));
 				
-				parameter_list_ids.clear();
+				compilation->parameter_list_ids.clear();
 			}
 		}  RCURL
 		{
-			$cs_text = $LCURL->getText() + $RCURL->getText();
-			writeIntoparserLogFile("Line " + std::to_string($RCURL->getLine()) + ": compound_statement : LCURL RCURL\n");
-			writeIntoparserLogFile($cs_text + "\n");
+			LOG_REDUCTION("Line ", $RCURL->getLine(), ": compound_statement : LCURL RCURL\n");
+			LOG_RULE_TEXT($start);
 
-			writeIntoparserLogFile(symbolTable.getSymbolTableAsString());
-			symbolTable.exitScope();
+			LOG_IF(LOG_SYMBOL_TABLE) writeIntoparserLogFile(compilation->symbolTable.getSymbolTableAsString());
+			compilation->symbolTable.exitScope();
 		}
 		;
  		    
-var_declaration returns [std::string vd_text]
+var_declaration
     : t=type_specifier dl=declaration_list sm=SEMICOLON {
-		$vd_text = $t.text + " " + $dl.dl_text + $sm->getText();
-		writeIntoparserLogFile(
-			"Line " + std::to_string($sm->getLine()) + ": var_declaration : type_specifier declaration_list SEMICOLON\n"
-		);
-		if($t.text == "void")
+		setSeparator($dl.start, ' ');
+		LOG_REDUCTION("Line ", $sm->getLine(), ": var_declaration : type_specifier declaration_list SEMICOLON\n");
+		if($t.type == TYPE_VOID)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($sm->getLine()) + ": Variable type cannot be " + $t.text;
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $sm->getLine(), ": Variable type cannot be ", $t.text);
 		}
 
-		for(int i=0; i<declaration_list_ids.size();i++)
-			symbolTable.insert(declaration_list_ids[i], $t.text);
-		declaration_list_ids.clear();
+		for(int i=0; i<compilation->declaration_list_ids.size();i++)
+			if(compilation->symbolTable.insert(compilation->declaration_list_ids[i].first, $t.text))
+				compilation->symbolTable.lookupAtCurrentScope(compilation->declaration_list_ids[i].first)->setKind(compilation->declaration_list_ids[i].second);
+		compilation->declaration_list_ids.clear();
 
-		writeIntoparserLogFile(
-			$t.text + " " + $dl.dl_text + $sm->getText() + "\n"
-		);
+		LOG_RULE_TEXT($start);
 	}
     | t=type_specifier de=declaration_list_err sm=SEMICOLON
+	{
+		hideTokens($start);
+	}
     ;
 
 declaration_list_err returns [std::string error_name]: {
@@ -346,532 +378,455 @@ declaration_list_err returns [std::string error_name]: {
     };
 
  		 
-type_specifier returns [std::string name_line]	
+type_specifier returns [std::string name_line, TypeId type]	
         : INT {
             $name_line = "type: INT at line" + std::to_string($INT->getLine());
-			writeIntoparserLogFile(
-				std::string("Line " + std::to_string($INT->getLine()) + ": type_specifier : INT\n")
-			);
-			writeIntoparserLogFile(
-				$INT->getText() + "\n"
-			);
+            $type = TYPE_INT;
+			LOG_REDUCTION("Line ", $INT->getLine(), ": type_specifier : INT\n");
+			LOG_REDUCTION($INT->getText(), "\n");
         }
  		| FLOAT {
             $name_line = "type: FLOAT at line" + std::to_string($FLOAT->getLine());
-			writeIntoparserLogFile(
-				std::string("Line " + std::to_string($FLOAT->getLine()) + ": type_specifier : FLOAT\n")
-			);
-			writeIntoparserLogFile(
-				$FLOAT->getText() + "\n"
-			);
+            $type = TYPE_FLOAT;
+			LOG_REDUCTION("Line ", $FLOAT->getLine(), ": type_specifier : FLOAT\n");
+			LOG_REDUCTION($FLOAT->getText(), "\n");
         }
  		| VOID {
             $name_line = "type: VOID at line" + std::to_string($VOID->getLine());
-			writeIntoparserLogFile(
-				std::string("Line " + std::to_string($VOID->getLine()) + ": type_specifier : VOID\n")
-			);
-			writeIntoparserLogFile(
-				$VOID->getText() + "\n"
-			);
+            $type = TYPE_VOID;
+			LOG_REDUCTION("Line ", $VOID->getLine(), ": type_specifier : VOID\n");
+			LOG_REDUCTION($VOID->getText(), "\n");
         }
  		;
  		
-declaration_list returns [std::string dl_text]
-		: dl=declaration_list COMMA ID 
-		{
-			$dl_text = $dl.dl_text + $COMMA->getText() + $ID->getText();
-			writeIntoparserLogFile("Line " + std::to_string($ID->getLine()) + ": declaration_list : declaration_list COMMA ID\n");
-			writeIntoparserLogFile($dl_text + "\n");
-
-			//symbolTable.insert($ID->getText(), "ID");
-			declaration_list_ids.push_back($ID->getText());
-			variableTypes[$ID->getText()] = "variable";
-		}
- 		| dl=declaration_list COMMA ID LTHIRD CONST_INT RTHIRD
+declaration_list
+ 		: ( id=ID 
 		{
-			$dl_text = $dl.dl_text + "," + $ID->getText() + $LTHIRD->getText() + $CONST_INT->getText() + $RTHIRD->getText();
-
-			// symbolTable.insert($ID->getText(), "ID");
-			SymbolInfo *info = symbolTable.lookupAtCurrentScope($ID->getText());
-			if(info == nullptr)
+			// bool inserted = symbolTable.insert($id->getText(), "ID");
+			SymbolInfo *info = compilation->symbolTable.lookupAtCurrentScope($id->getText());
+			if(info != nullptr) 
 			{
-				declaration_list_ids.push_back($ID->getText());
-				variableTypes[$ID->getText()] = "array";
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $id->getLine(), ": Multiple declaration of ", $id->getText());
 			}
 			else 
 			{
-				syntaxErrorCount++;
-				std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": Multiple declaration of " + $ID->getText();
-				writeIntoparserLogFile(errorMessage + "\n");
-				writeIntoErrorFile(errorMessage + "\n");
+				compilation->declaration_list_ids.push_back({$id->getText(), KIND_VARIABLE});
 			}
-			writeIntoparserLogFile("Line " + std::to_string($ID->getLine()) + ": declaration_list : declaration_list COMMA ID LTHIRD CONST_INT RTHIRD\n");
-			writeIntoparserLogFile($dl_text + "\n");			
+			LOG_REDUCTION("Line ", $id->getLine(), ": declaration_list : ID\n");
+			LOG_RULE_TEXT($start);
+			
 		}
- 		| ID 
+ 		| id=ID LTHIRD CONST_INT RTHIRD
 		{
-			// bool inserted = symbolTable.insert($ID->getText(), "ID");
-			SymbolInfo *info = symbolTable.lookupAtCurrentScope($ID->getText());
-			if(info != nullptr) 
+			LOG_REDUCTION("Line ", $id->getLine(), ": declaration_list : ID LTHIRD CONST_INT RTHIRD\n");
+			LOG_RULE_TEXT($start);
+
+			// symbolTable.insert($id->getText(), "ID");
+			compilation->declaration_list_ids.push_back({$id->getText(), KIND_ARRAY});
+		}
+		)
+		( COMMA id=ID 
+		{
+			LOG_REDUCTION("Line ", $id->getLine(), ": declaration_list : declaration_list COMMA ID\n");
+			LOG_RULE_TEXT($start);
+
+			//symbolTable.insert($id->getText(), "ID");
+			compilation->declaration_list_ids.push_back({$id->getText(), KIND_VARIABLE});
+		}
+ 		| COMMA id=ID LTHIRD CONST_INT RTHIRD
+		{
+			// symbolTable.insert($id->getText(), "ID");
+			SymbolInfo *info = compilation->symbolTable.lookupAtCurrentScope($id->getText());
+			if(info == nullptr)
 			{
-				syntaxErrorCount++;
-				std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": Multiple declaration of " + $ID->getText();
-				writeIntoparserLogFile(errorMessage + "\n");
-				writeIntoErrorFile(errorMessage + "\n");
+				compilation->declaration_list_ids.push_back({$id->getText(), KIND_ARRAY});
 			}
 			else 
 			{
-				declaration_list_ids.push_back($ID->getText());
-				variableTypes[$ID->getText()] = "variable";
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $id->getLine(), ": Multiple declaration of ", $id->getText());
 			}
-			$dl_text = $ID->getText();
-			writeIntoparserLogFile("Line " + std::to_string($ID->getLine()) + ": declaration_list : ID\n");
-			writeIntoparserLogFile($dl_text + "\n");
-			
-		}
- 		| ID LTHIRD CONST_INT RTHIRD
-		{
-			$dl_text = $ID->getText() + $LTHIRD->getText() + $CONST_INT->getText() + $RTHIRD->getText();
-			writeIntoparserLogFile("Line " + std::to_string($ID->getLine()) + ": declaration_list : ID LTHIRD CONST_INT RTHIRD\n");
-			writeIntoparserLogFile($dl_text + "\n");
-
-			// symbolTable.insert($ID->getText(), "ID");
-			declaration_list_ids.push_back($ID->getText());
-			variableTypes[$ID->getText()] = "array";
+			LOG_REDUCTION("Line ", $id->getLine(), ": declaration_list : declaration_list COMMA ID LTHIRD CONST_INT RTHIRD\n");
+			LOG_RULE_TEXT($start);			
 		}
-		| dl=declaration_list ADDOP ID
+		| op=ADDOP id=ID
 		{
-			$dl_text = $dl.dl_text;
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": syntax error, unexpected ADDOP, expecting COMMA or SEMICOLON";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			layoutOf($op->getTokenIndex()).hidden = true;
+			layoutOf($id->getTokenIndex()).hidden = true;
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $id->getLine(), ": syntax error, unexpected ADDOP, expecting COMMA or SEMICOLON");
 
 		}
+		)*
  		;
  		  
-statements returns [std::string statements_text]
+statements
 	: s=statement
 	{
-		$statements_text = $s.statement_text;
-		writeIntoparserLogFile("Line " + std::to_string($s.start->getLine()) + ": statements : statement\n");
-		writeIntoparserLogFile($statements_text + "\n");
+		LOG_REDUCTION("Line ", $s.start->getLine(), ": statements : statement\n");
+		LOG_RULE_TEXT($start);
 	}
-	| ss=statements s=statement
+	( s=statement
 	{
-		$statements_text = $ss.statements_text + "\n" + $s.statement_text;
-		writeIntoparserLogFile("Line " + std::to_string($s.stop->getLine()) + ": statements : statements statement\n");
-		writeIntoparserLogFile($statements_text + "\n");
+		setSeparator($s.start, '\n');
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statements : statements statement\n");
+		LOG_RULE_TEXT($start);
 	}
+	)*
 	;
 	   
-statement returns [std::string statement_text]
+statement
 	: vd=var_declaration
 	{
-		$statement_text = $vd.vd_text;
-		writeIntoparserLogFile("Line " + std::to_string($vd.start->getLine()) + ": statement : var_declaration\n");
-		writeIntoparserLogFile($statement_text + "\n");				
+		LOG_REDUCTION("Line ", $vd.start->getLine(), ": statement : var_declaration\n");
+		LOG_RULE_TEXT($start);				
 	}
 	| es=expression_statement 
 	{
-		if(currentFunction != nullptr) currentFunction = nullptr;
-		$statement_text = $es.expression_statement_text;
-		writeIntoparserLogFile("Line " + std::to_string($es.start->getLine()) + ": statement : expression_statement\n");
-		writeIntoparserLogFile($statement_text + "\n");				
+		if(compilation->currentFunction != nullptr) compilation->currentFunction = nullptr;
+		LOG_REDUCTION("Line ", $es.start->getLine(), ": statement : expression_statement\n");
+		LOG_RULE_TEXT($start);				
 	}
 	| cs=compound_statement
 	{
-		$statement_text = $cs.cs_text;
-		writeIntoparserLogFile("Line " + std::to_string($cs.stop->getLine()) + ": statement : compound_statement\n");
-		writeIntoparserLogFile($statement_text + "\n");
+		LOG_REDUCTION("Line ", $cs.stop->getLine(), ": statement : compound_statement\n");
+		LOG_RULE_TEXT($start);
 	}
 	| FOR LPAREN es1=expression_statement es2=expression_statement e=expression RPAREN s=statement
 	{
-		$statement_text = $FOR->getText() + $LPAREN->getText() + $es1.expression_statement_text + $es2.expression_statement_text + $e.expression_text + $RPAREN->getText() + $s.statement_text;
-		writeIntoparserLogFile("Line " + std::to_string($s.stop->getLine()) + ": statement : FOR LPAREN expression_statement expression_statement expression RPAREN statement\n");
-		writeIntoparserLogFile($statement_text + "\n");
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statement : FOR LPAREN expression_statement expression_statement expression RPAREN statement\n");
+		LOG_RULE_TEXT($start);
 	}
 	| IF LPAREN e=expression RPAREN s=statement
 	{
-		$statement_text = $IF->getText() + $LPAREN->getText() + $e.expression_text + $RPAREN->getText() + $s.statement_text;
-		writeIntoparserLogFile("Line " + std::to_string($s.stop->getLine()) + ": statement : IF LPAREN expression RPAREN statement\n");
-		writeIntoparserLogFile($statement_text + "\n");		
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statement : IF LPAREN expression RPAREN statement\n");
+		LOG_RULE_TEXT($start);		
 	}
 	| IF LPAREN e=expression RPAREN s1=statement ELSE s2=statement
 	{
-		$statement_text = $IF->getText() + $LPAREN->getText() + $e.expression_text + $RPAREN->getText() + $s1.statement_text + $ELSE->getText() + " " + $s2.statement_text;
-		writeIntoparserLogFile("Line " + std::to_string($s2.stop->getLine()) + ": statement : IF LPAREN expression RPAREN statement ELSE statement\n");
-		writeIntoparserLogFile($statement_text + "\n");	
+		setSeparator($s2.start, ' ');
+		LOG_REDUCTION("Line ", $s2.stop->getLine(), ": statement : IF LPAREN expression RPAREN statement ELSE statement\n");
+		LOG_RULE_TEXT($start);	
 	}
 	| WHILE LPAREN e=expression RPAREN s=statement
 	{
-		$statement_text = $WHILE->getText() + $LPAREN->getText() + $e.expression_text + $RPAREN->getText() + $s.statement_text;
-		writeIntoparserLogFile("Line " + std::to_string($s.stop->getLine()) + ": statement : WHILE LPAREN expression RPAREN statement\n");
-		writeIntoparserLogFile($statement_text + "\n");
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statement : WHILE LPAREN expression RPAREN statement\n");
+		LOG_RULE_TEXT($start);
 	}
 	| PRINTLN LPAREN ID RPAREN SEMICOLON
 	{
-		writeIntoparserLogFile("Line " + std::to_string($SEMICOLON->getLine()) + ": statement : PRINTLN LPAREN ID RPAREN SEMICOLON\n");
-		SymbolInfo *info = symbolTable.lookup($ID->getText());
+		LOG_REDUCTION("Line ", $SEMICOLON->getLine(), ": statement : PRINTLN LPAREN ID RPAREN SEMICOLON\n");
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
 		if(info == nullptr)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": Undeclared variable " + $ID->getText();
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Undeclared variable ", $ID->getText());
 		}
-		$statement_text = $PRINTLN->getText() + $LPAREN->getText() + $ID->getText() + $RPAREN->getText() + ";";
-		writeIntoparserLogFile($statement_text + "\n");		
+		LOG_RULE_TEXT($start);		
 	}
 	| RETURN e=expression SEMICOLON
 	{
-		$statement_text = "return " + $e.expression_text + ";";
-		writeIntoparserLogFile("Line " + std::to_string($RETURN->getLine()) + ": statement : RETURN expression SEMICOLON\n");
-		writeIntoparserLogFile($statement_text + "\n");
+		setSeparator($e.start, ' ');
+		LOG_REDUCTION("Line ", $RETURN->getLine(), ": statement : RETURN expression SEMICOLON\n");
+		LOG_RULE_TEXT($start);
 
-		if(currentFunction != nullptr && currentFunction->getFuncReturnType() == "void")
+		if(compilation->currentFunction != nullptr && compilation->currentFunction->getFuncReturnType() == TYPE_VOID)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($RETURN->getLine()) + ": Cannot return value from function " + currentFunction->getName() + " with void return type";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $RETURN->getLine(), ": Cannot return value from function ", compilation->currentFunction->getName(), " with void return type");
 		}
 	}
 	;
 	  
-expression_statement returns [std::string expression_statement_text]
+expression_statement
 			: SEMICOLON	
 			{
-				$expression_statement_text = ";";
-				writeIntoparserLogFile("Line " + std::to_string($SEMICOLON->getLine()) + ": expression_statement : SEMICOLON\n");
-				writeIntoparserLogFile($expression_statement_text + "\n");
+				LOG_REDUCTION("Line ", $SEMICOLON->getLine(), ": expression_statement : SEMICOLON\n");
+				LOG_RULE_TEXT($start);
 			}		
 			| e=expression SEMICOLON
 			{
-				$expression_statement_text = $e.expression_text + ";";
-				writeIntoparserLogFile("Line " + std::to_string($e.start->getLine()) + ": expression_statement : expression SEMICOLON\n");
-				writeIntoparserLogFile($expression_statement_text + "\n");				
+				LOG_REDUCTION("Line ", $e.start->getLine(), ": expression_statement : expression SEMICOLON\n");
+				LOG_RULE_TEXT($start);				
 			} 
 			;
 	  
-variable returns [std::string variable_text]
+variable
 	: ID 
 	{
-		$variable_text = $ID->getText();
-		writeIntoparserLogFile("Line " + std::to_string($ID->getLine()) + ": variable : ID\n");
+		LOG_REDUCTION("Line ", $ID->getLine(), ": variable : ID\n");
 
-		SymbolInfo *info = symbolTable.lookup($ID->getText());
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
 		if(info == nullptr) 
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": Undeclared variable " + $ID->getText();
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Undeclared variable ", $ID->getText());
 		}
 		else 
 		{
-			var_type = info->getType();
+			compilation->var_type = info->getTypeId();
 			// std::cout << $ID->getText() << " " << var_type << std::endl;
-			// std::cout << $ID->getText() << " " << variableTypes[$ID->getText()] << "\n";
-			if(variableTypes[$ID->getText()] == "array") argument_list_types.push_back("array");
-			else argument_list_types.push_back(info->getType());
+			if(info->isArray()) compilation->argument_list_types.push_back(TYPE_ARRAY);
+			else compilation->argument_list_types.push_back(info->getTypeId());
 		}
-		writeIntoparserLogFile($variable_text + "\n");
+		LOG_RULE_TEXT($start);
 	}		
 	| ID LTHIRD e=expression RTHIRD 
 	{
-		$variable_text = $ID->getText() + $LTHIRD->getText() + $e.expression_text + $RTHIRD->getText();
-		writeIntoparserLogFile("Line " + std::to_string($ID->getLine()) + ": variable : ID LTHIRD expression RTHIRD\n");
-		if(current_const_type != "INT") 
+		LOG_REDUCTION("Line ", $ID->getLine(), ": variable : ID LTHIRD expression RTHIRD\n");
+		if(compilation->current_const_type != TYPE_INT) 
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": Expression inside third brackets not an integer";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Expression inside third brackets not an integer");
 		}
-		if(variableTypes.find($ID->getText()) != variableTypes.end() && variableTypes[$ID->getText()] != "array")
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+		if(info != nullptr && info->getKind() == KIND_VARIABLE)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": " + $ID->getText() + " not an array";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": ", $ID->getText(), " not an array");
 		}
-		SymbolInfo *info = symbolTable.lookup($ID->getText());
-		if(info) var_type = info->getType();
-		writeIntoparserLogFile($variable_text + "\n");
+		if(info) compilation->var_type = info->getTypeId();
+		LOG_RULE_TEXT($start);
 	}
 	;
 	 
- expression returns [std::string expression_text]
+ expression
  	: le=logic_expression
 	{
-		$expression_text = $le.logic_expression_text;
-		writeIntoparserLogFile("Line " + std::to_string($le.start->getLine()) + ": expression : logic_expression\n");
-		writeIntoparserLogFile($expression_text + "\n");
+		LOG_REDUCTION("Line ", $le.start->getLine(), ": expression : logic_expression\n");
+		LOG_RULE_TEXT($start);
 	}	
 	|  v=variable ASSIGNOP le=logic_expression 
 	{
-		$expression_text = $v.variable_text + $ASSIGNOP->getText() + $le.logic_expression_text;
-		writeIntoparserLogFile("Line " + std::to_string($v.start->getLine()) + ": expression : variable ASSIGNOP logic_expression\n");
+		LOG_REDUCTION("Line ", $v.start->getLine(), ": expression : variable ASSIGNOP logic_expression\n");
 
-		if(variableTypes.find($v.variable_text) != variableTypes.end() && variableTypes[$v.variable_text] == "array") {
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($v.start->getLine()) + ": Type mismatch, " + $v.variable_text + " is an array";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+		std::string variable_text = getRuleText($v.ctx);
+		SymbolInfo *variable_info = compilation->symbolTable.lookup(variable_text);
+		if(variable_info != nullptr && variable_info->isArray()) {
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $v.start->getLine(), ": Type mismatch, ", variable_text, " is an array");
 		}
 
-		if(var_type == "int" && assign_type == "float")
+		if(compilation->var_type == TYPE_INT && compilation->assign_type == TYPE_FLOAT)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($v.start->getLine()) + ": Type Mismatch";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $v.start->getLine(), ": Type Mismatch");
 		}
-		var_type = "";
+		compilation->var_type = TYPE_NONE;
 
-		if(currentFunction != nullptr && is_func_definition == false)
+		if(compilation->currentFunction != nullptr && compilation->is_func_definition == false)
 		{
-			if(currentFunction->getType() == "func" && currentFunction->getFuncReturnType() == "void")
+			if(compilation->currentFunction->isFunction() && compilation->currentFunction->getFuncReturnType() == TYPE_VOID)
 			{
-				syntaxErrorCount++;
-				std::string errorMessage = "Error at line " + std::to_string($v.start->getLine()) + ": Void function used in expression";
-				writeIntoparserLogFile(errorMessage + "\n");
-				writeIntoErrorFile(errorMessage + "\n");
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $v.start->getLine(), ": Void function used in expression");
 			}
-			currentFunction = nullptr;
+			compilation->currentFunction = nullptr;
 		}
 
-		writeIntoparserLogFile($expression_text + "\n");
+		LOG_RULE_TEXT($start);
 	}
 	| UNRECOGNIZED
 	{
-		syntaxErrorCount++;
-		std::string errorMessage = "Error at line " + std::to_string($UNRECOGNIZED->getLine()) + ": Unrecognized character " + $UNRECOGNIZED->getText();
-		writeIntoparserLogFile(errorMessage + "\n");
-		writeIntoErrorFile(errorMessage + "\n");
+		layoutOf($UNRECOGNIZED->getTokenIndex()).hidden = true;
+		compilation->syntaxErrorCount++;
+		LOG_ERROR("Error at line ", $UNRECOGNIZED->getLine(), ": Unrecognized character ", $UNRECOGNIZED->getText());
 	}
 	;
 			
-logic_expression returns [std::string logic_expression_text]
+logic_expression
 		: re=rel_expression 
 		{
-			$logic_expression_text = $re.rel_expression_text;
-			writeIntoparserLogFile("Line " + std::to_string($re.start->getLine()) + ": logic_expression : rel_expression\n");
-			writeIntoparserLogFile($logic_expression_text + "\n");
+			LOG_REDUCTION("Line ", $re.start->getLine(), ": logic_expression : rel_expression\n");
+			LOG_RULE_TEXT($start);
 		}
 		| re1=rel_expression LOGICOP re2=rel_expression 
 		{
-			$logic_expression_text = $re1.rel_expression_text + $LOGICOP->getText() + $re2.rel_expression_text;
-			writeIntoparserLogFile("Line " + std::to_string($re1.start->getLine()) + ": logic_expression : rel_expression LOGICOP rel_expression\n");
-			writeIntoparserLogFile($logic_expression_text + "\n");
+			LOG_REDUCTION("Line ", $re1.start->getLine(), ": logic_expression : rel_expression LOGICOP rel_expression\n");
+			LOG_RULE_TEXT($start);
 		}	
 		;
 			
-rel_expression	returns [std::string rel_expression_text]
+rel_expression
 		: se=simple_expression 
 		{
-			$rel_expression_text = $se.simple_expression_text;
-			writeIntoparserLogFile("Line " + std::to_string($se.start->getLine()) + ": rel_expression : simple_expression\n");
-			writeIntoparserLogFile($rel_expression_text + "\n");
+			LOG_REDUCTION("Line ", $se.start->getLine(), ": rel_expression : simple_expression\n");
+			LOG_RULE_TEXT($start);
 		}
 		| se1=simple_expression RELOP se2=simple_expression
 		{
-			$rel_expression_text = $se1.simple_expression_text + $RELOP->getText() + $se2.simple_expression_text;
-			writeIntoparserLogFile("Line " + std::to_string($se1.start->getLine()) + ": rel_expression : simple_expression RELOP simple_expression\n");
-			writeIntoparserLogFile($rel_expression_text + "\n");
+			LOG_REDUCTION("Line ", $se1.start->getLine(), ": rel_expression : simple_expression RELOP simple_expression\n");
+			LOG_RULE_TEXT($start);
 		}
 		;
 				
-simple_expression returns [std::string simple_expression_text]
+simple_expression
 		: t=term 
 		{
-			$simple_expression_text = $t.term_text;
-			writeIntoparserLogFile("Line " + std::to_string($t.start->getLine()) + ": simple_expression : term\n");
-			writeIntoparserLogFile($simple_expression_text + "\n");
+			LOG_REDUCTION("Line ", $t.start->getLine(), ": simple_expression : term\n");
+			LOG_RULE_TEXT($start);
 		}
-		| se=simple_expression ADDOP t=term 
+		( ADDOP t=term 
 		{
-			$simple_expression_text = $se.simple_expression_text + $ADDOP->getText() + $t.term_text;
-			writeIntoparserLogFile("Line " + std::to_string($se.start->getLine()) + ": simple_expression : simple_expression ADDOP term\n");
-			writeIntoparserLogFile($simple_expression_text + "\n");
+			LOG_REDUCTION("Line ", $start->getLine(), ": simple_expression : simple_expression ADDOP term\n");
+			LOG_RULE_TEXT($start);
 		}
-		| se=simple_expression ADDOP ASSIGNOP t=term
+		| ADDOP ASSIGNOP t=term
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($se.start->getLine()) + ": syntax error, unexpected ASSIGNOP";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			hideTokens($start);
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $start->getLine(), ": syntax error, unexpected ASSIGNOP");
 		}
+		)*
 		;
 					
-term returns [std::string term_text]
+term
 	:	ue=unary_expression
 	{
-		$term_text = $ue.unary_expression_text;
-		writeIntoparserLogFile("Line " + std::to_string($ue.start->getLine()) + ": term : unary_expression\n");
-		writeIntoparserLogFile($term_text + "\n");
+		LOG_REDUCTION("Line ", $ue.start->getLine(), ": term : unary_expression\n");
+		LOG_RULE_TEXT($start);
 
-		term_operand_type = unary_e_operand_type;
+		compilation->term_operand_type = compilation->unary_e_operand_type;
 	}
-    |  t=term MULOP ue=unary_expression
+    ( mul=MULOP ue=unary_expression
 	{
-		$term_text = $t.term_text + $MULOP->getText() + $ue.unary_expression_text;
-		writeIntoparserLogFile("Line " + std::to_string($t.start->getLine()) + ": term : term MULOP unary_expression\n");
+		LOG_REDUCTION("Line ", $start->getLine(), ": term : term MULOP unary_expression\n");
 
-		if($MULOP->getText() == "%")
+		if($mul->getText() == "%")
 		{
-			if(term_operand_type != "int" || unary_e_operand_type != "int")
+			if(compilation->term_operand_type != TYPE_INT || compilation->unary_e_operand_type != TYPE_INT)
 			{
-				syntaxErrorCount++;
-				std::string errorMessage = "Error at line " + std::to_string($t.start->getLine()) + ": Non-Integer operand on modulus operator";
-				writeIntoparserLogFile(errorMessage + "\n");
-				writeIntoErrorFile(errorMessage + "\n");
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $start->getLine(), ": Non-Integer operand on modulus operator");
 			}
 
-			if($ue.unary_expression_text == "0")
+			if($ue.start == $ue.stop && $ue.start->getText() == "0")
 			{
-				syntaxErrorCount++;
-				std::string errorMessage = "Error at line " + std::to_string($t.start->getLine()) + ": Modulus by Zero";
-				writeIntoparserLogFile(errorMessage + "\n");
-				writeIntoErrorFile(errorMessage + "\n");				
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $start->getLine(), ": Modulus by Zero");
 			}
 		}
 
-		assign_type = "";
+		compilation->assign_type = TYPE_NONE;
 
-		if(currentFunction != nullptr)
+		if(compilation->currentFunction != nullptr)
 		{
-			if(currentFunction->getType() == "func" && currentFunction->getFuncReturnType() == "void")
+			if(compilation->currentFunction->isFunction() && compilation->currentFunction->getFuncReturnType() == TYPE_VOID)
 			{
-				syntaxErrorCount++;
-				std::string errorMessage = "Error at line " + std::to_string($t.start->getLine()) + ": Void function used in expression";
-				writeIntoparserLogFile(errorMessage + "\n");
-				writeIntoErrorFile(errorMessage + "\n");
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $start->getLine(), ": Void function used in expression");
 			}
-			currentFunction = nullptr;
+			compilation->currentFunction = nullptr;
 		}
-		if(argument_list_types.size() > 0) argument_list_types.pop_back();
-		writeIntoparserLogFile($term_text + "\n");
+		if(compilation->argument_list_types.size() > 0) compilation->argument_list_types.pop_back();
+		LOG_RULE_TEXT($start);
 	}
+    )*
     ;
 
-unary_expression returns [std::string unary_expression_text]
+unary_expression
 		: ADDOP ue=unary_expression  
 		{
-			$unary_expression_text = $ADDOP->getText() + $ue.unary_expression_text;
-			writeIntoparserLogFile("Line " + std::to_string($ue.stop->getLine()) + ": unary_expression : ADDOP unary_expression\n");
-			writeIntoparserLogFile($unary_expression_text + "\n");			
+			LOG_REDUCTION("Line ", $ue.stop->getLine(), ": unary_expression : ADDOP unary_expression\n");
+			LOG_RULE_TEXT($start);			
 		}
 		| NOT ue=unary_expression 
 		{
-			$unary_expression_text = $NOT->getText() + $ue.unary_expression_text;
-			writeIntoparserLogFile("Line " + std::to_string($ue.stop->getLine()) + ": unary_expression : NOT unary_expression\n");
-			writeIntoparserLogFile($unary_expression_text + "\n");			
+			LOG_REDUCTION("Line ", $ue.stop->getLine(), ": unary_expression : NOT unary_expression\n");
+			LOG_RULE_TEXT($start);			
 		}
 		| f=factor 
 		{
-			$unary_expression_text = $f.factor_text;
-			writeIntoparserLogFile("Line " + std::to_string($f.start->getLine()) + ": unary_expression : factor\n");
-			writeIntoparserLogFile($unary_expression_text + "\n");
+			LOG_REDUCTION("Line ", $f.start->getLine(), ": unary_expression : factor\n");
+			LOG_RULE_TEXT($start);
 
-			unary_e_operand_type = assign_type;
+			compilation->unary_e_operand_type = compilation->assign_type;
 		}
 		;
 	
-factor returns [std::string factor_text]
+factor
 	: v=variable 
 	{
-		$factor_text = $v.variable_text;
-		writeIntoparserLogFile("Line " + std::to_string($v.start->getLine()) + ": factor : variable\n");
-		writeIntoparserLogFile($factor_text + "\n");
+		LOG_REDUCTION("Line ", $v.start->getLine(), ": factor : variable\n");
+		LOG_RULE_TEXT($start);
 	}
-	| ID LPAREN {argument_list_types.clear();} al=argument_list RPAREN
+	| ID LPAREN {compilation->argument_list_types.clear();} al=argument_list RPAREN
 	{
-		writeIntoparserLogFile("Line " + std::to_string($ID->getLine()) + ": factor : ID LPAREN argument_list RPAREN\n");
-		SymbolInfo *info = symbolTable.lookup($ID->getText());
+		LOG_REDUCTION("Line ", $ID->getLine(), ": factor : ID LPAREN argument_list RPAREN\n");
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
 		if(info == nullptr)
 		{
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($ID->getLine()) + ": Undefined function " + $ID->getText();
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Undefined function ", $ID->getText());
 		}
-		$factor_text = $ID->getText() + $LPAREN->getText() + $al.arglist_text + $RPAREN->getText();
 		check_argument($ID->getText(), std::to_string($ID->getLine()));
-		writeIntoparserLogFile($factor_text + "\n");
-		argument_list_types.clear();	
-		assign_type = "";
-		currentFunction = info;	
+		LOG_RULE_TEXT($start);
+		compilation->argument_list_types.clear();	
+		compilation->assign_type = TYPE_NONE;
+		compilation->currentFunction = info;	
 	}
 	| LPAREN e=expression RPAREN
 	{
-		$factor_text = $LPAREN->getText() + $e.expression_text + $RPAREN->getText();
-		writeIntoparserLogFile("Line " + std::to_string($LPAREN->getLine()) + ": factor : LPAREN expression RPAREN\n");
-		writeIntoparserLogFile($factor_text + "\n");		
+		LOG_REDUCTION("Line ", $LPAREN->getLine(), ": factor : LPAREN expression RPAREN\n");
+		LOG_RULE_TEXT($start);		
 	}
 	| CONST_INT 
 	{
-		$factor_text = $CONST_INT->getText();
-		writeIntoparserLogFile("Line " + std::to_string($CONST_INT->getLine()) + ": factor : CONST_INT\n");
-		writeIntoparserLogFile($factor_text + "\n");	
+		LOG_REDUCTION("Line ", $CONST_INT->getLine(), ": factor : CONST_INT\n");
+		LOG_RULE_TEXT($start);	
 
-		current_const_type = "INT";	
-		assign_type = "int";
-		argument_list_types.push_back("int");
+		compilation->current_const_type = TYPE_INT;	
+		compilation->assign_type = TYPE_INT;
+		compilation->argument_list_types.push_back(TYPE_INT);
 	}
 	| CONST_FLOAT
 	{
-		$factor_text = $CONST_FLOAT->getText();
-		writeIntoparserLogFile("Line " + std::to_string($CONST_FLOAT->getLine()) + ": factor : CONST_FLOAT\n");
-		writeIntoparserLogFile($factor_text + "\n");	
+		LOG_REDUCTION("Line ", $CONST_FLOAT->getLine(), ": factor : CONST_FLOAT\n");
+		LOG_RULE_TEXT($start);	
 
-		current_const_type = "FLOAT";	
-		assign_type = "float";	
-		argument_list_types.push_back("float");	
+		compilation->current_const_type = TYPE_FLOAT;	
+		compilation->assign_type = TYPE_FLOAT;	
+		compilation->argument_list_types.push_back(TYPE_FLOAT);	
 	}
 	| v=variable INCOP 
 	{
-		$factor_text = $v.variable_text + $INCOP->getText();
-		writeIntoparserLogFile("Line " + std::to_string($INCOP->getLine()) + ": factor : variable INCOP\n");
-		writeIntoparserLogFile($factor_text + "\n");		
+		LOG_REDUCTION("Line ", $INCOP->getLine(), ": factor : variable INCOP\n");
+		LOG_RULE_TEXT($start);		
 	}
 	| v=variable DECOP
 	{
-		$factor_text = $v.variable_text + $DECOP->getText();
-		writeIntoparserLogFile("Line " + std::to_string($DECOP->getLine()) + ": factor : variable DECOP\n");
-		writeIntoparserLogFile($factor_text + "\n");		
+		LOG_REDUCTION("Line ", $DECOP->getLine(), ": factor : variable DECOP\n");
+		LOG_RULE_TEXT($start);		
 	}
 	;
 	
-argument_list returns [std::string arglist_text]
+argument_list
 		: a=arguments
 		{
-			$arglist_text = $a.args_text;
-			writeIntoparserLogFile("Line " + std::to_string($a.start->getLine()) + ": argument_list : arguments\n");
-			writeIntoparserLogFile($arglist_text + "\n");		
+			LOG_REDUCTION("Line ", $a.start->getLine(), ": argument_list : arguments\n");
+			LOG_RULE_TEXT($start);		
 		}
 		|
 		;
 	
-arguments returns [std::string args_text]
-	: a=arguments COMMA le=logic_expression
+arguments
+	: le=logic_expression
 	{
-		$args_text = $a.args_text + $COMMA->getText() + $le.logic_expression_text;
-		writeIntoparserLogFile("Line " + std::to_string($a.start->getLine()) + ": arguments : arguments COMMA logic_expression\n");
-		writeIntoparserLogFile($args_text + "\n");
-	}
-	| le=logic_expression
-	{
-		$args_text = $le.logic_expression_text;
-		writeIntoparserLogFile("Line " + std::to_string($le.start->getLine()) + ": arguments : logic_expression\n");
+		LOG_REDUCTION("Line ", $le.start->getLine(), ": arguments : logic_expression\n");
 
-		if(variableTypes.find($le.logic_expression_text) != variableTypes.end() && variableTypes[$le.logic_expression_text] == "array") {
-			syntaxErrorCount++;
-			std::string errorMessage = "Error at line " + std::to_string($le.start->getLine()) + ": Type mismatch, " + $le.logic_expression_text + " is an array";
-			writeIntoparserLogFile(errorMessage + "\n");
-			writeIntoErrorFile(errorMessage + "\n");
+		std::string argument_text = getRuleText($le.ctx);
+		SymbolInfo *argument_info = compilation->symbolTable.lookup(argument_text);
+		if(argument_info != nullptr && argument_info->isArray()) {
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $le.start->getLine(), ": Type mismatch, ", argument_text, " is an array");
 		}
-		writeIntoparserLogFile($args_text + "\n");				
+		LOG_RULE_TEXT($start);				
+	}
+	( COMMA le=logic_expression
+	{
+		LOG_REDUCTION("Line ", $start->getLine(), ": arguments : arguments COMMA logic_expression\n");
+		LOG_RULE_TEXT($start);
 	}
+	)*
 	;
@@ -1,10 +1,19 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include "antlr4-runtime.h"
 #include "C8086Lexer.h"
 #include "C8086Parser.h"
-#include "2105120_SymbolTable.hpp"
+#include "2105120_Compilation.hpp"
+#include "2105120_LogSink.hpp"
+#include "2105120_LogCategory.hpp"
+#include "2105120_ParseStats.hpp"
+#include "2105120_TwoStageParse.hpp"
 #include <vector>
 #include <map>
 
@@ -12,80 +21,195 @@
 using namespace antlr4;
 using namespace std;
 
-ofstream parserLogFile; // global output stream
-ofstream errorFile; // global error stream
-ofstream lexLogFile; // global lexer log stream
-
-int syntaxErrorCount;
-
-SymbolTable symbolTable(7);
-
-string current_const_type, assign_type, var_type, term_operand_type, unary_e_operand_type;
-vector<string> declaration_list_ids;
-map<string, string> variableTypes; // maps variable names to their types
-bool is_func_declaration = false;
-bool is_func_definition = false;
-vector<pair<string, string>> parameter_list_ids;
-vector<string> argument_list_types;
-
-SymbolInfo* currentFunction = nullptr; // pointer to the current function being processed
-
-int main(int argc, const char* argv[]) {
-    if (argc < 2) {
-        cerr << "Usage: " << argv[0] << " <input_file>" << endl;
-        return 1;
+struct CheckOptions {
+    bool asyncLog = false; // drain the log buffers on background writer threads
+    bool twoStage = true; // --ll parses with full LL prediction only
+    int repeat = 1; // parse this many times, to time parses with a warm decision DFA
+};
+
+// A lexer and a parser that check one file after another. The ATN and the decision DFA
+// belong to the grammar, not to the instances, so every file after the first one, on any
+// thread, starts with the DFA the earlier files have built.
+struct Checker {
+    unique_ptr<ANTLRInputStream> input;
+    unique_ptr<C8086Lexer> lexer;
+    unique_ptr<CommonTokenStream> tokens;
+    unique_ptr<C8086Parser> parser;
+
+    // the lexer rewinds its old input when it gets a new one, so the old one is freed last
+    void load(istream &stream) {
+        unique_ptr<ANTLRInputStream> next = make_unique<ANTLRInputStream>(stream);
+        if (!lexer) {
+            lexer = make_unique<C8086Lexer>(next.get());
+            tokens = make_unique<CommonTokenStream>(lexer.get());
+            parser = make_unique<C8086Parser>(tokens.get());
+            // this is necessary to avoid the default error listener and use our custom error handling
+            parser->removeErrorListeners();
+        } else {
+            lexer->setInputStream(next.get());
+            tokens->setTokenSource(lexer.get());
+            parser->setTokenStream(tokens.get());
+        }
+        parser->tokenLayout.clear();
+        input = std::move(next);
     }
+};
+
+// put everything the grammar actions write back to where it was before the parse
+void restartCompilation(Compilation &compilation, C8086Parser &parser) {
+    compilation.restart();
+    parser.tokenLayout.clear();
+    parser.reset(); // also rewinds the token stream
+}
 
+// check one file, its logs go to outputDirectory; false if a file cannot be opened
+bool checkFile(Checker &checker, const string &inputFileName, const string &outputDirectory, const CheckOptions &options, ParseStats &stats, int &errors) {
     // ---- Input File ----
-    ifstream inputFile(argv[1]);
+    ifstream inputFile(inputFileName);
     if (!inputFile.is_open()) {
-        cerr << "Error opening input file: " << argv[1] << endl;
-        return 1;
+        cerr << "Error opening input file: " << inputFileName << endl;
+        return false;
     }
 
-    string outputDirectory = "output/";
-    string parserLogFileName = outputDirectory + "parserLog.txt";
-    string errorFileName = outputDirectory + "errorLog.txt";
-    string lexLogFileName = outputDirectory + "lexerLog.txt";
-
     // create output directory if it doesn't exist
-    system(("mkdir -p " + outputDirectory).c_str());
+    error_code ignored;
+    filesystem::create_directories(outputDirectory, ignored);
 
     // ---- Output Files ----
-    parserLogFile.open(parserLogFileName);
-    if (!parserLogFile.is_open()) {
-        cerr << "Error opening parser log file: " << parserLogFileName << endl;
-        return 1;
-    }
+    Compilation compilation;
+    if (!compilation.open(outputDirectory, options.asyncLog)) return false;
 
-    errorFile.open(errorFileName);
-    if (!errorFile.is_open()) {
-        cerr << "Error opening error log file: " << errorFileName << endl;
-        return 1;
-    }
-
-    lexLogFile.open(lexLogFileName);
-    if (!lexLogFile.is_open()) {
-        cerr << "Error opening lexer log file: " << lexLogFileName << endl;
-        return 1;
-    }
     // ---- Parsing Flow ----
-    ANTLRInputStream input(inputFile);
-    C8086Lexer lexer(&input);
-    CommonTokenStream tokens(&lexer);
-    C8086Parser parser(&tokens);
-
-    // this is necessary to avoid the default error listener and use our custom error handling
-    parser.removeErrorListeners();
+    checker.load(inputFile);
+    C8086Parser &parser = *checker.parser;
+    checker.lexer->lexLogFile = &compilation.lexLogFile;
+    parser.compilation = &compilation;
 
     // start parsing at the 'start' rule
-    parser.start();
+    auto parse = [&]() -> tree::ParseTree * {
+        if (!options.twoStage) return parser.start();
+        return parseTwoStage(parser, [&] { restartCompilation(compilation, parser); }, stats.fullLLFallbacks);
+    };
+    if (options.repeat > 1) checker.tokens->fill(); // time the parses only, not the lexing of the first one
+    measureParse(stats, parse, [&] { restartCompilation(compilation, parser); }, options.repeat);
 
     // clean up
-    inputFile.close();
-    parserLogFile.close();
-    errorFile.close();
-    lexLogFile.close();
-    cout << "Parsing completed. Check the output files for details." << endl;
-    return 0;
+    errors = compilation.syntaxErrorCount;
+    compilation.close();
+    checker.lexer->lexLogFile = nullptr;
+    parser.compilation = nullptr;
+    return true;
+}
+
+struct FileResult {
+    bool checked = false;
+    int errors = 0;
+    double milliseconds = 0;
+};
+
+// every file of a batch gets an output directory named after its path,
+// e.g. ../sample_io/input1.txt logs to output/sample_io_input1.txt/
+string batchOutputDirectory(const string &inputFileName) {
+    string name;
+    for (const filesystem::path &part : filesystem::path(inputFileName)) {
+        if (part == "." || part == ".." || part == "/" || part.empty()) continue;
+        if (!name.empty()) name += '_';
+        name += part.string();
+    }
+    return "output/" + name + "/";
+}
+
+// check the files on a pool of worker threads, each with a checker of its own that
+// takes the next unchecked file until none is left
+vector<FileResult> checkBatch(const vector<string> &inputs, int jobs, const CheckOptions &options) {
+    vector<FileResult> results(inputs.size());
+    atomic<size_t> next{0};
+    auto worker = [&] {
+        Checker checker;
+        for (size_t i = next++; i < inputs.size(); i = next++) {
+            ParseStats stats;
+            results[i].checked = checkFile(checker, inputs[i], batchOutputDirectory(inputs[i]), options, stats, results[i].errors);
+            results[i].milliseconds = stats.parseMilliseconds;
+        }
+    };
+    vector<thread> pool;
+    for (int i = 0; i < jobs; i++) pool.emplace_back(worker);
+    for (thread &t : pool) t.join();
+    return results;
+}
+
+int main(int argc, const char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <input_file>... [--files=<list_file>] [--jobs=N] [--async-log] [--log=lexer,parser,symbols,errors] [--stats] [--repeat=N] [--ll]" << endl;
+        return 1;
+    }
+    CheckOptions options;
+    bool printStats = false; // parse time, context count and peak memory on stderr
+    vector<string> inputs;
+    bool batch = false; // more than one file, or a list of files: each gets output/<its path>/
+    int jobs = thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option.rfind("--", 0) != 0) inputs.push_back(option);
+        else if (option == "--async-log") options.asyncLog = true;
+        else if (option == "--stats") printStats = true;
+        else if (option == "--ll") options.twoStage = false;
+        else if (option.rfind("--repeat=", 0) == 0 && (options.repeat = atoi(option.c_str() + 9)) > 0) continue;
+        else if (option.rfind("--jobs=", 0) == 0 && (jobs = atoi(option.c_str() + 7)) > 0) continue;
+        else if (option.rfind("--log=", 0) == 0 && selectLogCategories(option.substr(6))) continue;
+        else if (option.rfind("--files=", 0) == 0) {
+            ifstream list(option.substr(8));
+            if (!list.is_open()) {
+                cerr << "Error opening file list: " << option.substr(8) << endl;
+                return 1;
+            }
+            for (string line; getline(list, line);) {
+                if (!line.empty()) inputs.push_back(line);
+            }
+            batch = true;
+        }
+        else {
+            cerr << "Unknown option: " << option << endl;
+            return 1;
+        }
+    }
+    if (inputs.size() > 1) batch = true;
+    jobs = max(1, min<int>(jobs, inputs.size()));
+
+    if (!batch) {
+        if (inputs.empty()) {
+            cerr << "No input file" << endl;
+            return 1;
+        }
+        Checker checker;
+        ParseStats stats;
+        int errors = 0;
+        if (!checkFile(checker, inputs[0], "output/", options, stats, errors)) return 1;
+        if (printStats) printParseStats(cerr, stats);
+        cout << "Parsing completed. Check the output files for details." << endl;
+        return 0;
+    }
+
+    auto begin = chrono::steady_clock::now();
+    vector<FileResult> results = checkBatch(inputs, jobs, options);
+    auto end = chrono::steady_clock::now();
+
+    int failed = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (!results[i].checked) {
+            failed++;
+            continue;
+        }
+        cout << inputs[i] << ": " << results[i].errors << " errors, logs in " << batchOutputDirectory(inputs[i]) << endl;
+    }
+    if (printStats) {
+        double milliseconds = chrono::duration<double, milli>(end - begin).count();
+        double parseMilliseconds = 0;
+        for (FileResult &result : results) parseMilliseconds += result.milliseconds;
+        cerr << "files: " << inputs.size() - failed << " checked, " << failed << " failed, " << jobs << " jobs" << endl;
+        cerr << "batch time: " << milliseconds << " ms (" << inputs.size() * 1000.0 / milliseconds << " files/s)" << endl;
+        cerr << "parse time: " << parseMilliseconds << " ms summed over files" << endl;
+        cerr << "peak memory: " << peakMemoryKB() << " KB" << endl;
+    }
+    return failed == 0 ? 0 : 1;
 }
@@ -0,0 +1,48 @@
+#!/bin/bash
+set -e
+
+# Compares the iterative grammar (C8086Parser.g4) with the left recursive one it replaced
+# (leftRecursiveParser.g4). Both are built into bench/<variant>, run on every sample input
+# and on the generated programs, and their logs must match. Each run prints the
+# --stats numbers: parse time, rule contexts, tree depth and peak memory.
+# usage: ./bench-grammar.sh [statements in the generated programs, default 20000]
+
+ANTLR_JAR="/usr/local/lib/antlr-4.13.2-complete.jar"
+INCLUDE_DIR="/usr/local/include/antlr4-runtime"
+LIB_DIR="/usr/local/lib"
+LINES=${1:-20000}
+
+mkdir -p bench
+
+./gen-bench-programs.sh bench "$LINES"
+
+for variant in C8086Parser leftRecursiveParser; do
+    dir="bench/$variant"
+    mkdir -p "$dir"
+    cp C8086Lexer.g4 Ctester.cpp *.hpp "$dir/"
+    cp "$variant.g4" "$dir/C8086Parser.g4"
+    (
+        cd "$dir"
+        java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Lexer.g4
+        java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Parser.g4
+        g++ -std=c++17 -O2 -w -I"$INCLUDE_DIR" -c C8086Lexer.cpp C8086Parser.cpp Ctester.cpp
+        g++ -std=c++17 C8086Lexer.o C8086Parser.o Ctester.o -L"$LIB_DIR" -lantlr4-runtime -o Ctester.out -pthread
+    )
+done
+
+status=0
+for input in input/*.c sample_io/input*.txt sampleio_abs/input*.txt bench/long.c bench/arrays.c; do
+    echo "== $input"
+    for variant in C8086Parser leftRecursiveParser; do
+        dir="bench/$variant"
+        echo "-- $variant"
+        (cd "$dir" && LD_LIBRARY_PATH="$LIB_DIR" ./Ctester.out "../../$input" --stats > /dev/null) || echo "failed (left recursive trees can overflow the stack)"
+    done
+    for log in parserLog.txt errorLog.txt lexerLog.txt; do
+        if ! cmp -s "bench/C8086Parser/output/$log" "bench/leftRecursiveParser/output/$log"; then
+            echo "DIFFERENT: $log"
+            status=1
+        fi
+    done
+done
+exit $status
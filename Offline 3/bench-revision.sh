@@ -0,0 +1,48 @@
+#!/bin/bash
+set -e
+
+# Compares the checker in the working tree with the one at a git revision, e.g. the
+# commit before a change: both are built into bench/current and bench/baseline, run on
+# every sample input and on the generated programs, and their logs must match.
+# Wall time and peak memory of each run come from /usr/bin/time.
+# usage: ./bench-revision.sh <revision> [statements in the generated programs, default 20000]
+
+ANTLR_JAR="/usr/local/lib/antlr-4.13.2-complete.jar"
+INCLUDE_DIR="/usr/local/include/antlr4-runtime"
+LIB_DIR="/usr/local/lib"
+REVISION=${1:?usage: ./bench-revision.sh <revision> [statements]}
+LINES=${2:-20000}
+
+mkdir -p bench
+./gen-bench-programs.sh bench "$LINES"
+
+rm -rf bench/current bench/baseline
+mkdir -p bench/current bench/baseline
+cp C8086Lexer.g4 C8086Parser.g4 Ctester.cpp *.hpp bench/current/
+git archive "$REVISION" . | tar -x -C bench/baseline
+
+for variant in current baseline; do
+    (
+        cd "bench/$variant"
+        java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Lexer.g4
+        java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Parser.g4
+        g++ -std=c++17 -O2 -w -I"$INCLUDE_DIR" -c C8086Lexer.cpp C8086Parser.cpp Ctester.cpp
+        g++ -std=c++17 C8086Lexer.o C8086Parser.o Ctester.o -L"$LIB_DIR" -lantlr4-runtime -o Ctester.out -pthread
+    )
+done
+
+status=0
+for input in input/*.c sample_io/input*.txt sampleio_abs/input*.txt bench/long.c bench/arrays.c; do
+    echo "== $input"
+    for variant in current baseline; do
+        echo -n "-- $variant: "
+        (cd "bench/$variant" && LD_LIBRARY_PATH="$LIB_DIR" /usr/bin/time -f "%e s, %M KB" ./Ctester.out "../../$input" > /dev/null)
+    done
+    for log in parserLog.txt errorLog.txt lexerLog.txt; do
+        if ! cmp -s "bench/current/output/$log" "bench/baseline/output/$log"; then
+            echo "DIFFERENT: $log"
+            status=1
+        fi
+    done
+done
+exit $status
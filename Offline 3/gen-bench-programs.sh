@@ -0,0 +1,49 @@
+#!/bin/bash
+set -e
+
+# Writes the generated benchmark inputs into the given directory:
+#   long.c    many statements with long operator chains and calls
+#   arrays.c  many arrays, shadowed names and indexed accesses in nested scopes
+# usage: ./gen-bench-programs.sh <directory> [statements, default 20000]
+
+DIR=$1
+LINES=${2:-20000}
+mkdir -p "$DIR"
+
+{
+    echo "int f(int a, int b, int c){"
+    echo "    return a + b * c;"
+    echo "}"
+    echo "int main(){"
+    echo -n "    int x, y, z"
+    for ((i = 0; i < 200; i++)); do echo -n ", v$i"; done
+    echo ";"
+    for ((i = 0; i < LINES; i++)); do
+        echo "    x = x + y * z - f(x, y, z) + 1 + 2 + 3 + 4 * 5 * 6;"
+    done
+    echo "    println(x);"
+    echo "}"
+} > "$DIR/long.c"
+
+{
+    echo -n "int g0[10]"
+    for ((i = 1; i < 200; i++)); do echo -n ", g$i[10]"; done
+    echo ";"
+    echo "int sum(int a, int b){"
+    echo "    return a + b;"
+    echo "}"
+    echo "int main(){"
+    echo "    int i, x;"
+    for ((i = 0; i < LINES / 10; i++)); do
+        g=$((i % 200))
+        echo "    {"
+        echo "        int g$g[5], t, a$i[20];"
+        echo "        g$g[1] = 3; a$i[2] = g$g[1] + 1; t = a$i[2] * g$g[1];"
+        echo "        x = sum(a$i[2], g$g[1]) + t;"
+        echo "    }"
+        echo "    g$g[i] = g$((g / 2))[i] + x;"
+        echo "    x = sum(g$g[0], g$g[1]);"
+    done
+    echo "    println(x);"
+    echo "}"
+} > "$DIR/arrays.c"
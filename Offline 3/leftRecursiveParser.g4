@@ -0,0 +1,823 @@
+parser grammar C8086Parser;
+
+options {
+    tokenVocab = C8086Lexer;
+}
+
+@parser::header {
+    #include <iostream>
+    #include <fstream>
+    #include <string>
+    #include <cstdlib>
+    #include <sstream>
+    #include "C8086Lexer.h"
+	#include "2105120_SymbolTable.hpp"
+	#include "2105120_Type.hpp"
+	#include "2105120_LogSink.hpp"
+	#include "2105120_LogCategory.hpp"
+	#include "2105120_Compilation.hpp"
+	#include <vector>
+	#include <map>
+
+    // logging statements compile to nothing when their category is compiled out
+    #define LOG_REDUCTION(...) LOG_IF(LOG_PARSER_REDUCTIONS) writeIntoparserLogFile(__VA_ARGS__)
+    #define LOG_RULE_TEXT(start) LOG_IF(LOG_PARSER_REDUCTIONS) writeRuleText(start)
+    #define LOG_ERROR(...) LOG_IF(LOG_ERRORS) { writeIntoparserLogFile(__VA_ARGS__, "\n"); writeIntoErrorFile(__VA_ARGS__, "\n"); }
+}
+
+@parser::members {
+    Compilation *compilation = nullptr; // the file being checked, set by the driver
+
+    template <typename... Parts>
+    void writeIntoparserLogFile(const Parts &... parts) {
+        if (!compilation->parserLogFile) {
+            std::cout << "Error opening parserLogFile.txt" << std::endl;
+            return;
+        }
+
+        (compilation->parserLogFile << ... << parts) << '\n';
+    }
+
+    template <typename... Parts>
+    void writeIntoErrorFile(const Parts &... parts) {
+        if (!compilation->errorFile) {
+            std::cout << "Error opening errorFile.txt" << std::endl;
+            return;
+        }
+        (compilation->errorFile << ... << parts) << '\n';
+    }
+
+	// rule text is not built as strings; a rule's text is its token interval, rendered
+	// with the separators and hidden tokens the grammar actions recorded per token
+	struct TokenLayout {
+		char separator = 0; // written before the token when it is not the first of an interval
+		bool hidden = false; // tokens dropped from the text by error alternatives
+	};
+	std::vector<TokenLayout> tokenLayout;
+
+	TokenLayout &layoutOf(size_t index) {
+		if(index >= tokenLayout.size()) tokenLayout.resize(index + 1);
+		return tokenLayout[index];
+	}
+
+	void setSeparator(antlr4::Token *token, char separator) {
+		layoutOf(token->getTokenIndex()).separator = separator;
+	}
+
+	// hide every token from 'from' to the last consumed one
+	void hideTokens(antlr4::Token *from) {
+		size_t last = _input->LT(-1)->getTokenIndex();
+		for(size_t i = from->getTokenIndex(); i <= last; i++) {
+			TokenLayout &layout = layoutOf(i);
+			layout.hidden = true;
+			if(i > from->getTokenIndex()) layout.separator = 0;
+		}
+	}
+
+	template <typename Out>
+	void renderTokens(Out &out, antlr4::Token *from, antlr4::Token *to) {
+		if(from == nullptr || to == nullptr) return;
+		size_t first = from->getTokenIndex(), last = to->getTokenIndex();
+		if(last == antlr4::INVALID_INDEX || last < first) return; // empty alternative
+		for(size_t i = first; i <= last; i++) {
+			const TokenLayout &layout = layoutOf(i);
+			if(i > first && layout.separator) out << layout.separator;
+			if(!layout.hidden) out << _input->get(i)->getText();
+		}
+	}
+
+	// log the text of the tokens from 'from' to the last consumed one
+	void writeRuleText(antlr4::Token *from) {
+		if (!compilation->parserLogFile) {
+			std::cout << "Error opening parserLogFile.txt" << std::endl;
+			return;
+		}
+		renderTokens(compilation->parserLogFile, from, _input->LT(-1));
+		compilation->parserLogFile << "\n\n";
+	}
+
+	// text of a finished rule, for the few checks that compare it
+	std::string getRuleText(antlr4::ParserRuleContext *ctx) {
+		std::ostringstream out;
+		renderTokens(out, ctx->start, ctx->stop);
+		return out.str();
+	}
+
+	void function_def(const std::string name, TypeId ret_type)
+	{
+		SymbolInfo *info = compilation->symbolTable.lookup(name);
+		if(info == nullptr)
+		{
+			compilation->symbolTable.insert(name, "func");
+			SymbolInfo *f = compilation->symbolTable.lookup(name);
+			f->setFuncReturnType(ret_type);
+		}
+	}
+
+	void type_error_check(const std::string name, TypeId ret_type, const std::string line)
+	{
+		SymbolInfo *info = compilation->symbolTable.lookup(name);
+		if(!info->isFunction())
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Multiple declaration of ", name);
+			return;			
+		}
+		int paramCount = info->getFuncParamsSize();
+		if(paramCount != compilation->parameter_list_ids.size() && info->getDeclarationStatus() == true)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Total number of arguments mismatch with declaration in function ", name);
+			return;			
+		}
+		info->setFuncParams(compilation->parameter_list_ids);
+		if(info->getFuncReturnType() != ret_type)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Return type mismatch of ", name);
+		}
+	}
+
+	void check_argument(const std::string name, const std::string line)
+	{
+		SymbolInfo *info = compilation->symbolTable.lookup(name);
+		if(info == nullptr) return;
+		const vector<TypeId> &params = info->getFuncParamTypes();
+		// std::cout << params.size() << " " << argument_list_types.size() << " " << name << "\n";
+		if(params.size() != compilation->argument_list_types.size())
+		{	
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", line, ": Total number of arguments mismatch with declaration in function ", name);
+			return;
+		}
+		else 
+		{
+			for(int i = 0; i < params.size(); i++)
+			{
+				if(params[i] != compilation->argument_list_types[i])
+				{
+					compilation->syntaxErrorCount++;
+					LOG_ERROR("Error at line ", line, ": ", i + 1, "th argument mismatch in function ", name);
+					return;
+				}
+			}
+		}
+	}
+}
+
+
+start : p=program
+	{
+		LOG_REDUCTION("Line ", $p.stop->getLine(), ": start : program\n");
+		LOG_IF(LOG_SYMBOL_TABLE) writeIntoparserLogFile(compilation->symbolTable.getSymbolTableAsString());
+		LOG_REDUCTION("Total number of lines: ", $p.stop->getLine());
+		LOG_REDUCTION("Total number of errors: ", compilation->syntaxErrorCount);
+	}
+	;
+
+program
+	: p=program un=unit 
+	{
+		setSeparator($un.start, '\n');
+		LOG_REDUCTION("Line ", $un.stop->getLine(), ": program : program unit\n");
+		LOG_RULE_TEXT($start);
+	} 
+	| un=unit 
+	{
+		LOG_REDUCTION("Line ", $un.stop->getLine(), ": program : unit\n");
+		LOG_RULE_TEXT($start);
+	}
+	;
+	
+unit
+	: vd=var_declaration 
+	{
+		LOG_REDUCTION("Line ", $vd.start->getLine(), ": unit : var_declaration\n");
+		LOG_RULE_TEXT($start);
+	}
+    | fd=func_declaration
+	{
+		LOG_REDUCTION("Line ", $fd.start->getLine(), ": unit : func_declaration\n");
+		LOG_RULE_TEXT($start);
+	}
+    | fdef=func_definition
+	{
+		LOG_REDUCTION("Line ", $fdef.stop->getLine(), ": unit : func_definition\n");
+		LOG_RULE_TEXT($start);
+	}
+    ;
+     
+func_declaration
+		: ts=type_specifier {compilation->is_func_declaration = true;} ID LPAREN pl=parameter_list RPAREN SEMICOLON
+		{
+			setSeparator($ID, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": func_declaration : type_specifier ID LPAREN parameter_list RPAREN SEMICOLON\n");
+			LOG_RULE_TEXT($start);
+
+			compilation->symbolTable.insert($ID->getText(), "func");
+			SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+			info->setFuncReturnType($ts.type);
+			info->setFuncParams(compilation->parameter_list_ids);
+			compilation->parameter_list_ids.clear();
+			info->setDeclarationStatus(true);
+			compilation->is_func_declaration = false;			
+		}
+		| ts=type_specifier {compilation->is_func_declaration = true;} ID LPAREN RPAREN SEMICOLON 
+		{
+			setSeparator($ID, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": func_declaration : type_specifier ID LPAREN RPAREN SEMICOLON\n");
+			LOG_RULE_TEXT($start);
+
+			compilation->symbolTable.insert($ID->getText(), "func");
+			SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+			info->setFuncReturnType($ts.type);
+			info->setDeclarationStatus(true);
+			compilation->is_func_declaration = false;
+		}
+		;
+		 
+func_definition
+	: ts=type_specifier ID {function_def($ID->getText(), $ts.type); compilation->is_func_definition = true;} LPAREN pl=parameter_list {type_error_check($ID->getText(), $ts.type, std::to_string($ID->getLine()));} RPAREN {compilation->currentFunction = compilation->symbolTable.lookup($ID->getText());} cs=compound_statement
+	{
+		setSeparator($ID, ' ');
+		LOG_REDUCTION("Line ", $cs.stop->getLine(), ": func_definition : type_specifier ID LPAREN parameter_list RPAREN compound_statement\n");
+		LOG_RULE_TEXT($start);
+		compilation->currentFunction = nullptr;
+		compilation->is_func_definition = false;
+	}
+	| ts=type_specifier ID {function_def($ID->getText(), $ts.type);} LPAREN RPAREN cs=compound_statement
+	{
+		setSeparator($ID, ' ');
+		LOG_REDUCTION("Line ", $cs.stop->getLine(), ": func_definition : type_specifier ID LPAREN RPAREN compound_statement\n");
+		LOG_RULE_TEXT($start);
+	}
+	| ts=type_specifier ID {function_def($ID->getText(), $ts.type);} LPAREN pl=parameter_list ADDOP RPAREN {
+				compilation->syntaxErrorCount++;
+		LOG_ERROR("Error at line ", $ADDOP->getLine(), ": syntax error, unexpected ADDOP, expecting RPAREN or COMMA");
+		layoutOf($ADDOP->getTokenIndex()).hidden = true;
+	} cs=compound_statement
+	{
+		setSeparator($ID, ' ');
+	}
+	;				
+
+
+parameter_list
+		: pl=parameter_list COMMA ts=type_specifier ID
+		{
+
+			if(!compilation->is_func_declaration || compilation->is_func_declaration)
+			{
+				// symbolTable.insert($ID->getText(), $ts.text);
+				bool found = false;
+				for(int i = 0; i < compilation->parameter_list_ids.size(); i++)
+					if(compilation->parameter_list_ids[i].first == $ID->getText())
+						found = true;
+				if(found == false)
+					compilation->parameter_list_ids.push_back({$ID->getText(), $ts.type});
+				else 
+				{
+					compilation->syntaxErrorCount++;
+					LOG_ERROR("Error at line ", $ts.start->getLine(), ": Multiple declaration of ", $ID->getText(), " in parameter");
+				}
+			}
+
+			setSeparator($ID, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": parameter_list : parameter_list COMMA type_specifier ID\n");
+			LOG_RULE_TEXT($start);
+		}
+		| pl=parameter_list COMMA type_specifier
+		{
+			hideTokens($start);
+		}
+ 		| ts=type_specifier ID
+		{
+			setSeparator($ID, ' ');
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": parameter_list : type_specifier ID\n");
+			LOG_RULE_TEXT($start);
+			
+			if(!compilation->is_func_declaration || compilation->is_func_declaration)
+			{
+				// symbolTable.insert($ID->getText(), $ts.text);
+				compilation->parameter_list_ids.push_back({$ID->getText(), $ts.type});
+			}
+		}
+		| ts=type_specifier
+		{
+			LOG_REDUCTION("Line ", $ts.start->getLine(), ": parameter_list : type_specifier\n");
+			LOG_RULE_TEXT($start);			
+		}
+ 		;
+
+ 		
+compound_statement
+		: LCURL {compilation->symbolTable.enterScope();
+			if(compilation->parameter_list_ids.size() > 0) 
+			{
+				for(int i = 0; i < compilation->parameter_list_ids.size(); i++)
+					compilation->symbolTable.insert(compilation->parameter_list_ids[i].first, typeTable.name(compilation->parameter_list_ids[i].second));
+				
+				compilation->parameter_list_ids.clear();
+			}
+		} ss=statements RCURL
+		{
+			setSeparator($ss.start, '\n');
+			setSeparator($RCURL, '\n');
+			LOG_REDUCTION("Line ", $RCURL->getLine(), ": compound_statement : LCURL statements RCURL\n");
+			LOG_RULE_TEXT($start);
+
+			LOG_IF(LOG_SYMBOL_TABLE) writeIntoparserLogFile(compilation->symbolTable.getSymbolTableAsString());
+			compilation->symbolTable.exitScope();
+		}
+		| LCURL {compilation->symbolTable.enterScope();
+			if(compilation->parameter_list_ids.size() > 0) 
+			{
+				for(int i = 0; i < compilation->parameter_list_ids.size(); i++)
+					compilation->symbolTable.insert(compilation->parameter_list_ids[i].first, typeTable.name(compilation->parameter_list_ids[i].second));
+				
+				compilation->parameter_list_ids.clear();
+			}
+		}  RCURL
+		{
+			LOG_REDUCTION("Line ", $RCURL->getLine(), ": compound_statement : LCURL RCURL\n");
+			LOG_RULE_TEXT($start);
+
+			LOG_IF(LOG_SYMBOL_TABLE) writeIntoparserLogFile(compilation->symbolTable.getSymbolTableAsString());
+			compilation->symbolTable.exitScope();
+		}
+		;
+ 		    
+var_declaration
+    : t=type_specifier dl=declaration_list sm=SEMICOLON {
+		setSeparator($dl.start, ' ');
+		LOG_REDUCTION("Line ", $sm->getLine(), ": var_declaration : type_specifier declaration_list SEMICOLON\n");
+		if($t.type == TYPE_VOID)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $sm->getLine(), ": Variable type cannot be ", $t.text);
+		}
+
+		for(int i=0; i<compilation->declaration_list_ids.size();i++)
+			if(compilation->symbolTable.insert(compilation->declaration_list_ids[i].first, $t.text))
+				compilation->symbolTable.lookupAtCurrentScope(compilation->declaration_list_ids[i].first)->setKind(compilation->declaration_list_ids[i].second);
+		compilation->declaration_list_ids.clear();
+
+		LOG_RULE_TEXT($start);
+	}
+    | t=type_specifier de=declaration_list_err sm=SEMICOLON
+	{
+		hideTokens($start);
+	}
+    ;
+
+declaration_list_err returns [std::string error_name]: {
+        $error_name = "Error in declaration list";
+    };
+
+ 		 
+type_specifier returns [std::string name_line, TypeId type]	
+        : INT {
+            $name_line = "type: INT at line" + std::to_string($INT->getLine());
+            $type = TYPE_INT;
+			LOG_REDUCTION("Line ", $INT->getLine(), ": type_specifier : INT\n");
+			LOG_REDUCTION($INT->getText(), "\n");
+        }
+ 		| FLOAT {
+            $name_line = "type: FLOAT at line" + std::to_string($FLOAT->getLine());
+            $type = TYPE_FLOAT;
+			LOG_REDUCTION("Line ", $FLOAT->getLine(), ": type_specifier : FLOAT\n");
+			LOG_REDUCTION($FLOAT->getText(), "\n");
+        }
+ 		| VOID {
+            $name_line = "type: VOID at line" + std::to_string($VOID->getLine());
+            $type = TYPE_VOID;
+			LOG_REDUCTION("Line ", $VOID->getLine(), ": type_specifier : VOID\n");
+			LOG_REDUCTION($VOID->getText(), "\n");
+        }
+ 		;
+ 		
+declaration_list
+		: dl=declaration_list COMMA ID 
+		{
+			LOG_REDUCTION("Line ", $ID->getLine(), ": declaration_list : declaration_list COMMA ID\n");
+			LOG_RULE_TEXT($start);
+
+			//symbolTable.insert($ID->getText(), "ID");
+			compilation->declaration_list_ids.push_back({$ID->getText(), KIND_VARIABLE});
+		}
+ 		| dl=declaration_list COMMA ID LTHIRD CONST_INT RTHIRD
+		{
+			// symbolTable.insert($ID->getText(), "ID");
+			SymbolInfo *info = compilation->symbolTable.lookupAtCurrentScope($ID->getText());
+			if(info == nullptr)
+			{
+				compilation->declaration_list_ids.push_back({$ID->getText(), KIND_ARRAY});
+			}
+			else 
+			{
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $ID->getLine(), ": Multiple declaration of ", $ID->getText());
+			}
+			LOG_REDUCTION("Line ", $ID->getLine(), ": declaration_list : declaration_list COMMA ID LTHIRD CONST_INT RTHIRD\n");
+			LOG_RULE_TEXT($start);			
+		}
+ 		| ID 
+		{
+			// bool inserted = symbolTable.insert($ID->getText(), "ID");
+			SymbolInfo *info = compilation->symbolTable.lookupAtCurrentScope($ID->getText());
+			if(info != nullptr) 
+			{
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $ID->getLine(), ": Multiple declaration of ", $ID->getText());
+			}
+			else 
+			{
+				compilation->declaration_list_ids.push_back({$ID->getText(), KIND_VARIABLE});
+			}
+			LOG_REDUCTION("Line ", $ID->getLine(), ": declaration_list : ID\n");
+			LOG_RULE_TEXT($start);
+			
+		}
+ 		| ID LTHIRD CONST_INT RTHIRD
+		{
+			LOG_REDUCTION("Line ", $ID->getLine(), ": declaration_list : ID LTHIRD CONST_INT RTHIRD\n");
+			LOG_RULE_TEXT($start);
+
+			// symbolTable.insert($ID->getText(), "ID");
+			compilation->declaration_list_ids.push_back({$ID->getText(), KIND_ARRAY});
+		}
+		| dl=declaration_list ADDOP ID
+		{
+			layoutOf($ADDOP->getTokenIndex()).hidden = true;
+			layoutOf($ID->getTokenIndex()).hidden = true;
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": syntax error, unexpected ADDOP, expecting COMMA or SEMICOLON");
+
+		}
+ 		;
+ 		  
+statements
+	: s=statement
+	{
+		LOG_REDUCTION("Line ", $s.start->getLine(), ": statements : statement\n");
+		LOG_RULE_TEXT($start);
+	}
+	| ss=statements s=statement
+	{
+		setSeparator($s.start, '\n');
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statements : statements statement\n");
+		LOG_RULE_TEXT($start);
+	}
+	;
+	   
+statement
+	: vd=var_declaration
+	{
+		LOG_REDUCTION("Line ", $vd.start->getLine(), ": statement : var_declaration\n");
+		LOG_RULE_TEXT($start);				
+	}
+	| es=expression_statement 
+	{
+		if(compilation->currentFunction != nullptr) compilation->currentFunction = nullptr;
+		LOG_REDUCTION("Line ", $es.start->getLine(), ": statement : expression_statement\n");
+		LOG_RULE_TEXT($start);				
+	}
+	| cs=compound_statement
+	{
+		LOG_REDUCTION("Line ", $cs.stop->getLine(), ": statement : compound_statement\n");
+		LOG_RULE_TEXT($start);
+	}
+	| FOR LPAREN es1=expression_statement es2=expression_statement e=expression RPAREN s=statement
+	{
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statement : FOR LPAREN expression_statement expression_statement expression RPAREN statement\n");
+		LOG_RULE_TEXT($start);
+	}
+	| IF LPAREN e=expression RPAREN s=statement
+	{
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statement : IF LPAREN expression RPAREN statement\n");
+		LOG_RULE_TEXT($start);		
+	}
+	| IF LPAREN e=expression RPAREN s1=statement ELSE s2=statement
+	{
+		setSeparator($s2.start, ' ');
+		LOG_REDUCTION("Line ", $s2.stop->getLine(), ": statement : IF LPAREN expression RPAREN statement ELSE statement\n");
+		LOG_RULE_TEXT($start);	
+	}
+	| WHILE LPAREN e=expression RPAREN s=statement
+	{
+		LOG_REDUCTION("Line ", $s.stop->getLine(), ": statement : WHILE LPAREN expression RPAREN statement\n");
+		LOG_RULE_TEXT($start);
+	}
+	| PRINTLN LPAREN ID RPAREN SEMICOLON
+	{
+		LOG_REDUCTION("Line ", $SEMICOLON->getLine(), ": statement : PRINTLN LPAREN ID RPAREN SEMICOLON\n");
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+		if(info == nullptr)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Undeclared variable ", $ID->getText());
+		}
+		LOG_RULE_TEXT($start);		
+	}
+	| RETURN e=expression SEMICOLON
+	{
+		setSeparator($e.start, ' ');
+		LOG_REDUCTION("Line ", $RETURN->getLine(), ": statement : RETURN expression SEMICOLON\n");
+		LOG_RULE_TEXT($start);
+
+		if(compilation->currentFunction != nullptr && compilation->currentFunction->getFuncReturnType() == TYPE_VOID)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $RETURN->getLine(), ": Cannot return value from function ", compilation->currentFunction->getName(), " with void return type");
+		}
+	}
+	;
+	  
+expression_statement
+			: SEMICOLON	
+			{
+				LOG_REDUCTION("Line ", $SEMICOLON->getLine(), ": expression_statement : SEMICOLON\n");
+				LOG_RULE_TEXT($start);
+			}		
+			| e=expression SEMICOLON
+			{
+				LOG_REDUCTION("Line ", $e.start->getLine(), ": expression_statement : expression SEMICOLON\n");
+				LOG_RULE_TEXT($start);				
+			} 
+			;
+	  
+variable
+	: ID 
+	{
+		LOG_REDUCTION("Line ", $ID->getLine(), ": variable : ID\n");
+
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+		if(info == nullptr) 
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Undeclared variable ", $ID->getText());
+		}
+		else 
+		{
+			compilation->var_type = info->getTypeId();
+			// std::cout << $ID->getText() << " " << var_type << std::endl;
+			if(info->isArray()) compilation->argument_list_types.push_back(TYPE_ARRAY);
+			else compilation->argument_list_types.push_back(info->getTypeId());
+		}
+		LOG_RULE_TEXT($start);
+	}		
+	| ID LTHIRD e=expression RTHIRD 
+	{
+		LOG_REDUCTION("Line ", $ID->getLine(), ": variable : ID LTHIRD expression RTHIRD\n");
+		if(compilation->current_const_type != TYPE_INT) 
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Expression inside third brackets not an integer");
+		}
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+		if(info != nullptr && info->getKind() == KIND_VARIABLE)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": ", $ID->getText(), " not an array");
+		}
+		if(info) compilation->var_type = info->getTypeId();
+		LOG_RULE_TEXT($start);
+	}
+	;
+	 
+ expression
+ 	: le=logic_expression
+	{
+		LOG_REDUCTION("Line ", $le.start->getLine(), ": expression : logic_expression\n");
+		LOG_RULE_TEXT($start);
+	}	
+	|  v=variable ASSIGNOP le=logic_expression 
+	{
+		LOG_REDUCTION("Line ", $v.start->getLine(), ": expression : variable ASSIGNOP logic_expression\n");
+
+		std::string variable_text = getRuleText($v.ctx);
+		SymbolInfo *variable_info = compilation->symbolTable.lookup(variable_text);
+		if(variable_info != nullptr && variable_info->isArray()) {
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $v.start->getLine(), ": Type mismatch, ", variable_text, " is an array");
+		}
+
+		if(compilation->var_type == TYPE_INT && compilation->assign_type == TYPE_FLOAT)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $v.start->getLine(), ": Type Mismatch");
+		}
+		compilation->var_type = TYPE_NONE;
+
+		if(compilation->currentFunction != nullptr && compilation->is_func_definition == false)
+		{
+			if(compilation->currentFunction->isFunction() && compilation->currentFunction->getFuncReturnType() == TYPE_VOID)
+			{
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $v.start->getLine(), ": Void function used in expression");
+			}
+			compilation->currentFunction = nullptr;
+		}
+
+		LOG_RULE_TEXT($start);
+	}
+	| UNRECOGNIZED
+	{
+		layoutOf($UNRECOGNIZED->getTokenIndex()).hidden = true;
+		compilation->syntaxErrorCount++;
+		LOG_ERROR("Error at line ", $UNRECOGNIZED->getLine(), ": Unrecognized character ", $UNRECOGNIZED->getText());
+	}
+	;
+			
+logic_expression
+		: re=rel_expression 
+		{
+			LOG_REDUCTION("Line ", $re.start->getLine(), ": logic_expression : rel_expression\n");
+			LOG_RULE_TEXT($start);
+		}
+		| re1=rel_expression LOGICOP re2=rel_expression 
+		{
+			LOG_REDUCTION("Line ", $re1.start->getLine(), ": logic_expression : rel_expression LOGICOP rel_expression\n");
+			LOG_RULE_TEXT($start);
+		}	
+		;
+			
+rel_expression
+		: se=simple_expression 
+		{
+			LOG_REDUCTION("Line ", $se.start->getLine(), ": rel_expression : simple_expression\n");
+			LOG_RULE_TEXT($start);
+		}
+		| se1=simple_expression RELOP se2=simple_expression
+		{
+			LOG_REDUCTION("Line ", $se1.start->getLine(), ": rel_expression : simple_expression RELOP simple_expression\n");
+			LOG_RULE_TEXT($start);
+		}
+		;
+				
+simple_expression
+		: t=term 
+		{
+			LOG_REDUCTION("Line ", $t.start->getLine(), ": simple_expression : term\n");
+			LOG_RULE_TEXT($start);
+		}
+		| se=simple_expression ADDOP t=term 
+		{
+			LOG_REDUCTION("Line ", $se.start->getLine(), ": simple_expression : simple_expression ADDOP term\n");
+			LOG_RULE_TEXT($start);
+		}
+		| se=simple_expression ADDOP ASSIGNOP t=term
+		{
+			hideTokens($start);
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $se.start->getLine(), ": syntax error, unexpected ASSIGNOP");
+		}
+		;
+					
+term
+	:	ue=unary_expression
+	{
+		LOG_REDUCTION("Line ", $ue.start->getLine(), ": term : unary_expression\n");
+		LOG_RULE_TEXT($start);
+
+		compilation->term_operand_type = compilation->unary_e_operand_type;
+	}
+    |  t=term MULOP ue=unary_expression
+	{
+		LOG_REDUCTION("Line ", $t.start->getLine(), ": term : term MULOP unary_expression\n");
+
+		if($MULOP->getText() == "%")
+		{
+			if(compilation->term_operand_type != TYPE_INT || compilation->unary_e_operand_type != TYPE_INT)
+			{
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $t.start->getLine(), ": Non-Integer operand on modulus operator");
+			}
+
+			if($ue.start == $ue.stop && $ue.start->getText() == "0")
+			{
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $t.start->getLine(), ": Modulus by Zero");
+			}
+		}
+
+		compilation->assign_type = TYPE_NONE;
+
+		if(compilation->currentFunction != nullptr)
+		{
+			if(compilation->currentFunction->isFunction() && compilation->currentFunction->getFuncReturnType() == TYPE_VOID)
+			{
+				compilation->syntaxErrorCount++;
+				LOG_ERROR("Error at line ", $t.start->getLine(), ": Void function used in expression");
+			}
+			compilation->currentFunction = nullptr;
+		}
+		if(compilation->argument_list_types.size() > 0) compilation->argument_list_types.pop_back();
+		LOG_RULE_TEXT($start);
+	}
+    ;
+
+unary_expression
+		: ADDOP ue=unary_expression  
+		{
+			LOG_REDUCTION("Line ", $ue.stop->getLine(), ": unary_expression : ADDOP unary_expression\n");
+			LOG_RULE_TEXT($start);			
+		}
+		| NOT ue=unary_expression 
+		{
+			LOG_REDUCTION("Line ", $ue.stop->getLine(), ": unary_expression : NOT unary_expression\n");
+			LOG_RULE_TEXT($start);			
+		}
+		| f=factor 
+		{
+			LOG_REDUCTION("Line ", $f.start->getLine(), ": unary_expression : factor\n");
+			LOG_RULE_TEXT($start);
+
+			compilation->unary_e_operand_type = compilation->assign_type;
+		}
+		;
+	
+factor
+	: v=variable 
+	{
+		LOG_REDUCTION("Line ", $v.start->getLine(), ": factor : variable\n");
+		LOG_RULE_TEXT($start);
+	}
+	| ID LPAREN {compilation->argument_list_types.clear();} al=argument_list RPAREN
+	{
+		LOG_REDUCTION("Line ", $ID->getLine(), ": factor : ID LPAREN argument_list RPAREN\n");
+		SymbolInfo *info = compilation->symbolTable.lookup($ID->getText());
+		if(info == nullptr)
+		{
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $ID->getLine(), ": Undefined function ", $ID->getText());
+		}
+		check_argument($ID->getText(), std::to_string($ID->getLine()));
+		LOG_RULE_TEXT($start);
+		compilation->argument_list_types.clear();	
+		compilation->assign_type = TYPE_NONE;
+		compilation->currentFunction = info;	
+	}
+	| LPAREN e=expression RPAREN
+	{
+		LOG_REDUCTION("Line ", $LPAREN->getLine(), ": factor : LPAREN expression RPAREN\n");
+		LOG_RULE_TEXT($start);		
+	}
+	| CONST_INT 
+	{
+		LOG_REDUCTION("Line ", $CONST_INT->getLine(), ": factor : CONST_INT\n");
+		LOG_RULE_TEXT($start);	
+
+		compilation->current_const_type = TYPE_INT;	
+		compilation->assign_type = TYPE_INT;
+		compilation->argument_list_types.push_back(TYPE_INT);
+	}
+	| CONST_FLOAT
+	{
+		LOG_REDUCTION("Line ", $CONST_FLOAT->getLine(), ": factor : CONST_FLOAT\n");
+		LOG_RULE_TEXT($start);	
+
+		compilation->current_const_type = TYPE_FLOAT;	
+		compilation->assign_type = TYPE_FLOAT;	
+		compilation->argument_list_types.push_back(TYPE_FLOAT);	
+	}
+	| v=variable INCOP 
+	{
+		LOG_REDUCTION("Line ", $INCOP->getLine(), ": factor : variable INCOP\n");
+		LOG_RULE_TEXT($start);		
+	}
+	| v=variable DECOP
+	{
+		LOG_REDUCTION("Line ", $DECOP->getLine(), ": factor : variable DECOP\n");
+		LOG_RULE_TEXT($start);		
+	}
+	;
+	
+argument_list
+		: a=arguments
+		{
+			LOG_REDUCTION("Line ", $a.start->getLine(), ": argument_list : arguments\n");
+			LOG_RULE_TEXT($start);		
+		}
+		|
+		;
+	
+arguments
+	: a=arguments COMMA le=logic_expression
+	{
+		LOG_REDUCTION("Line ", $a.start->getLine(), ": arguments : arguments COMMA logic_expression\n");
+		LOG_RULE_TEXT($start);
+	}
+	| le=logic_expression
+	{
+		LOG_REDUCTION("Line ", $le.start->getLine(), ": arguments : logic_expression\n");
+
+		std::string argument_text = getRuleText($le.ctx);
+		SymbolInfo *argument_info = compilation->symbolTable.lookup(argument_text);
+		if(argument_info != nullptr && argument_info->isArray()) {
+			compilation->syntaxErrorCount++;
+			LOG_ERROR("Error at line ", $le.start->getLine(), ": Type mismatch, ", argument_text, " is an array");
+		}
+		LOG_RULE_TEXT($start);				
+	}
+	;
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "2105120_Arena.hpp"
+#include "2105120_Atom.hpp"
+
+using namespace std;
+
+// Typed AST, built by the actions of C8086AstParser.g4 (--ast).
+// Every node lives in the arena and refers to its children directly; lists of children
+// are arrays in the arena. Identifiers and literals are atoms and every node carries the
+// line it starts on, so nothing points back into the parse tree or the token buffer and
+// both can be freed as soon as a unit has been turned into AST.
+
+enum NodeKind {
+    // units
+    NODE_VAR_DECL, // also a statement
+    NODE_FUNC_DECL,
+    NODE_FUNC_DEF,
+    // statements
+    NODE_EXPR_STMT,
+    NODE_COMPOUND,
+    NODE_FOR,
+    NODE_IF,
+    NODE_WHILE,
+    NODE_PRINTLN,
+    NODE_RETURN,
+    // expressions
+    NODE_ASSIGN,
+    NODE_BINARY,
+    NODE_UNARY,
+    NODE_CALL,
+    NODE_CONST_INT,
+    NODE_CONST_FLOAT,
+    NODE_LOAD,
+    NODE_POST_INC,
+    NODE_POST_DEC
+};
+
+enum TypeSpecifier {
+    SPEC_INT,
+    SPEC_FLOAT,
+    SPEC_VOID
+};
+
+enum Operator {
+    OP_ADD, OP_SUB, // ADDOP
+    OP_MUL, OP_DIV, OP_MOD, // MULOP
+    OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE, // RELOP
+    OP_AND, OP_OR, // LOGICOP
+    OP_NEG, OP_PLUS, OP_NOT // unary
+};
+
+inline Operator binaryOperator(const string &text) {
+    static const char *texts[] = {"+", "-", "*", "/", "%", "<", "<=", ">", ">=", "==", "!=", "&&", "||"};
+    for(int op = OP_ADD; op <= OP_OR; op++) {
+        if(text == texts[op]) return Operator(op);
+    }
+    return OP_MOD; // MULOP is * / or %, the action code treats anything else as %
+}
+
+inline const char *operatorText(Operator op) {
+    static const char *texts[] = {"+", "-", "*", "/", "%", "<", "<=", ">", ">=", "==", "!=", "&&", "||", "-", "+", "!"};
+    return texts[op];
+}
+
+struct Node {
+    NodeKind kind;
+    int line;
+};
+
+struct Expr : Node {};
+
+struct Stmt : Node {};
+
+// ID or ID[index]
+struct VarRef {
+    Atom name;
+    int line;
+    Expr *index; // nullptr for a plain variable
+};
+
+struct Declarator {
+    Atom name;
+    int line;
+    int arraySize; // -1 for a plain variable
+};
+
+struct Param {
+    TypeSpecifier type;
+    Atom name; // NO_ATOM when only the type is given
+};
+
+struct VarDecl : Stmt {
+    TypeSpecifier type;
+    Array<Declarator> declarators;
+};
+
+struct Compound : Stmt {
+    Array<Stmt *> statements;
+};
+
+// NODE_FUNC_DECL has no body
+struct Function : Node {
+    TypeSpecifier returnType;
+    Atom name;
+    Array<Param> params;
+    Compound *body;
+};
+
+struct ExprStmt : Stmt {
+    Expr *expr; // nullptr for an empty statement
+};
+
+struct For : Stmt {
+    Expr *init, *condition; // expression statements, either may be empty
+    Expr *step;
+    Stmt *body;
+};
+
+struct If : Stmt {
+    Expr *condition;
+    Stmt *thenBody;
+    Stmt *elseBody; // nullptr without an else
+    int elseLine;
+};
+
+struct While : Stmt {
+    Expr *condition;
+    Stmt *body;
+};
+
+struct Println : Stmt {
+    Atom name;
+};
+
+struct Return : Stmt {
+    Expr *value;
+};
+
+// line is the line of the operator token
+struct Assign : Expr {
+    VarRef *target;
+    Expr *value;
+};
+
+struct Binary : Expr {
+    Operator op;
+    Expr *left, *right;
+};
+
+struct Unary : Expr {
+    Operator op;
+    Expr *operand;
+};
+
+struct Call : Expr {
+    Atom name;
+    Array<Expr *> arguments;
+};
+
+// the literal is kept as written, it is emitted as it is
+struct Constant : Expr {
+    Atom text;
+};
+
+// NODE_LOAD, NODE_POST_INC and NODE_POST_DEC
+struct VarAccess : Expr {
+    VarRef *var;
+};
+
+struct Program {
+    Array<Node *> units;
+};
+
+inline Arena astArena;
+
+inline VarRef *newVarRef(Atom name, int line, Expr *index) {
+    return astArena.make<VarRef>(name, line, index);
+}
+
+inline VarDecl *newVarDecl(TypeSpecifier type, int line, Array<Declarator> declarators) {
+    return astArena.make<VarDecl>(Stmt{{NODE_VAR_DECL, line}}, type, declarators);
+}
+
+inline Function *newFunction(NodeKind kind, TypeSpecifier returnType, Atom name, int line, Array<Param> params, Compound *body) {
+    return astArena.make<Function>(Node{kind, line}, returnType, name, params, body);
+}
+
+inline Compound *newCompound(int line, Array<Stmt *> statements) {
+    return astArena.make<Compound>(Stmt{{NODE_COMPOUND, line}}, statements);
+}
+
+inline ExprStmt *newExprStmt(int line, Expr *expr) {
+    return astArena.make<ExprStmt>(Stmt{{NODE_EXPR_STMT, line}}, expr);
+}
+
+inline For *newFor(int line, Expr *init, Expr *condition, Expr *step, Stmt *body) {
+    return astArena.make<For>(Stmt{{NODE_FOR, line}}, init, condition, step, body);
+}
+
+inline If *newIf(int line, Expr *condition, Stmt *thenBody, Stmt *elseBody = nullptr, int elseLine = 0) {
+    return astArena.make<If>(Stmt{{NODE_IF, line}}, condition, thenBody, elseBody, elseLine);
+}
+
+inline While *newWhile(int line, Expr *condition, Stmt *body) {
+    return astArena.make<While>(Stmt{{NODE_WHILE, line}}, condition, body);
+}
+
+inline Println *newPrintln(int line, Atom name) {
+    return astArena.make<Println>(Stmt{{NODE_PRINTLN, line}}, name);
+}
+
+inline Return *newReturn(int line, Expr *value) {
+    return astArena.make<Return>(Stmt{{NODE_RETURN, line}}, value);
+}
+
+inline Assign *newAssign(int line, VarRef *target, Expr *value) {
+    return astArena.make<Assign>(Expr{{NODE_ASSIGN, line}}, target, value);
+}
+
+inline Binary *newBinary(Operator op, int line, Expr *left, Expr *right) {
+    return astArena.make<Binary>(Expr{{NODE_BINARY, line}}, op, left, right);
+}
+
+inline Unary *newUnary(Operator op, int line, Expr *operand) {
+    return astArena.make<Unary>(Expr{{NODE_UNARY, line}}, op, operand);
+}
+
+inline Call *newCall(Atom name, int line, Array<Expr *> arguments) {
+    return astArena.make<Call>(Expr{{NODE_CALL, line}}, name, arguments);
+}
+
+inline Constant *newConstant(NodeKind kind, Atom text, int line) {
+    return astArena.make<Constant>(Expr{{kind, line}}, text);
+}
+
+inline VarAccess *newVarAccess(NodeKind kind, VarRef *var, int line) {
+    return astArena.make<VarAccess>(Expr{{kind, line}}, var);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+using namespace std;
+
+// Bump allocator for the AST.
+// Objects are carved out of 64 KiB chunks one after another and are never freed one by
+// one: the whole arena is emptied at once (reset) or cut back to an earlier mark
+// (rollback), and the chunks are kept for reuse. Nothing in the arena is ever destroyed,
+// so only trivially destructible types may be put in it.
+
+// a run of objects stored next to each other in the arena
+template <typename T>
+struct Array {
+    T *items = nullptr;
+    int size = 0;
+
+    T *begin() const { return items; }
+    T *end() const { return items + size; }
+    T &operator[](int i) const { return items[i]; }
+};
+
+class Arena {
+    static constexpr size_t CHUNK_SIZE = 1 << 16;
+
+    struct Chunk {
+        char *data;
+        size_t size;
+    };
+
+    vector<Chunk> chunks;
+    size_t current = 0; // chunk being filled
+    size_t used = 0; // bytes taken in the current chunk
+    size_t bytes = 0; // bytes handed out since the last reset
+
+    public:
+        struct Mark {
+            size_t chunk, used, bytes;
+        };
+
+        Arena() {}
+
+        ~Arena() {
+            for(Chunk &chunk : chunks) free(chunk.data);
+        }
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        void *allocate(size_t size, size_t align) {
+            while(current < chunks.size()) {
+                size_t offset = (used + align - 1) & ~(align - 1);
+                if(offset + size <= chunks[current].size) {
+                    used = offset + size;
+                    bytes += size;
+                    return chunks[current].data + offset;
+                }
+                if(current + 1 == chunks.size()) break;
+                current++; // a kept chunk from before a reset, or one too small for this request
+                used = 0;
+            }
+            size_t chunkSize = max(CHUNK_SIZE, size + align); // a large array gets a chunk of its own
+            char *data = static_cast<char *>(malloc(chunkSize));
+            if(data == nullptr) throw bad_alloc();
+            chunks.push_back({data, chunkSize});
+            current = chunks.size() - 1;
+            used = size;
+            bytes += size;
+            return data;
+        }
+
+        template <typename T, typename... Args>
+        T *make(Args &&... args) {
+            static_assert(is_trivially_destructible<T>::value, "arena objects are never destroyed");
+            return new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+        }
+
+        template <typename T>
+        Array<T> copy(const vector<T> &items) {
+            static_assert(is_trivially_destructible<T>::value, "arena objects are never destroyed");
+            Array<T> array;
+            if(items.empty()) return array;
+            array.items = static_cast<T *>(allocate(sizeof(T) * items.size(), alignof(T)));
+            array.size = items.size();
+            uninitialized_copy(items.begin(), items.end(), array.items);
+            return array;
+        }
+
+        Mark mark() const {
+            return {current, used, bytes};
+        }
+
+        // forget everything allocated after the mark
+        void rollback(const Mark &mark) {
+            current = mark.chunk;
+            used = mark.used;
+            bytes = mark.bytes;
+        }
+
+        void reset() {
+            rollback({0, 0, 0});
+        }
+
+        size_t bytesUsed() const {
+            return bytes;
+        }
+
+        size_t bytesReserved() const {
+            size_t total = 0;
+            for(const Chunk &chunk : chunks) total += chunk.size;
+            return total;
+        }
+};
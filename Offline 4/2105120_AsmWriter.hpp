@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <stack>
+#include "2105120_SymbolTable.hpp"
+#include "2105120_LogSink.hpp"
+
+using namespace std;
+
+// Pieces of 8086 output shared by the grammar actions of C8086Parser.g4 and the
+// code generation pass over the AST, together with the compilation state they update.
+
+extern LogSink asmCodeFile;
+extern SymbolTable symbolTable;
+extern bool codeSegmentStarted;
+extern int label_count;
+extern stack<string> currentFunctions;
+extern int localVarCount;
+extern bool isReturnPresent;
+
+template <typename... Parts>
+void writeIntoCodeFile(const Parts &... parts) {
+	(asmCodeFile << ... << parts);
+}
+
+inline void writeCodeSegment() {
+	if(codeSegmentStarted == false) {
+		writeIntoCodeFile(".code\n");
+		codeSegmentStarted = true;
+	}
+}
+
+inline void writeProcName(const string procName) {
+	writeIntoCodeFile(procName, " proc\n");
+	if(procName == "main") {
+		writeIntoCodeFile("\tmov ax, @data\n\tmov ds, ax\n\n");
+	}
+	currentFunctions.push(procName);
+}
+
+inline void writeProcEnd(const string procName, int paramSize) {
+	if(procName == "main")
+	{
+		writeIntoCodeFile("\tmov ah, 4ch\n\tint 21h\n");
+	}
+	else
+	{
+		if(paramSize == 0)
+			writeIntoCodeFile("\tret\n");
+		else
+			writeIntoCodeFile("\tret ", paramSize, "\n");
+	}
+	writeIntoCodeFile(procName, " endp\n\n");
+	currentFunctions.pop();
+}
+
+template <typename Label>
+void writeLabel(const Label &label)
+{
+	writeIntoCodeFile("L", label, ":\n");
+}
+
+inline void writeJumpConditionByRelop(const string optr, int falseLabel)
+{
+	string jmpStr;
+	if(optr == "<=") jmpStr = "jnle";
+	else if(optr == "!=") jmpStr = "je";
+	else if(optr == "==") jmpStr = "jne";
+	else if(optr == "<") jmpStr = "jge";
+	else if(optr == ">") jmpStr = "jle";
+	else if(optr == ">=") jmpStr = "jnge";
+
+	writeIntoCodeFile("\t", jmpStr, " L", falseLabel, "\n");
+}
+
+inline void declareVariable(string varName)
+{
+	if(symbolTable.getCurrentScopeId() == "1") // global scope
+	{
+		writeIntoCodeFile("\t", varName, " dw 0h\n");
+		symbolTable.insert(varName, "global");
+	}
+	else // local scope
+	{
+		localVarCount++;
+		writeIntoCodeFile("\tsub sp, 2\n");
+		symbolTable.insert(varName, "local", localVarCount * 2);
+	}
+}
+
+inline void declareArray(string arrName, int size)
+{
+	if(symbolTable.getCurrentScopeId() == "1") // global scope
+	{
+		writeIntoCodeFile("\t", arrName, " dw ", size, " dup (0)\n");
+		symbolTable.insert(arrName, "global");
+	}
+	else // local scope
+	{
+		localVarCount += size;
+		writeIntoCodeFile("\tsub sp, ", size * 2, "\n");
+		symbolTable.insert(arrName, "local", localVarCount * 2, size);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+
+using namespace std;
+
+// Interned identifiers and literal texts.
+// The AST names every identifier and literal by a small integer, the text is stored once
+// here no matter how often it appears in the program, and outlives the token buffer.
+typedef int Atom;
+
+const Atom NO_ATOM = -1; // e.g. the name of a parameter declared without one
+
+class AtomTable {
+    deque<string> names; // a deque keeps the strings in place, the map keys point into them
+    unordered_map<string_view, Atom> ids;
+
+    public:
+        Atom intern(const string &name) {
+            unordered_map<string_view, Atom>::iterator it = ids.find(name);
+            if(it != ids.end()) return it->second;
+            Atom id = names.size();
+            names.push_back(name);
+            ids.emplace(string_view(names.back()), id);
+            return id;
+        }
+
+        const string &name(Atom atom) const {
+            return names[atom];
+        }
+
+        size_t size() const {
+            return names.size();
+        }
+};
+
+inline AtomTable atoms;
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "2105120_IR.hpp"
+#include "2105120_StrengthReduction.hpp"
+
+using namespace std;
+
+// Constant folding and propagation over the three-address code (-O1).
+// Values are 16 bit and wrap around like the registers; / and % are the unsigned div the
+// code uses, and a division by a constant 0 is left for the program to fault on.
+//  - an instruction whose operands are all known becomes a constant
+//  - a constant stored into a local or parameter replaces the loads of it up to its next
+//    store or increment, or the next label, where another path may join
+//  - a comparison or a zero test of known values becomes a jump or goes away, which
+//    leaves code that can not run to 2105120_DeadCode.hpp
+//  - a constant used where the 8086 takes an immediate (add, sub, cmp, a store, a return,
+//    an element index) or strength reduction can use it (a factor, a divisor) is put into
+//    the instruction, and its own instruction goes
+// The caller runs this again after dead code elimination, until nothing changes, as a
+// removed branch can make the result of a relational operator known.
+class ConstantFolder {
+    public:
+        int folded = 0;       // instructions that became constants
+        int propagated = 0;   // loads that became constants
+        int branchesRemoved = 0;
+        int removed = 0;      // instructions removed
+
+        bool fold(IRProgram &program) {
+            ir = &program;
+            return propagate();
+        }
+
+    private:
+        IRProgram *ir = nullptr;
+        vector<int> known; // value of each temporary with a single, constant definition
+        vector<bool> isKnown;
+        vector<bool> dead; // instructions to remove at the end of the round
+
+        bool constant(Operand operand, int &value) const {
+            if(operand.kind == OPERAND_CONST) {
+                value = ir->constants[operand.id].value;
+                return true;
+            }
+            if(operand.kind == OPERAND_TEMP && isKnown[operand.id]) {
+                value = known[operand.id];
+                return true;
+            }
+            return false;
+        }
+
+        bool localScalar(Operand operand) const {
+            if(operand.kind != OPERAND_VAR) return false;
+            const Variable &var = ir->variables[operand.id];
+            return var.storage != STORAGE_GLOBAL && var.length < 0;
+        }
+
+        static bool compute(Opcode op, int a, int b, int &result) {
+            unsigned short x = a, y = b;
+            switch(op) {
+                case IR_COPY: result = a; break;
+                case IR_NEG: result = -a; break;
+                case IR_ADD: result = a + b; break;
+                case IR_SUB: result = a - b; break;
+                case IR_MUL: result = unsigned(x) * y; break;
+                case IR_DIV: if(y == 0) return false; result = x / y; break;
+                case IR_MOD: if(y == 0) return false; result = x % y; break;
+                default: return false;
+            }
+            result = (short)result;
+            return true;
+        }
+
+        void becomeConstant(Instr &instr, int value) {
+            instr.op = IR_CONST;
+            instr.a = ir->constantValue(value);
+            instr.b = Operand();
+            instr.imm = 0;
+            isKnown[instr.dst.id] = true;
+            known[instr.dst.id] = ir->constants[instr.a.id].value;
+        }
+
+        // put a known temporary into the instruction as an immediate
+        bool immediate(Operand &operand) {
+            int value;
+            if(operand.kind != OPERAND_TEMP || !constant(operand, value)) return false;
+            operand = ir->constantValue(value);
+            return true;
+        }
+
+        bool propagate() {
+            int temps = ir->temps.size(), length = ir->code.size();
+            vector<int> definitions(temps, 0);
+            for(const Instr &instr : ir->code) {
+                if(instr.dst.kind == OPERAND_TEMP) definitions[instr.dst.id]++;
+            }
+            known.assign(temps, 0);
+            isKnown.assign(temps, false);
+            dead.assign(length, false);
+            unordered_map<int, int> variables; // known values of locals and parameters
+            bool changed = false;
+
+            for(int i = 0; i < length; i++) {
+                Instr &instr = ir->code[i];
+                bool single = instr.dst.kind == OPERAND_TEMP && definitions[instr.dst.id] == 1;
+                int a, b, value;
+                switch(instr.op) {
+                    case IR_FUNC_BEGIN:
+                    case IR_LABEL:
+                        variables.clear();
+                        break;
+                    case IR_CONST:
+                    case IR_SET:
+                        if(single) {
+                            isKnown[instr.dst.id] = true;
+                            known[instr.dst.id] = ir->constants[instr.a.id].value;
+                        }
+                        break;
+                    case IR_LOAD: {
+                        if(!single || !localScalar(instr.a)) break;
+                        auto found = variables.find(instr.a.id);
+                        if(found == variables.end()) break;
+                        becomeConstant(instr, found->second);
+                        propagated++;
+                        changed = true;
+                        break;
+                    }
+                    case IR_STORE:
+                        changed = immediate(instr.b) || changed;
+                        if(!localScalar(instr.a)) break;
+                        if(constant(instr.b, value)) variables[instr.a.id] = value;
+                        else variables.erase(instr.a.id);
+                        break;
+                    case IR_POST_INC:
+                    case IR_POST_DEC:
+                        if(localScalar(instr.a)) variables.erase(instr.a.id);
+                        break;
+                    case IR_COPY:
+                    case IR_NEG:
+                        if(single && constant(instr.a, a) && compute(instr.op, a, 0, value)) {
+                            becomeConstant(instr, value);
+                            folded++;
+                            changed = true;
+                        }
+                        break;
+                    case IR_ADD:
+                    case IR_SUB:
+                    case IR_MUL:
+                    case IR_DIV:
+                    case IR_MOD:
+                        if(single && constant(instr.a, a) && constant(instr.b, b) && compute(instr.op, a, b, value)) {
+                            becomeConstant(instr, value);
+                            folded++;
+                            changed = true;
+                        }
+                        else if(instr.op == IR_ADD || instr.op == IR_SUB) {
+                            changed = immediate(instr.b) || changed;
+                            changed = immediate(instr.a) || changed;
+                        }
+                        else {
+                            if(instr.op == IR_MUL && instr.a.kind == OPERAND_TEMP && isKnown[instr.a.id]) swap(instr.a, instr.b);
+                            if(constant(instr.b, b) && takesConstant(instr.op, b)) changed = immediate(instr.b) || changed;
+                        }
+                        break;
+                    case IR_ELEMENT:
+                        changed = immediate(instr.b) || changed;
+                        break;
+                    case IR_RELATION:
+                        if(single && constant(instr.a, a) && constant(instr.b, b)) {
+                            becomeConstant(instr, holds(Operator(instr.imm), a, b));
+                            folded++;
+                            changed = true;
+                        }
+                        else if(instr.a.kind == OPERAND_TEMP && isKnown[instr.a.id]) { // cmp takes the immediate second
+                            swap(instr.a, instr.b);
+                            instr.imm = mirrored(Operator(instr.imm));
+                            changed = immediate(instr.b) || changed;
+                        }
+                        else changed = immediate(instr.b) || changed;
+                        break;
+                    case IR_RETURN:
+                        changed = immediate(instr.a) || changed;
+                        break;
+                    case IR_JUMP_UNLESS:
+                        if(constant(instr.a, a) && constant(instr.b, b)) {
+                            if(holds(Operator(instr.imm), a, b)) dead[i] = true;
+                            else {
+                                instr.op = IR_JUMP;
+                                instr.a = instr.b = Operand();
+                                instr.note = JUMP_PLAIN;
+                            }
+                            branchesRemoved++;
+                            changed = true;
+                        }
+                        else if(instr.a.kind == OPERAND_TEMP && isKnown[instr.a.id]) { // cmp takes the immediate second
+                            swap(instr.a, instr.b);
+                            instr.imm = mirrored(Operator(instr.imm));
+                            changed = immediate(instr.b) || changed;
+                        }
+                        else changed = immediate(instr.b) || changed;
+                        break;
+                    case IR_JUMP_ZERO:
+                    case IR_JUMP_NONZERO:
+                        if(constant(instr.a, a)) {
+                            if((a == 0) == (instr.op == IR_JUMP_ZERO)) {
+                                instr.op = IR_JUMP;
+                                instr.a = Operand();
+                            }
+                            else dead[i] = true;
+                            branchesRemoved++;
+                            changed = true;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+            compact();
+            return changed;
+        }
+
+        bool compact() {
+            int kept = 0;
+            for(int i = 0; i < (int)ir->code.size(); i++) {
+                if(dead[i]) continue;
+                ir->code[kept++] = ir->code[i];
+            }
+            int gone = ir->code.size() - kept;
+            ir->code.resize(kept);
+            removed += gone;
+            return gone > 0;
+        }
+};
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "2105120_IR.hpp"
+
+using namespace std;
+
+// Dead and unreachable code elimination over the three-address code (-O1).
+// Each function is cut into basic blocks: a block starts at a label and after a jump or a
+// return, and ends at the next such place. Its successors are the blocks its last
+// instruction may go to. The blocks not reachable from the first one go, with their
+// statement comments kept; then
+//  - a jump, or a conditional jump, to the label right behind it
+//  - a label no jump names
+//  - an instruction without side effects whose temporary is never read
+// A removed jump can leave the operands of its test unread, and a removed value can leave
+// the block that only it ended, so the caller runs this again until nothing changes.
+class DeadCodeEliminator {
+    public:
+        int removed = 0;
+        vector<Atom> functions; // in the order of the program
+        unordered_map<Atom, int> removedIn;
+
+        bool eliminate(IRProgram &program) {
+            ir = &program;
+            int length = ir->code.size();
+            dead.assign(length, false);
+            labelAt.assign(ir->labels.size(), -1);
+            for(int i = 0; i < length; i++) {
+                if(ir->code[i].op == IR_LABEL) labelAt[ir->code[i].c.id] = i;
+            }
+            for(int begin = 0; begin < length; begin++) {
+                if(ir->code[begin].op != IR_FUNC_BEGIN) continue;
+                int end = begin;
+                while(end < length && ir->code[end].op != IR_FUNC_END) end++;
+                unreachable(begin, end);
+                begin = end;
+            }
+            redundantJumps();
+            unnamedLabels();
+            unreadValues();
+            return compact();
+        }
+
+    private:
+        struct Block {
+            int first, last; // instructions
+            vector<int> successors;
+        };
+
+        IRProgram *ir = nullptr;
+        vector<bool> dead;
+        vector<int> labelAt; // instruction of each label, -1 for the end label of a function
+
+        static bool endsBlock(Opcode op) {
+            return op == IR_JUMP || op == IR_JUMP_ZERO || op == IR_JUMP_NONZERO || op == IR_JUMP_UNLESS || op == IR_RETURN;
+        }
+
+        static bool conditional(Opcode op) {
+            return op == IR_JUMP_ZERO || op == IR_JUMP_NONZERO || op == IR_JUMP_UNLESS;
+        }
+
+        // the blocks of the function between begin (IR_FUNC_BEGIN) and end (IR_FUNC_END)
+        vector<Block> blocks(int begin, int end, vector<int> &blockOf) const {
+            vector<Block> result;
+            for(int i = begin + 1; i < end; i++) {
+                const Instr &instr = ir->code[i];
+                bool leader = result.empty() || instr.op == IR_LABEL || endsBlock(ir->code[i - 1].op);
+                if(leader) result.push_back(Block{i, i, {}});
+                result.back().last = i;
+                blockOf[i] = result.size() - 1;
+            }
+            int exit = result.size(); // IR_FUNC_END
+            for(int b = 0; b < (int)result.size(); b++) {
+                const Instr &last = ir->code[result[b].last];
+                auto target = [&](Operand label) {
+                    int at = labelAt[label.id];
+                    return at > begin && at < end ? blockOf[at] : exit;
+                };
+                if(last.op == IR_JUMP || last.op == IR_RETURN) result[b].successors.push_back(last.op == IR_RETURN ? exit : target(last.c));
+                else {
+                    if(conditional(last.op)) result[b].successors.push_back(target(last.c));
+                    result[b].successors.push_back(b + 1);
+                }
+            }
+            return result;
+        }
+
+        void unreachable(int begin, int end) {
+            vector<int> blockOf(end + 1, -1);
+            vector<Block> cfg = blocks(begin, end, blockOf);
+            if(cfg.empty()) return;
+            vector<bool> reached(cfg.size() + 1, false);
+            vector<int> work{0};
+            reached[0] = true;
+            while(!work.empty()) {
+                int b = work.back();
+                work.pop_back();
+                if(b == (int)cfg.size()) continue;
+                for(int next : cfg[b].successors) {
+                    if(reached[next]) continue;
+                    reached[next] = true;
+                    work.push_back(next);
+                }
+            }
+            for(int b = 0; b < (int)cfg.size(); b++) {
+                if(reached[b]) continue;
+                for(int i = cfg[b].first; i <= cfg[b].last; i++) {
+                    if(ir->code[i].op != IR_NOTE) dead[i] = true;
+                }
+            }
+        }
+
+        void redundantJumps() {
+            int length = ir->code.size();
+            for(int i = 0; i < length; i++) {
+                Opcode op = ir->code[i].op;
+                if(dead[i] || (op != IR_JUMP && !conditional(op))) continue;
+                int k = i + 1;
+                while(k < length && (dead[k] || ir->code[k].op == IR_NOTE)) k++;
+                if(k < length && ir->code[k].op == IR_LABEL && ir->code[k].c == ir->code[i].c) dead[i] = true;
+            }
+        }
+
+        void unnamedLabels() {
+            int length = ir->code.size();
+            vector<bool> named(ir->labels.size(), false);
+            for(int i = 0; i < length; i++) {
+                const Instr &instr = ir->code[i];
+                if(!dead[i] && instr.op != IR_LABEL && instr.c.kind == OPERAND_LABEL) named[instr.c.id] = true;
+            }
+            for(int i = 0; i < length; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_LABEL && !named[instr.c.id]) dead[i] = true;
+            }
+        }
+
+        // the instruction only makes its temporary; / and % by a temporary may fault
+        static bool valueOnly(const Instr &instr) {
+            switch(instr.op) {
+                case IR_CONST: case IR_UNKNOWN: case IR_LOAD: case IR_ELEMENT: case IR_COPY:
+                case IR_NEG: case IR_ADD: case IR_SUB: case IR_MUL: case IR_RELATION: case IR_SET:
+                    return true;
+                case IR_DIV: case IR_MOD:
+                    return instr.b.kind == OPERAND_CONST;
+                default:
+                    return false;
+            }
+        }
+
+        void unreadValues() {
+            int length = ir->code.size();
+            vector<int> reads(ir->temps.size(), 0);
+            for(int i = 0; i < length; i++) {
+                if(dead[i]) continue;
+                const Instr &instr = ir->code[i];
+                if(instr.a.kind == OPERAND_TEMP) reads[instr.a.id]++;
+                if(instr.b.kind == OPERAND_TEMP) reads[instr.b.id]++;
+            }
+            // backwards, so a value read only by a removed one goes in the same pass
+            for(int i = length - 1; i >= 0; i--) {
+                const Instr &instr = ir->code[i];
+                if(dead[i] || instr.dst.kind != OPERAND_TEMP || reads[instr.dst.id] > 0 || !valueOnly(instr)) continue;
+                dead[i] = true;
+                if(instr.a.kind == OPERAND_TEMP) reads[instr.a.id]--;
+                if(instr.b.kind == OPERAND_TEMP) reads[instr.b.id]--;
+            }
+        }
+
+        bool compact() {
+            int kept = 0, gone = 0;
+            Atom function = NO_ATOM;
+            for(int i = 0; i < (int)ir->code.size(); i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_FUNC_BEGIN) {
+                    function = instr.a.id;
+                    if(!removedIn.count(function)) {
+                        functions.push_back(function);
+                        removedIn[function] = 0;
+                    }
+                }
+                if(dead[i]) {
+                    gone++;
+                    if(function != NO_ATOM) removedIn[function]++;
+                    continue;
+                }
+                ir->code[kept++] = ir->code[i];
+            }
+            ir->code.resize(kept);
+            removed += gone;
+            return gone > 0;
+        }
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "2105120_IR.hpp"
+
+using namespace std;
+
+// Frame layout over the three-address code (-O1).
+// Without it every declaration of a local moves sp down where it stands, once per run of
+// it, so the blocks of a function take their own room one after the other, and a block in
+// a loop takes it again in every iteration. The offsets of the locals are already shared:
+// a block gives its words back to the next one (2105120_IRBuilder.hpp). So the frame is
+// as deep as the deepest local, and one declaration at the start of the function reserves
+// it all, behind the label a call of the function itself jumps to (2105120_TailCalls.hpp),
+// which gives the locals up first. A function other than main with no locals, no parameters and no calls does
+// not set bp up at all.
+class FrameLayout {
+    public:
+        vector<pair<string, pair<int, int>>> frames; // each function, its bytes of locals before and after
+        int before = 0, after = 0; // all the functions
+        int frameless = 0; // functions without bp
+
+        void layOut(IRProgram &program) {
+            ir = &program;
+            vector<Instr> code;
+            code.reserve(ir->code.size());
+            for(int begin = 0; begin < (int)ir->code.size(); begin++) {
+                if(ir->code[begin].op != IR_FUNC_BEGIN) {
+                    code.push_back(ir->code[begin]);
+                    continue;
+                }
+                int end = begin;
+                while(ir->code[end].op != IR_FUNC_END) end++;
+                Atom function = ir->code[begin].a.id;
+                int declared = 0, deepest = 0;
+                bool calls = false;
+                Operand top; // the label the calls of the function itself jump to
+                for(int i = begin; i < end; i++) {
+                    const Instr &instr = ir->code[i];
+                    if(instr.op == IR_DECLARE) declared += instr.imm < 0 ? 2 : 2 * instr.imm;
+                    else if(instr.op == IR_CALL) {
+                        calls = true;
+                        if(instr.c.kind == OPERAND_LABEL) top = instr.c;
+                    }
+                    for(const Operand *operand : {&instr.a, &instr.b}) {
+                        if(operand->kind != OPERAND_VAR) continue;
+                        const Variable &var = ir->variables[operand->id];
+                        if(var.storage == STORAGE_LOCAL) deepest = max(deepest, var.offset);
+                    }
+                }
+                int start = begin + 1;
+                if(top.kind == OPERAND_LABEL && ir->code[start].op == IR_LABEL && ir->code[start].c == top) start++;
+                for(int i = begin; i <= end; i++) {
+                    Instr instr = ir->code[i];
+                    if(i == start && deepest > 0) {
+                        Instr frame{IR_DECLARE};
+                        frame.a = ir->variable(function, STORAGE_LOCAL, deepest);
+                        frame.imm = deepest / 2;
+                        frame.line = ir->code[begin].line;
+                        code.push_back(frame);
+                    }
+                    if(instr.op == IR_DECLARE) continue;
+                    if(instr.op == IR_FUNC_BEGIN && deepest == 0 && !calls && ir->code[end].imm == 0 && atoms.name(function) != "main") {
+                        instr.note = 1;
+                        frameless++;
+                    }
+                    code.push_back(instr);
+                }
+                frames.push_back({atoms.name(function), {declared, deepest}});
+                before += declared;
+                after += deepest;
+                begin = end;
+            }
+            ir->code = move(code);
+        }
+
+    private:
+        IRProgram *ir = nullptr;
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <cstdlib>
+#include <ostream>
+#include <unordered_map>
+#include "2105120_AST.hpp"
+#include "2105120_Atom.hpp"
+
+using namespace std;
+
+// Three-address code between the AST and the 8086 code (--ast).
+// A program is one array of instructions, functions are the ranges between IR_FUNC_BEGIN
+// and IR_FUNC_END. An instruction names its operands by handles, small integers into the
+// tables of the program (temporaries, variables, constants, labels) or atoms for function
+// names, so it holds no strings and passes over the code only touch the array.
+// Instructions that only exist to keep the generated code as it was (IR_NOTE, the line
+// numbers of comments, the note of a jump) change nothing in what the code computes.
+
+enum Opcode : unsigned char {
+    IR_FUNC_BEGIN,   // a: function, c: its end label; note: 1 for a function without bp
+    IR_FUNC_END,     // a: function, c: its end label, placed when note is 1; imm: bytes of parameters
+    IR_DECLARE,      // a: variable; imm: its length, -1 for a plain variable
+    IR_NOTE,         // note: the statement starting here (StatementNote)
+    IR_CONST,        // dst = a (constant)
+    IR_UNKNOWN,      // dst = a value with no code: a float constant, or an expression the parser dropped
+    IR_LOAD,         // dst = a (variable, or the address of an element)
+    IR_STORE,        // a (variable, or the address of an element) = b
+    IR_ELEMENT,      // dst = address of a[b]
+    IR_POST_INC,     // dst = a, a = a + 1
+    IR_POST_DEC,     // dst = a, a = a - 1
+    IR_COPY,         // dst = a: unary + and !, which have no code of their own
+    IR_NEG,          // dst = -a
+    IR_ADD, IR_SUB, IR_MUL, IR_DIV, IR_MOD, // dst = a op b
+    IR_RELATION,     // dst = 1 if a imm b, else 0, imm is a relational Operator
+    IR_SET,          // dst = a (constant), the result of a condition; note: SetNote
+    IR_LABEL,        // c:
+    IR_JUMP,         // goto c; note: JumpNote
+    IR_JUMP_ZERO,    // if a == 0 goto c
+    IR_JUMP_NONZERO, // if a != 0 goto c
+    IR_JUMP_UNLESS,  // if !(a imm b) goto c, imm is a relational Operator
+    IR_ARG,          // a is the next argument of a call
+    IR_CALL,         // dst = a(arguments), a: function; imm: number of arguments, the IR_ARGs before it;
+                     // c: for a tail call, the label at the top of the function itself or the function jumped to
+    IR_RETURN,       // return a, by jumping to c, the end label of the function
+    IR_PRINT         // println(a)
+};
+
+enum OperandKind : unsigned char {
+    OPERAND_NONE,     // also a variable that was never declared
+    OPERAND_TEMP,
+    OPERAND_CONST,
+    OPERAND_VAR,
+    OPERAND_LABEL,
+    OPERAND_FUNCTION  // id is the atom of the name
+};
+
+struct Operand {
+    OperandKind kind = OPERAND_NONE;
+    int id = -1;
+
+    bool operator==(const Operand &other) const { return kind == other.kind && id == other.id; }
+    bool operator!=(const Operand &other) const { return !(*this == other); }
+};
+
+enum StatementNote : unsigned char {
+    NOTE_VAR_DECL, NOTE_FOR, NOTE_IF, NOTE_ELSE, NOTE_WHILE, NOTE_PRINT, NOTE_RETURN
+};
+
+enum JumpNote : unsigned char {
+    JUMP_PLAIN, JUMP_TO_END, JUMP_TO_TRUE, JUMP_TO_FALSE, JUMP_TO_STATEMENT, JUMP_TO_CONDITION, JUMP_TO_INCREMENT
+};
+
+enum SetNote : unsigned char {
+    SET_PLAIN, SET_RELATION_TRUE, SET_RELATION_FALSE
+};
+
+struct Instr {
+    Opcode op = IR_NOTE;
+    unsigned char note = 0;
+    int line = 0;
+    Operand dst = {}, a = {}, b = {}, c = {};
+    int imm = 0;
+};
+
+enum TempType : unsigned char {
+    TEMP_WORD,    // a 16 bit value
+    TEMP_ADDRESS  // the address of an array element
+};
+
+enum Storage : unsigned char {
+    STORAGE_GLOBAL, // in the data segment, by name
+    STORAGE_LOCAL,  // at [bp - offset]
+    STORAGE_PARAM   // at [bp + offset]
+};
+
+struct Variable {
+    Atom name;
+    Storage storage;
+    int offset;
+    int length; // -1 for a plain variable, as first declared
+};
+
+struct ConstantValue {
+    Atom text; // as written in the source, NO_ATOM for a value computed by the compiler
+    int value; // 16 bit, as the code sees it
+};
+
+struct Label {
+    int number;    // Ln, or -1 for the end label of a function
+    Atom function; // L<function>end
+};
+
+struct IRProgram {
+    vector<Instr> code;
+    vector<TempType> temps;
+    vector<Variable> variables;
+    vector<ConstantValue> constants;
+    vector<Label> labels;
+
+    map<tuple<Atom, int, int>, int> variableIds; // name, storage, offset
+    unordered_map<Atom, int> constantIds;
+    unordered_map<int, int> valueIds;
+
+    Instr &emit(Opcode op, int line = 0) {
+        code.push_back(Instr{op});
+        code.back().line = line;
+        return code.back();
+    }
+
+    Operand newTemp(TempType type = TEMP_WORD) {
+        temps.push_back(type);
+        return Operand{OPERAND_TEMP, int(temps.size()) - 1};
+    }
+
+    Operand newLabel(int number, Atom function = NO_ATOM) {
+        labels.push_back(Label{number, function});
+        return Operand{OPERAND_LABEL, int(labels.size()) - 1};
+    }
+
+    // one handle for every place in memory, however often it is named
+    Operand variable(Atom name, Storage storage, int offset, int length = -1) {
+        tuple<Atom, int, int> key(name, storage, offset);
+        map<tuple<Atom, int, int>, int>::iterator it = variableIds.find(key);
+        if(it != variableIds.end()) return Operand{OPERAND_VAR, it->second};
+        variables.push_back(Variable{name, storage, offset, length});
+        variableIds.emplace(key, int(variables.size()) - 1);
+        return Operand{OPERAND_VAR, int(variables.size()) - 1};
+    }
+
+    Operand constant(Atom text) {
+        unordered_map<Atom, int>::iterator it = constantIds.find(text);
+        if(it != constantIds.end()) return Operand{OPERAND_CONST, it->second};
+        int value = (short)strtoll(atoms.name(text).c_str(), nullptr, 10);
+        constants.push_back(ConstantValue{text, value});
+        constantIds.emplace(text, int(constants.size()) - 1);
+        return Operand{OPERAND_CONST, int(constants.size()) - 1};
+    }
+
+    Operand constantValue(int value) {
+        value = (short)value;
+        unordered_map<int, int>::iterator it = valueIds.find(value);
+        if(it != valueIds.end()) return Operand{OPERAND_CONST, it->second};
+        constants.push_back(ConstantValue{NO_ATOM, value});
+        valueIds.emplace(value, int(constants.size()) - 1);
+        return Operand{OPERAND_CONST, int(constants.size()) - 1};
+    }
+};
+
+// the relation with its operands swapped: a < b is b > a
+inline Operator mirrored(Operator op) {
+    switch(op) {
+        case OP_LT: return OP_GT;
+        case OP_LE: return OP_GE;
+        case OP_GT: return OP_LT;
+        case OP_GE: return OP_LE;
+        default: return op;
+    }
+}
+
+// a < b is false when a >= b
+inline Operator negated(Operator op) {
+    switch(op) {
+        case OP_LT: return OP_GE;
+        case OP_LE: return OP_GT;
+        case OP_GT: return OP_LE;
+        case OP_GE: return OP_LT;
+        case OP_EQ: return OP_NE;
+        default: return OP_EQ;
+    }
+}
+
+// the relational operator holds for the signed values
+inline bool holds(Operator op, int a, int b) {
+    switch(op) {
+        case OP_LT: return a < b;
+        case OP_LE: return a <= b;
+        case OP_GT: return a > b;
+        case OP_GE: return a >= b;
+        case OP_EQ: return a == b;
+        default: return a != b;
+    }
+}
+
+inline string constantText(const IRProgram &program, int id) {
+    const ConstantValue &constant = program.constants[id];
+    if(constant.text != NO_ATOM) return atoms.name(constant.text);
+    return to_string(constant.value);
+}
+
+inline string labelText(const IRProgram &program, int id) {
+    const Label &label = program.labels[id];
+    if(label.number < 0) return "L" + atoms.name(label.function) + "end";
+    return "L" + to_string(label.number);
+}
+
+// the IR as text, one instruction per line, for --dump-ir
+inline void printIR(ostream &out, const IRProgram &program) {
+    static const char *names[] = {
+        "func", "endfunc", "declare", "note", "const", "unknown", "load", "store", "element",
+        "postinc", "postdec", "copy", "neg", "add", "sub", "mul", "div", "mod", "relation",
+        "set", "label",
+        "jump", "jz", "jnz", "jump unless", "arg", "call", "return", "print"
+    };
+    auto text = [&](const Operand &operand) -> string {
+        switch(operand.kind) {
+            case OPERAND_TEMP: return "t" + to_string(operand.id);
+            case OPERAND_CONST: return constantText(program, operand.id);
+            case OPERAND_VAR: {
+                const Variable &var = program.variables[operand.id];
+                if(var.storage == STORAGE_GLOBAL) return atoms.name(var.name);
+                return atoms.name(var.name) + (var.storage == STORAGE_LOCAL ? "@-" : "@+") + to_string(var.offset);
+            }
+            case OPERAND_LABEL: return labelText(program, operand.id);
+            case OPERAND_FUNCTION: return atoms.name(operand.id);
+            default: return "_";
+        }
+    };
+    for(const Instr &instr : program.code) {
+        if(instr.op == IR_LABEL) {
+            out << text(instr.c) << ":\n";
+            continue;
+        }
+        out << "\t";
+        if(instr.dst.kind != OPERAND_NONE) out << text(instr.dst) << " = ";
+        out << names[instr.op];
+        if(instr.op == IR_JUMP_UNLESS || instr.op == IR_RELATION) out << " " << text(instr.a) << " " << operatorText(Operator(instr.imm)) << " " << text(instr.b);
+        else {
+            if(instr.a.kind != OPERAND_NONE) out << " " << text(instr.a);
+            if(instr.b.kind != OPERAND_NONE) out << ", " << text(instr.b);
+        }
+        if(instr.c.kind != OPERAND_NONE) out << " -> " << text(instr.c);
+        if(instr.line > 0) out << "\t; line " << instr.line;
+        out << "\n";
+    }
+}
@@ -0,0 +1,758 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "2105120_AST.hpp"
+#include "2105120_IR.hpp"
+#include "2105120_AsmWriter.hpp"
+
+using namespace std;
+
+// Lowers the AST to three-address code (--ast).
+// The instructions come in the order the actions of C8086Parser.g4 write code while
+// parsing, and labels are numbered in the order the actions take them, so selecting
+// instructions for the IR as it is gives the code of the actions again. Every expression
+// gets a temporary of its own; names are looked up in the symbol table here, so the IR
+// refers to places in memory and not to names.
+// With orderByNeed (-O1) the operand of a binary operator that needs more registers is
+// lowered first (Sethi-Ullman order), when neither side has side effects; the operands keep
+// their places in the instruction, so - / % need no swapping back.
+// With jumping (-O1) a condition of if, while and for, and an operand of && and ||, is
+// lowered to jumps to where it goes when true or false; a relational operator only makes
+// its 0 or 1 where its value is used. Loops then test their condition at the top and
+// fall into the body.
+// With branchless (-O1) that 0 or 1 is one IR_RELATION, which the selector makes without
+// the jumps where that is faster.
+// With rotate (-O1) a loop lowered to jumps tests its condition once in front, to skip
+// the loop, and again at the bottom, where it jumps back to the body while it holds: one
+// conditional jump per iteration in place of a test at the top and a jmp back to it.
+// With an unrollBudget (-O1) a for loop counting a local or parameter from a constant by a
+// constant step while it compares to a constant, with a body that neither writes it nor
+// declares anything, runs a number of times known here:
+//  - when its body fits the budget that many times, it is copied that many times, with
+//    no test, no jump and no step; the counter is stored before a copy that reads it,
+//    as a constant the folder then puts in place of its loads, and once after the last
+//  - otherwise, when two or more copies and the iterations left over fit, the left over
+//    ones are copied in front and the loop runs that many copies per test
+// The budget counts the nodes of the AST copied, an unrolled loop inside as unrolled.
+class IRBuilder {
+    public:
+        int unrolled = 0;          // loops copied out in full
+        int partiallyUnrolled = 0; // loops running several copies per test
+
+        explicit IRBuilder(bool orderByNeed = false, bool jumping = false, bool branchless = false, bool rotate = false, int unrollBudget = 0)
+            : orderByNeed(orderByNeed), jumping(jumping), branchless(branchless), rotate(rotate), unrollBudget(unrollBudget) {}
+
+        IRProgram build(const Program &program) {
+            ir = IRProgram();
+            shapes.clear();
+            for(Node *unit : program.units) {
+                if(unit == nullptr) continue; // a unit the parser could not recover
+                if(unit->kind == NODE_VAR_DECL) varDeclaration(static_cast<VarDecl *>(unit));
+                else if(unit->kind == NODE_FUNC_DEF) funcDefinition(static_cast<Function *>(unit));
+                // a function declaration has no code
+            }
+            return std::move(ir);
+        }
+
+    private:
+        struct Shape {
+            int need; // registers the expression needs
+            bool pure; // no call, assignment or increment
+        };
+
+        bool orderByNeed;
+        bool jumping;
+        bool branchless;
+        bool rotate;
+        int unrollBudget;
+        unordered_map<const Expr *, Shape> shapes;
+        IRProgram ir;
+        Operand functionEnd; // end label of the function being lowered
+        bool returnPresent = false;
+
+        Operand newLabel() {
+            return ir.newLabel(label_count++);
+        }
+
+        void label(Operand label) {
+            ir.emit(IR_LABEL).c = label;
+        }
+
+        void jump(Opcode op, Operand value, Operand target, JumpNote note) {
+            Instr &instr = ir.emit(op);
+            instr.a = value;
+            instr.c = target;
+            instr.note = note;
+        }
+
+        void note(StatementNote kind, int line) {
+            ir.emit(IR_NOTE, line).note = kind;
+        }
+
+        void funcDefinition(Function *function) {
+            Operand name{OPERAND_FUNCTION, function->name};
+            functionEnd = ir.newLabel(-1, function->name);
+            Instr &begin = ir.emit(IR_FUNC_BEGIN, function->line);
+            begin.a = name;
+            begin.c = functionEnd;
+            symbolTable.enterScope();
+
+            // a nameless parameter drops the names before it
+            vector<Atom> paramNames;
+            for(Param &param : function->params) {
+                if(param.name == NO_ATOM) paramNames.clear();
+                else paramNames.push_back(param.name);
+            }
+            int paramSize = paramNames.size();
+            for(int i = 0; i < paramSize; i++) {
+                symbolTable.insert(atoms.name(paramNames[i]), "param", 4 + (paramSize - i - 1) * 2);
+            }
+
+            compoundStatement(function->body);
+            Instr &end = ir.emit(IR_FUNC_END);
+            end.a = name;
+            end.c = functionEnd;
+            end.imm = paramSize * 2;
+            end.note = returnPresent;
+            returnPresent = false;
+            localVarCount -= symbolTable.countLocalVarInCurrentScope();
+            symbolTable.exitScope();
+        }
+
+        void compoundStatement(Compound *compound) {
+            if(compound == nullptr) return;
+            symbolTable.enterScope();
+            for(Stmt *statement : compound->statements) generateStatement(statement, Operand());
+            localVarCount -= symbolTable.countLocalVarInCurrentScope();
+            symbolTable.exitScope();
+        }
+
+        // as declareVariable and declareArray do; a name declared twice in a scope keeps
+        // its first place but still takes a new one
+        void varDeclaration(VarDecl *declaration) {
+            note(NOTE_VAR_DECL, declaration->line);
+            for(Declarator &declarator : declaration->declarators) {
+                const string &name = atoms.name(declarator.name);
+                int size = declarator.arraySize < 0 ? 1 : declarator.arraySize;
+                Operand var;
+                if(symbolTable.getCurrentScopeId() == "1") { // global scope
+                    symbolTable.insert(name, "global");
+                    var = ir.variable(declarator.name, STORAGE_GLOBAL, 0, declarator.arraySize);
+                }
+                else {
+                    localVarCount += size;
+                    if(declarator.arraySize < 0) symbolTable.insert(name, "local", localVarCount * 2);
+                    else symbolTable.insert(name, "local", localVarCount * 2, size);
+                    var = ir.variable(declarator.name, STORAGE_LOCAL, localVarCount * 2, declarator.arraySize);
+                }
+                Instr &declare = ir.emit(IR_DECLARE);
+                declare.a = var;
+                declare.imm = declarator.arraySize;
+            }
+        }
+
+        // endLabelInherited: the label an enclosing if jumps to, an if directly inside
+        // another one (or inside its else) ends at the same place and reuses it
+        void generateStatement(Stmt *statement, Operand endLabelInherited) {
+            if(statement == nullptr) return;
+            switch(statement->kind) {
+                case NODE_VAR_DECL:
+                    varDeclaration(static_cast<VarDecl *>(statement));
+                    break;
+                case NODE_EXPR_STMT: {
+                    Expr *expr = static_cast<ExprStmt *>(statement)->expr;
+                    if(expr != nullptr) value(expr);
+                    break;
+                }
+                case NODE_COMPOUND:
+                    compoundStatement(static_cast<Compound *>(statement));
+                    break;
+                case NODE_FOR:
+                    forStatement(static_cast<For *>(statement));
+                    break;
+                case NODE_IF:
+                    ifStatement(static_cast<If *>(statement), endLabelInherited);
+                    break;
+                case NODE_WHILE:
+                    whileStatement(static_cast<While *>(statement));
+                    break;
+                case NODE_PRINTLN:
+                    note(NOTE_PRINT, statement->line);
+                    ir.emit(IR_PRINT).a = lookup(static_cast<Println *>(statement)->name);
+                    break;
+                case NODE_RETURN: {
+                    note(NOTE_RETURN, statement->line);
+                    Operand result = value(static_cast<Return *>(statement)->value);
+                    returnPresent = true;
+                    jump(IR_RETURN, result, functionEnd, JUMP_PLAIN);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        void forStatement(For *loop) {
+            note(NOTE_FOR, loop->line);
+            if(loop->init != nullptr) value(loop->init);
+            if(jumping && unrollBudget > 0 && unroll(loop)) return;
+            if(jumping && rotate) {
+                Operand bodyLabel = newLabel();
+                Operand endLabel = newLabel();
+                branch(loop->condition, false, endLabel, JUMP_TO_END);
+                label(bodyLabel);
+                generateStatement(loop->body, Operand());
+                if(loop->step != nullptr) value(loop->step);
+                branch(loop->condition, true, bodyLabel, JUMP_TO_STATEMENT);
+                label(endLabel);
+                return;
+            }
+            if(jumping) {
+                Operand conditionLabel = newLabel();
+                Operand endLabel = newLabel();
+                label(conditionLabel);
+                branch(loop->condition, false, endLabel, JUMP_TO_END);
+                generateStatement(loop->body, Operand());
+                if(loop->step != nullptr) value(loop->step);
+                jump(IR_JUMP, Operand(), conditionLabel, JUMP_TO_CONDITION);
+                label(endLabel);
+                return;
+            }
+            Operand conditionLabel = newLabel();
+            Operand endLabel = newLabel();
+            Operand statementLabel = newLabel();
+            Operand incrementLabel = newLabel();
+            label(conditionLabel);
+            Operand condition = value(loop->condition);
+            jump(IR_JUMP_ZERO, condition, endLabel, JUMP_TO_END);
+            jump(IR_JUMP_NONZERO, condition, statementLabel, JUMP_TO_STATEMENT);
+            label(incrementLabel);
+            if(loop->step != nullptr) value(loop->step);
+            jump(IR_JUMP, Operand(), conditionLabel, JUMP_TO_CONDITION);
+            label(statementLabel);
+            generateStatement(loop->body, Operand());
+            jump(IR_JUMP, Operand(), incrementLabel, JUMP_TO_INCREMENT);
+            label(endLabel);
+        }
+
+        struct CountedLoop {
+            Atom counter;
+            int first, step, trips;
+            int size; // AST nodes of the body and the step, as lowered
+            bool read; // the body reads the counter
+        };
+
+        static bool constantOf(const Expr *expr, int &result) {
+            bool negative = false;
+            while(expr != nullptr && expr->kind == NODE_UNARY && static_cast<const Unary *>(expr)->op != OP_NOT) {
+                negative = negative != (static_cast<const Unary *>(expr)->op == OP_NEG);
+                expr = static_cast<const Unary *>(expr)->operand;
+            }
+            if(expr == nullptr || expr->kind != NODE_CONST_INT) return false;
+            result = (short)strtoll(atoms.name(static_cast<const Constant *>(expr)->text).c_str(), nullptr, 10);
+            if(negative) result = (short)-result;
+            return true;
+        }
+
+        static bool isCounter(const Expr *expr, Atom counter) {
+            if(expr == nullptr || expr->kind != NODE_LOAD) return false;
+            const VarRef *var = static_cast<const VarAccess *>(expr)->var;
+            return var->name == counter && var->index == nullptr;
+        }
+
+        // the constant step of i++, i--, i = i + c, i = c + i or i = i - c
+        static bool stepOf(const Expr *step, Atom counter, int &result) {
+            if(step == nullptr) return false;
+            if(step->kind == NODE_POST_INC || step->kind == NODE_POST_DEC) {
+                const VarRef *var = static_cast<const VarAccess *>(step)->var;
+                result = step->kind == NODE_POST_INC ? 1 : -1;
+                return var->name == counter && var->index == nullptr;
+            }
+            if(step->kind != NODE_ASSIGN) return false;
+            const Assign *assign = static_cast<const Assign *>(step);
+            if(assign->target->name != counter || assign->target->index != nullptr || assign->value->kind != NODE_BINARY) return false;
+            const Binary *binary = static_cast<const Binary *>(assign->value);
+            if(binary->op == OP_ADD && isCounter(binary->right, counter) && constantOf(binary->left, result)) return true;
+            if(binary->op != OP_ADD && binary->op != OP_SUB) return false;
+            if(!isCounter(binary->left, counter) || !constantOf(binary->right, result)) return false;
+            if(binary->op == OP_SUB) result = (short)-result;
+            return true;
+        }
+
+        // AST nodes of an expression; reads and writes of the counter
+        int measure(const Expr *expr, Atom counter, bool &reads, bool &writes) {
+            if(expr == nullptr) return 0;
+            switch(expr->kind) {
+                case NODE_ASSIGN: {
+                    const Assign *assign = static_cast<const Assign *>(expr);
+                    if(assign->target->name == counter) {
+                        if(assign->target->index == nullptr) writes = true;
+                        else reads = true; // an array of the same name can not be declared here
+                    }
+                    return 1 + measure(assign->target->index, counter, reads, writes) + measure(assign->value, counter, reads, writes);
+                }
+                case NODE_BINARY: {
+                    const Binary *binary = static_cast<const Binary *>(expr);
+                    return 1 + measure(binary->left, counter, reads, writes) + measure(binary->right, counter, reads, writes);
+                }
+                case NODE_UNARY:
+                    return 1 + measure(static_cast<const Unary *>(expr)->operand, counter, reads, writes);
+                case NODE_CALL: {
+                    int size = 1;
+                    for(Expr *argument : static_cast<const Call *>(expr)->arguments) size += measure(argument, counter, reads, writes);
+                    return size;
+                }
+                case NODE_LOAD:
+                case NODE_POST_INC:
+                case NODE_POST_DEC: {
+                    const VarRef *var = static_cast<const VarAccess *>(expr)->var;
+                    if(var->name == counter) {
+                        reads = true;
+                        if(expr->kind != NODE_LOAD && var->index == nullptr) writes = true;
+                    }
+                    return 1 + measure(var->index, counter, reads, writes);
+                }
+                default:
+                    return 1;
+            }
+        }
+
+        // AST nodes of a statement as lowered, -1 when it declares a variable
+        int measure(const Stmt *statement, Atom counter, bool &reads, bool &writes) {
+            if(statement == nullptr) return 0;
+            auto add = [](int &size, int part) {
+                if(size < 0 || part < 0) size = -1;
+                else size += part;
+            };
+            int size = 1;
+            switch(statement->kind) {
+                case NODE_VAR_DECL:
+                    return -1;
+                case NODE_EXPR_STMT:
+                    add(size, measure(static_cast<const ExprStmt *>(statement)->expr, counter, reads, writes));
+                    break;
+                case NODE_COMPOUND:
+                    for(Stmt *inner : static_cast<const Compound *>(statement)->statements) add(size, measure(inner, counter, reads, writes));
+                    break;
+                case NODE_FOR: {
+                    const For *loop = static_cast<const For *>(statement);
+                    add(size, measure(loop->init, counter, reads, writes));
+                    bool innerReads = false, innerWrites = false;
+                    int whole = measure(loop->condition, counter, innerReads, innerWrites) + measure(loop->step, counter, innerReads, innerWrites);
+                    int body = measure(loop->body, counter, innerReads, innerWrites);
+                    reads = reads || innerReads;
+                    writes = writes || innerWrites;
+                    CountedLoop counted;
+                    if(body >= 0 && counts(loop, counted)) add(size, lowered(counted));
+                    else add(size, body < 0 ? -1 : whole + body);
+                    break;
+                }
+                case NODE_IF: {
+                    const If *branch = static_cast<const If *>(statement);
+                    add(size, measure(branch->condition, counter, reads, writes));
+                    add(size, measure(branch->thenBody, counter, reads, writes));
+                    add(size, measure(branch->elseBody, counter, reads, writes));
+                    break;
+                }
+                case NODE_WHILE: {
+                    const While *loop = static_cast<const While *>(statement);
+                    add(size, measure(loop->condition, counter, reads, writes));
+                    add(size, measure(loop->body, counter, reads, writes));
+                    break;
+                }
+                case NODE_PRINTLN:
+                    if(static_cast<const Println *>(statement)->name == counter) reads = true;
+                    break;
+                case NODE_RETURN:
+                    add(size, measure(static_cast<const Return *>(statement)->value, counter, reads, writes));
+                    break;
+                default:
+                    break;
+            }
+            return size;
+        }
+
+        // the for loop runs a number of times known here
+        bool counts(const For *loop, CountedLoop &counted) {
+            if(loop->init == nullptr || loop->init->kind != NODE_ASSIGN) return false;
+            const Assign *init = static_cast<const Assign *>(loop->init);
+            if(init->target->index != nullptr || !constantOf(init->value, counted.first)) return false;
+            counted.counter = init->target->name;
+            Operand var = lookup(counted.counter);
+            if(var.kind != OPERAND_VAR || ir.variables[var.id].storage == STORAGE_GLOBAL || ir.variables[var.id].length >= 0) return false;
+
+            if(loop->condition == nullptr || loop->condition->kind != NODE_BINARY) return false;
+            const Binary *condition = static_cast<const Binary *>(loop->condition);
+            int bound;
+            if(!relational(condition->op) || !isCounter(condition->left, counted.counter) || !constantOf(condition->right, bound)) return false;
+            if(!stepOf(loop->step, counted.counter, counted.step) || counted.step == 0) return false;
+
+            bool reads = false, writes = false;
+            counted.size = measure(loop->body, counted.counter, reads, writes);
+            if(counted.size < 0 || writes) return false;
+            counted.read = reads;
+            counted.size += measure(loop->step, counted.counter, reads, writes);
+
+            // run it: the comparison is signed and the counter wraps around like a register
+            counted.trips = 0;
+            for(short i = counted.first; holds(condition->op, i, bound); i += counted.step) {
+                if(++counted.trips > 0xFFFF) return false; // it never stops
+            }
+            return true;
+        }
+
+        // copies of the body per test, all of them when it is copied out in full, -1 when the
+        // loop is not unrolled; leftOver: how many more go in front
+        int unrollFactor(const CountedLoop &counted, int &leftOver) const {
+            leftOver = 0;
+            if(counted.trips * counted.size <= unrollBudget) return counted.trips;
+            for(int factor = min(counted.trips / 2, 8); factor >= 2; factor--) {
+                leftOver = counted.trips % factor;
+                if((factor + leftOver) * counted.size <= unrollBudget) return factor;
+            }
+            leftOver = 0;
+            return -1;
+        }
+
+        // AST nodes of the loop as it is lowered, with the test
+        int lowered(const CountedLoop &counted) const {
+            int leftOver, factor = unrollFactor(counted, leftOver);
+            if(factor == counted.trips) return counted.trips * counted.size;
+            return (max(factor, 1) + leftOver) * counted.size + 3;
+        }
+
+        // the counter takes the value it has before the k-th iteration
+        void setCounter(const CountedLoop &counted, int k, int line) {
+            Instr &store = ir.emit(IR_STORE, line);
+            store.a = lookup(counted.counter);
+            store.b = ir.constantValue(counted.first + k * counted.step);
+        }
+
+        // a counted for loop, its initialization lowered already, in copies of its body
+        bool unroll(For *loop) {
+            CountedLoop counted;
+            if(!counts(loop, counted)) return false;
+            int leftOver, factor = unrollFactor(counted, leftOver);
+            if(factor < 0) return false;
+            bool full = factor == counted.trips;
+            int front = full ? counted.trips : leftOver;
+            for(int k = 0; k < front; k++) {
+                if(k > 0 && counted.read) setCounter(counted, k, loop->line);
+                generateStatement(loop->body, Operand());
+            }
+            if(front > 0) setCounter(counted, front, loop->line);
+            if(full) {
+                unrolled++;
+                return true;
+            }
+            Operand bodyLabel = newLabel();
+            label(bodyLabel);
+            for(int k = 0; k < factor; k++) {
+                generateStatement(loop->body, Operand());
+                value(loop->step);
+            }
+            branch(loop->condition, true, bodyLabel, JUMP_TO_STATEMENT);
+            partiallyUnrolled++;
+            return true;
+        }
+
+        void ifStatement(If *branch, Operand endLabelInherited) {
+            bool inherited = endLabelInherited.kind == OPERAND_LABEL;
+            note(NOTE_IF, branch->line);
+            Operand condition;
+            if(!jumping) condition = value(branch->condition);
+            if(branch->elseBody == nullptr) {
+                Operand falseLabel = inherited ? endLabelInherited : newLabel();
+                test(branch->condition, condition, falseLabel);
+                generateStatement(branch->thenBody, falseLabel);
+                if(!inherited) label(falseLabel);
+                return;
+            }
+            Operand falseLabel = newLabel();
+            Operand endLabel = inherited ? endLabelInherited : newLabel();
+            test(branch->condition, condition, falseLabel);
+            generateStatement(branch->thenBody, Operand());
+            jump(IR_JUMP, Operand(), endLabel, JUMP_TO_END);
+            label(falseLabel);
+            note(NOTE_ELSE, branch->elseLine);
+            generateStatement(branch->elseBody, endLabel);
+            if(!inherited) label(endLabel);
+        }
+
+        void whileStatement(While *loop) {
+            note(NOTE_WHILE, loop->line);
+            if(jumping && rotate) {
+                Operand bodyLabel = newLabel();
+                Operand endLabel = newLabel();
+                branch(loop->condition, false, endLabel, JUMP_TO_END);
+                label(bodyLabel);
+                generateStatement(loop->body, Operand());
+                branch(loop->condition, true, bodyLabel, JUMP_TO_STATEMENT);
+                label(endLabel);
+                return;
+            }
+            Operand conditionLabel = newLabel();
+            Operand endLabel = newLabel();
+            label(conditionLabel);
+            if(jumping) branch(loop->condition, false, endLabel, JUMP_TO_END);
+            else jump(IR_JUMP_ZERO, value(loop->condition), endLabel, JUMP_TO_END);
+            generateStatement(loop->body, Operand());
+            jump(IR_JUMP, Operand(), conditionLabel, JUMP_TO_CONDITION);
+            label(endLabel);
+        }
+
+        // the jump of an if to its false label; the condition is lowered already without jumping
+        void test(Expr *expr, Operand condition, Operand falseLabel) {
+            if(jumping) branch(expr, false, falseLabel, JUMP_TO_FALSE);
+            else jump(IR_JUMP_ZERO, condition, falseLabel, JUMP_TO_FALSE);
+        }
+
+        static bool relational(Operator op) {
+            return op == OP_LT || op == OP_LE || op == OP_GT || op == OP_GE || op == OP_EQ || op == OP_NE;
+        }
+
+        // jumps to target when the condition is true (sense) or false (!sense), and falls
+        // through otherwise
+        void branch(Expr *expr, bool sense, Operand target, JumpNote note) {
+            if(expr != nullptr && expr->kind == NODE_BINARY) {
+                Binary *binary = static_cast<Binary *>(expr);
+                if(binary->op == OP_AND || binary->op == OP_OR) {
+                    // the left operand decides the value when it is false for && and true for ||
+                    bool decides = binary->op == OP_OR;
+                    if(sense == decides) {
+                        branch(binary->left, sense, target, note);
+                        branch(binary->right, sense, target, note);
+                        return;
+                    }
+                    Operand skip = newLabel();
+                    branch(binary->left, decides, skip, decides ? JUMP_TO_TRUE : JUMP_TO_FALSE);
+                    branch(binary->right, sense, target, note);
+                    label(skip);
+                    return;
+                }
+                if(relational(binary->op)) {
+                    Operand left, right;
+                    operands(binary, left, right);
+                    Instr &test = ir.emit(IR_JUMP_UNLESS, binary->line);
+                    test.a = left;
+                    test.b = right;
+                    test.c = target;
+                    test.imm = sense ? negated(binary->op) : binary->op;
+                    return;
+                }
+            }
+            if(expr != nullptr && expr->kind == NODE_UNARY && static_cast<Unary *>(expr)->op != OP_NEG) {
+                branch(static_cast<Unary *>(expr)->operand, sense, target, note); // + and ! have no code (IR_COPY)
+                return;
+            }
+            jump(sense ? IR_JUMP_NONZERO : IR_JUMP_ZERO, value(expr), target, note);
+        }
+
+        // the variable a name stands for here, none for a name never declared
+        Operand lookup(Atom name) {
+            SymbolInfo * info = symbolTable.lookup(atoms.name(name));
+            if(info == nullptr) return Operand();
+            if(info->getType() == "global") return ir.variable(name, STORAGE_GLOBAL, 0);
+            if(info->getType() == "local") return ir.variable(name, STORAGE_LOCAL, info->getStackOffset());
+            if(info->getType() == "param") return ir.variable(name, STORAGE_PARAM, info->getStackOffset());
+            return Operand();
+        }
+
+        // a variable, or a temporary holding the address of an array element
+        Operand access(VarRef *var) {
+            if(var == nullptr) return Operand();
+            if(var->index == nullptr) return lookup(var->name);
+            Operand index = value(var->index);
+            Operand address = ir.newTemp(TEMP_ADDRESS);
+            Instr &element = ir.emit(IR_ELEMENT);
+            element.dst = address;
+            element.a = lookup(var->name);
+            element.b = index;
+            return address;
+        }
+
+        Instr &define(Opcode op, Operand a = Operand(), Operand b = Operand(), int line = 0) {
+            Operand result = ir.newTemp();
+            Instr &instr = ir.emit(op, line);
+            instr.dst = result;
+            instr.a = a;
+            instr.b = b;
+            return instr;
+        }
+
+        // the temporary holding the value of the expression
+        Operand value(Expr *expr) {
+            if(expr == nullptr) return define(IR_UNKNOWN).dst;
+            switch(expr->kind) {
+                case NODE_ASSIGN: {
+                    Assign *assign = static_cast<Assign *>(expr);
+                    Operand target = access(assign->target);
+                    Operand result = value(assign->value);
+                    Instr &store = ir.emit(IR_STORE, assign->line);
+                    store.a = target;
+                    store.b = result;
+                    return result;
+                }
+                case NODE_BINARY:
+                    return binary(static_cast<Binary *>(expr));
+                case NODE_UNARY: {
+                    Unary *unary = static_cast<Unary *>(expr);
+                    Operand operand = value(unary->operand);
+                    return define(unary->op == OP_NEG ? IR_NEG : IR_COPY, operand).dst;
+                }
+                case NODE_CALL: {
+                    Call *call = static_cast<Call *>(expr);
+                    for(Expr *argument : call->arguments) {
+                        Operand result = value(argument);
+                        ir.emit(IR_ARG).a = result;
+                    }
+                    Instr &instr = define(IR_CALL, Operand{OPERAND_FUNCTION, call->name});
+                    instr.imm = call->arguments.size;
+                    return instr.dst;
+                }
+                case NODE_CONST_INT:
+                    return define(IR_CONST, ir.constant(static_cast<Constant *>(expr)->text), Operand(), expr->line).dst;
+                case NODE_LOAD: {
+                    Operand var = access(static_cast<VarAccess *>(expr)->var);
+                    return define(IR_LOAD, var, Operand(), expr->line).dst;
+                }
+                case NODE_POST_INC:
+                case NODE_POST_DEC: {
+                    Operand var = access(static_cast<VarAccess *>(expr)->var);
+                    return define(expr->kind == NODE_POST_INC ? IR_POST_INC : IR_POST_DEC, var).dst;
+                }
+                default: // float constants
+                    return define(IR_UNKNOWN).dst;
+            }
+        }
+
+        Shape shape(const Expr *expr) {
+            if(expr == nullptr) return Shape{1, true};
+            auto found = shapes.find(expr);
+            if(found != shapes.end()) return found->second;
+            Shape result{1, true};
+            switch(expr->kind) {
+                case NODE_ASSIGN: {
+                    const Assign *assign = static_cast<const Assign *>(expr);
+                    const Expr *index = assign->target->index;
+                    result = Shape{max(shape(assign->value).need, index ? shape(index).need + 1 : 1), false};
+                    break;
+                }
+                case NODE_BINARY: {
+                    const Binary *binary = static_cast<const Binary *>(expr);
+                    Shape left = shape(binary->left), right = shape(binary->right);
+                    bool logic = binary->op == OP_AND || binary->op == OP_OR;
+                    int need = left.need == right.need && !logic ? left.need + 1 : max(left.need, right.need);
+                    result = Shape{need, left.pure && right.pure};
+                    break;
+                }
+                case NODE_UNARY:
+                    result = shape(static_cast<const Unary *>(expr)->operand);
+                    break;
+                case NODE_CALL: // the registers live across it are saved
+                    result = Shape{1, false};
+                    break;
+                case NODE_LOAD:
+                case NODE_POST_INC:
+                case NODE_POST_DEC: {
+                    const VarRef *var = static_cast<const VarAccess *>(expr)->var;
+                    if(var->index != nullptr) result.need = shape(var->index).need;
+                    result.pure = expr->kind == NODE_LOAD && (var->index == nullptr || shape(var->index).pure);
+                    break;
+                }
+                default:
+                    break;
+            }
+            shapes[expr] = result;
+            return result;
+        }
+
+        void operands(Binary *expr, Operand &left, Operand &right) {
+            Shape leftShape, rightShape;
+            if(orderByNeed) {
+                leftShape = shape(expr->left);
+                rightShape = shape(expr->right);
+            }
+            if(orderByNeed && rightShape.need > leftShape.need && leftShape.pure && rightShape.pure) {
+                right = value(expr->right);
+                left = value(expr->left);
+            }
+            else {
+                left = value(expr->left);
+                right = value(expr->right);
+            }
+        }
+
+        Operand binary(Binary *expr) {
+            if(expr->op == OP_AND || expr->op == OP_OR) return logic(expr);
+            Operand left, right;
+            operands(expr, left, right);
+            switch(expr->op) {
+                case OP_ADD: return define(IR_ADD, left, right, expr->line).dst;
+                case OP_SUB: return define(IR_SUB, left, right, expr->line).dst;
+                case OP_MUL: return define(IR_MUL, left, right, expr->line).dst;
+                case OP_DIV: return define(IR_DIV, left, right, expr->line).dst;
+                case OP_MOD: return define(IR_MOD, left, right, expr->line).dst;
+                default: break;
+            }
+            if(branchless) {
+                Instr &relation = define(IR_RELATION, left, right, expr->line);
+                relation.imm = expr->op;
+                return relation.dst;
+            }
+            // relational: 1 or 0 by a branch
+            Operand falseLabel = newLabel();
+            Operand endLabel = newLabel();
+            Instr &test = ir.emit(IR_JUMP_UNLESS, expr->line);
+            test.a = left;
+            test.b = right;
+            test.c = falseLabel;
+            test.imm = expr->op;
+            Operand result = ir.newTemp();
+            set(result, 1, SET_RELATION_TRUE);
+            jump(IR_JUMP, Operand(), endLabel, JUMP_PLAIN);
+            label(falseLabel);
+            set(result, 0, SET_RELATION_FALSE);
+            label(endLabel);
+            return result;
+        }
+
+        // jumps to the short label as soon as the left operand decides the value
+        Operand logic(Binary *expr) {
+            bool isOr = expr->op == OP_OR;
+            Opcode decides = isOr ? IR_JUMP_NONZERO : IR_JUMP_ZERO;
+            JumpNote decidesNote = isOr ? JUMP_TO_TRUE : JUMP_TO_FALSE;
+            Operand shortLabel, endLabel;
+            if(jumping) {
+                shortLabel = newLabel();
+                endLabel = newLabel();
+                branch(expr->left, isOr, shortLabel, decidesNote);
+                branch(expr->right, isOr, shortLabel, decidesNote);
+            }
+            else {
+                Operand left = value(expr->left);
+                shortLabel = newLabel();
+                endLabel = newLabel();
+                jump(decides, left, shortLabel, decidesNote);
+                Operand right = value(expr->right);
+                jump(decides, right, shortLabel, decidesNote);
+            }
+            Operand result = ir.newTemp();
+            set(result, isOr ? 0 : 1, SET_PLAIN);
+            jump(IR_JUMP, Operand(), endLabel, JUMP_TO_END);
+            label(shortLabel);
+            set(result, isOr ? 1 : 0, SET_PLAIN);
+            label(endLabel);
+            return result;
+        }
+
+        void set(Operand result, int value, SetNote note) {
+            Instr &instr = ir.emit(IR_SET);
+            instr.dst = result;
+            instr.a = ir.constantValue(value);
+            instr.note = note;
+        }
+};
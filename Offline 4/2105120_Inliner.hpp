@@ -0,0 +1,383 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include "2105120_IR.hpp"
+#include "2105120_AsmWriter.hpp"
+
+using namespace std;
+
+// Function inlining over the three-address code (-O1).
+// A call of a function that is small or called only once is replaced by a copy of its
+// body, when the function can not reach itself through calls:
+//  - the arguments are stored into its parameters in place of being pushed
+//  - its parameters and locals live in the frame of the caller, above the caller's own
+//    variables, which move down: the first call of the function in a caller reserves the
+//    room with one declaration at the start of the caller, the later ones share it
+//  - a return copies its value into the value of the call and jumps behind the copy
+// Functions are done callees first, so a copied body has its own calls inlined already, and
+// a function left without calls is removed. A function printing a parameter is not copied:
+// println of a parameter prints what ax holds (2105120_InstructionSelector.hpp), which the
+// copy would change.
+class FunctionInliner {
+    public:
+        int inlined = 0;  // calls replaced by the body of the function
+        int removed = 0;  // functions left without calls
+        int growth = 0;   // instructions added, less the ones removed with the functions
+        vector<pair<string, string>> decisions; // each called function and what became of its calls
+
+        void inlineCalls(IRProgram &program) {
+            ir = &program;
+            int before = instructions(0, ir->code.size());
+            findFunctions();
+            vector<Atom> order; // callees first
+            unordered_set<Atom> visited;
+            for(int i = 0; i < (int)ir->code.size(); i++) {
+                if(ir->code[i].op == IR_FUNC_BEGIN) visit(ir->code[i].a.id, visited, order);
+            }
+
+            vector<Atom> called; // in the order first met
+            unordered_map<Atom, string> reasons;
+            unordered_map<Atom, int> inlinedOf;
+            for(Atom caller : order) {
+                for(Atom callee : callees(caller)) {
+                    string reason;
+                    if(worthInlining(callee, reason)) inlinedOf[callee] += inlineInto(caller, callee);
+                    if(reasons.emplace(callee, reason).second) called.push_back(callee);
+                }
+            }
+            for(Atom callee : called) {
+                string decision = reasons[callee];
+                int count = inlinedOf[callee];
+                if(count > 0) {
+                    decision = "inlined at " + to_string(count) + (count == 1 ? " call, " : " calls, ") + decision;
+                    inlined += count;
+                    if(callCount(callee) == 0 && atoms.name(callee) != "main") {
+                        removeFunction(callee);
+                        decision += ", removed";
+                        removed++;
+                    }
+                }
+                else decision = "kept, " + decision;
+                decisions.push_back({atoms.name(callee), decision});
+            }
+            growth = instructions(0, ir->code.size()) - before;
+        }
+
+    private:
+        static const int SMALL = 16; // instructions a function may have to be copied into every caller
+
+        struct Function {
+            int begin = -1, end = -1; // IR_FUNC_BEGIN and IR_FUNC_END
+        };
+
+        IRProgram *ir = nullptr;
+        unordered_map<Atom, Function> functions;
+
+        void findFunctions() {
+            for(pair<const Atom, Function> &function : functions) function.second.begin = function.second.end = -1;
+            for(int i = 0; i < (int)ir->code.size(); i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_FUNC_BEGIN) functions[instr.a.id].begin = i;
+                else if(instr.op == IR_FUNC_END) functions[instr.a.id].end = i;
+            }
+        }
+
+        // the instructions of the code that do something, notes and labels not counted
+        int instructions(int from, int to) const {
+            int count = 0;
+            for(int i = from; i < to; i++) {
+                Opcode op = ir->code[i].op;
+                if(op != IR_NOTE && op != IR_LABEL && op != IR_DECLARE && op != IR_FUNC_BEGIN && op != IR_FUNC_END) count++;
+            }
+            return count;
+        }
+
+        // the functions called in the body of the function, in the order of the calls
+        vector<Atom> callees(Atom function) {
+            vector<Atom> result;
+            const Function &range = functions[function];
+            for(int i = range.begin; i >= 0 && i < range.end; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_CALL && find(result.begin(), result.end(), instr.a.id) == result.end()) result.push_back(instr.a.id);
+            }
+            return result;
+        }
+
+        void visit(Atom function, unordered_set<Atom> &visited, vector<Atom> &order) {
+            if(!visited.insert(function).second) return;
+            for(Atom callee : callees(function)) visit(callee, visited, order);
+            order.push_back(function);
+        }
+
+        bool reaches(Atom from, Atom to, unordered_set<Atom> &seen) {
+            for(Atom callee : callees(from)) {
+                if(callee == to) return true;
+                if(seen.insert(callee).second && reaches(callee, to, seen)) return true;
+            }
+            return false;
+        }
+
+        int callCount(Atom function) const {
+            int count = 0;
+            for(const Instr &instr : ir->code) count += instr.op == IR_CALL && instr.a.id == function;
+            return count;
+        }
+
+        bool worthInlining(Atom callee, string &reason) {
+            const Function &range = functions[callee];
+            if(range.begin < 0 || range.end < 0) {
+                reason = "not defined";
+                return false;
+            }
+            unordered_set<Atom> seen;
+            if(reaches(callee, callee, seen)) {
+                reason = "recursive";
+                return false;
+            }
+            for(int i = range.begin; i < range.end; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_PRINT && instr.a.kind == OPERAND_VAR && ir->variables[instr.a.id].storage == STORAGE_PARAM) {
+                    reason = "prints a parameter";
+                    return false;
+                }
+            }
+            int size = instructions(range.begin, range.end);
+            reason = to_string(size) + " instructions";
+            if(size <= SMALL) return true;
+            if(callCount(callee) == 1) {
+                reason += ", called once";
+                return true;
+            }
+            return false;
+        }
+
+        // the function leaves by a return with a value on every path
+        bool returnsValue(const Function &range) const {
+            int last = range.end - 1;
+            while(last > range.begin && (ir->code[last].op == IR_NOTE || ir->code[last].op == IR_DECLARE)) last--;
+            if(ir->code[last].op != IR_RETURN && ir->code[last].op != IR_JUMP) return false;
+            for(int i = range.begin; i < range.end; i++) {
+                if(ir->code[i].op == IR_RETURN && ir->code[i].a.kind == OPERAND_NONE) return false;
+            }
+            return true;
+        }
+
+        bool read(Operand temp) const {
+            for(const Instr &instr : ir->code) {
+                if(instr.a == temp || instr.b == temp) return true;
+            }
+            return false;
+        }
+
+        // moves the locals of the function down by bytes, for room at the top of its frame
+        void moveLocals(const Function &range, int bytes) {
+            for(int i = range.begin; i < range.end; i++) {
+                Instr &instr = ir->code[i];
+                for(Operand *operand : {&instr.a, &instr.b}) {
+                    if(operand->kind != OPERAND_VAR) continue;
+                    Variable var = ir->variables[operand->id];
+                    if(var.storage == STORAGE_LOCAL) *operand = ir->variable(var.name, STORAGE_LOCAL, var.offset + bytes, var.length);
+                }
+            }
+        }
+
+        // the variables of the callee in the frame of the caller: the locals at the top, as
+        // deep as in the callee, with the elements an array reaches past its own offset, and
+        // the parameters under them; returns the bytes they take
+        int placeVariables(const Function &callee, unordered_map<int, Operand> &placed) {
+            int bytes = 0;
+            int parameters = ir->code[callee.end].imm / 2;
+            for(int i = callee.begin; i < callee.end; i++) {
+                const Instr &instr = ir->code[i];
+                for(const Operand *operand : {&instr.a, &instr.b}) {
+                    if(operand->kind != OPERAND_VAR) continue;
+                    const Variable &var = ir->variables[operand->id];
+                    if(var.storage == STORAGE_LOCAL) bytes = max(bytes, var.offset + (var.length > 0 ? 2 * (var.length - 1) : 0));
+                }
+            }
+            for(int i = callee.begin; i < callee.end; i++) {
+                const Instr &instr = ir->code[i];
+                for(const Operand *operand : {&instr.a, &instr.b}) {
+                    if(operand->kind != OPERAND_VAR || placed.count(operand->id)) continue;
+                    Variable var = ir->variables[operand->id];
+                    if(var.storage == STORAGE_LOCAL) placed[operand->id] = *operand;
+                    else if(var.storage == STORAGE_PARAM) { // pushed first, deepest in the callee
+                        int number = parameters - 1 - (var.offset - 4) / 2;
+                        placed[operand->id] = ir->variable(var.name, STORAGE_LOCAL, bytes + 2 * (number + 1));
+                    }
+                }
+            }
+            return bytes + 2 * parameters;
+        }
+
+        // the arguments of the call at index, in the order they are pushed
+        vector<int> argumentsOf(int call) const {
+            vector<int> result, open; // arguments still to find of the calls inside this one
+            for(int i = call - 1; i >= 0 && (int)result.size() < ir->code[call].imm; i--) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_CALL && instr.imm > 0) open.push_back(instr.imm);
+                else if(instr.op == IR_ARG) {
+                    if(open.empty()) result.push_back(i);
+                    else if(--open.back() == 0) open.pop_back();
+                }
+            }
+            reverse(result.begin(), result.end());
+            return result;
+        }
+
+        // the call at index can take a copy of the body: its parameters are not written by
+        // another copy while its arguments are made, and without arguments, no value waits
+        // in ax for it, which the code without registers would push inside the copy
+        bool copyable(const Function &into, int call, const unordered_map<int, Operand> &placed) const {
+            const Instr &site = ir->code[call];
+            vector<int> arguments = argumentsOf(call);
+            if((int)arguments.size() != site.imm) return false;
+            if(!arguments.empty()) {
+                unordered_set<int> region;
+                for(const pair<const int, Operand> &variable : placed) region.insert(variable.second.id);
+                for(int i = arguments.front(); i < call; i++) {
+                    const Instr &instr = ir->code[i];
+                    if(instr.op == IR_CALL && instr.a.id == site.a.id) return false;
+                    for(const Operand *operand : {&instr.a, &instr.b}) {
+                        if(operand->kind == OPERAND_VAR && region.count(operand->id)) return false;
+                    }
+                }
+                return true;
+            }
+            vector<bool> before(ir->temps.size(), false);
+            for(int i = into.begin; i < call; i++) {
+                if(ir->code[i].dst.kind == OPERAND_TEMP) before[ir->code[i].dst.id] = true;
+            }
+            for(int i = call + 1; i < into.end; i++) {
+                const Instr &instr = ir->code[i];
+                for(const Operand *operand : {&instr.a, &instr.b}) {
+                    if(operand->kind == OPERAND_TEMP && before[operand->id]) return false;
+                }
+            }
+            return true;
+        }
+
+        // inlines the calls of the callee in the caller, returns how many
+        int inlineInto(Atom caller, Atom callee) {
+            if(caller == callee) return 0;
+            unordered_map<int, Operand> placed; // variable of the callee and its place in the caller
+            int count = 0;
+            while(true) {
+                findFunctions();
+                const Function &into = functions[caller], &from = functions[callee];
+                int call = -1;
+                for(int i = into.begin; i < into.end && call < 0; i++) {
+                    const Instr &instr = ir->code[i];
+                    if(instr.op != IR_CALL || instr.a.id != callee) continue;
+                    if(read(instr.dst) && !returnsValue(from)) continue;
+                    if(copyable(into, i, placed)) call = i;
+                }
+                if(call < 0) return count;
+                if(placed.empty()) {
+                    int bytes = placeVariables(from, placed);
+                    if(bytes > 0) {
+                        moveLocals(into, bytes);
+                        Instr room{IR_DECLARE}; // the variables of the callee
+                        room.a = ir->variable(callee, STORAGE_LOCAL, bytes);
+                        room.imm = bytes / 2;
+                        room.line = ir->code[into.begin].line;
+                        ir->code.insert(ir->code.begin() + into.begin + 1, room);
+                        findFunctions();
+                        call++;
+                    }
+                }
+                copyBody(call, functions[callee], placed);
+                count++;
+            }
+        }
+
+        void copyBody(int call, const Function &callee, const unordered_map<int, Operand> &placed) {
+            Instr site = ir->code[call];
+            vector<int> arguments = argumentsOf(call);
+            Operand resume = ir->newLabel(label_count++);
+            Operand result = read(site.dst) ? site.dst : Operand();
+            vector<Operand> temps(ir->temps.size()), labels(ir->labels.size());
+            auto renamed = [&](Operand operand) {
+                switch(operand.kind) {
+                    case OPERAND_TEMP:
+                        if(temps[operand.id].kind == OPERAND_NONE) temps[operand.id] = ir->newTemp(ir->temps[operand.id]);
+                        return temps[operand.id];
+                    case OPERAND_LABEL:
+                        if(ir->labels[operand.id].number < 0) return resume; // the end of the callee
+                        if(labels[operand.id].kind == OPERAND_NONE) labels[operand.id] = ir->newLabel(label_count++);
+                        return labels[operand.id];
+                    case OPERAND_VAR: {
+                        unordered_map<int, Operand>::const_iterator it = placed.find(operand.id);
+                        return it == placed.end() ? operand : it->second;
+                    }
+                    default:
+                        return operand;
+                }
+            };
+
+            // each argument goes into its parameter where it would be pushed, while it is in ax
+            // for the code without registers
+            vector<Instr> stores(arguments.size(), Instr{IR_NOTE});
+            int parameters = ir->code[callee.end].imm / 2;
+            for(const pair<const int, Operand> &variable : placed) {
+                const Variable &var = ir->variables[variable.first];
+                if(var.storage != STORAGE_PARAM) continue;
+                Instr &store = stores[parameters - 1 - (var.offset - 4) / 2];
+                store.op = IR_STORE;
+                store.a = variable.second;
+            }
+            for(int k = 0; k < (int)arguments.size(); k++) {
+                if(stores[k].op != IR_STORE) continue; // never read
+                stores[k].b = ir->code[arguments[k]].a;
+                stores[k].line = ir->code[callee.begin].line; // where the parameters are declared
+            }
+
+            vector<Instr> body;
+            for(int i = callee.begin + 1; i < callee.end; i++) {
+                Instr instr = ir->code[i];
+                if(instr.op == IR_DECLARE) continue;
+                instr.dst = renamed(instr.dst);
+                instr.a = renamed(instr.a);
+                instr.b = renamed(instr.b);
+                instr.c = renamed(instr.c);
+                if(instr.op == IR_RETURN) {
+                    if(result.kind == OPERAND_TEMP) {
+                        Instr copy{IR_COPY};
+                        copy.dst = result;
+                        copy.a = instr.a;
+                        copy.line = instr.line;
+                        body.push_back(copy);
+                    }
+                    instr = Instr{IR_JUMP};
+                    instr.c = resume;
+                }
+                body.push_back(instr);
+            }
+            Instr label{IR_LABEL};
+            label.c = resume;
+            body.push_back(label);
+
+            vector<Instr> code;
+            code.reserve(ir->code.size() + body.size());
+            for(int i = 0, k = 0; i < (int)ir->code.size(); i++) {
+                if(i == call) code.insert(code.end(), body.begin(), body.end());
+                else if(k < (int)arguments.size() && i == arguments[k]) {
+                    if(stores[k].op == IR_STORE) code.push_back(stores[k]);
+                    k++;
+                }
+                else code.push_back(ir->code[i]);
+            }
+            ir->code = move(code);
+        }
+
+        void removeFunction(Atom function) {
+            findFunctions();
+            const Function &range = functions[function];
+            ir->code.erase(ir->code.begin() + range.begin, ir->code.begin() + range.end + 1);
+            functions.erase(function);
+        }
+};
@@ -0,0 +1,632 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "2105120_IR.hpp"
+#include "2105120_RegisterAllocator.hpp"
+#include "2105120_StrengthReduction.hpp"
+#include "2105120_AsmWriter.hpp"
+
+using namespace std;
+
+// 8086 code for the three-address code (--ast).
+// Every temporary is made in ax. When ax holds a temporary that is still needed and an
+// instruction is about to overwrite it, the temporary is pushed, and the instruction that
+// needs it pops it into bx; this is the push and pop around the right operand that the
+// grammar actions write, so the IR as the builder makes it gives the code of the actions.
+// With an allocation (-O1) each temporary is made in its own register instead and ax is
+// left as scratch; a temporary the allocator spilled is made in ax and pushed. Operations
+// with a constant operand are strength reduced there (2105120_StrengthReduction.hpp).
+// The offset of a local array is that of its last word, and the actions put element i
+// at [bp - offset - 2i], below the words the declaration reserved, over the locals
+// declared after it. -O0 keeps that; -O1 puts it at [bp - offset + 2i], inside them.
+class InstructionSelector {
+    public:
+        void select(const IRProgram &program, const Allocation *allocation = nullptr) {
+            ir = &program;
+            registers = allocation;
+            findLastUses();
+            accumulator = -1;
+            pushed.clear();
+            elementOf.assign(program.temps.size(), Operand());
+            indexOf.assign(program.temps.size(), Operand());
+            int zeroTested = -2; // the temporary the flags hold a comparison with 0 of
+            for(int i = 0; i < (int)program.code.size(); i++) {
+                const Instr &instr = program.code[i];
+                allocated = registers && !registers->unallocated[i];
+                if(allocated) selectWithRegisters(i, zeroTested);
+                else {
+                    if(writesAccumulator(instr.op)) saveAccumulator(i, instr);
+                    selectInstruction(instr, zeroTested);
+                }
+                zeroTested = (instr.op == IR_JUMP_ZERO || instr.op == IR_JUMP_NONZERO) ? instr.a.id : -2;
+            }
+        }
+
+    private:
+        const IRProgram *ir = nullptr;
+        const Allocation *registers = nullptr;
+        bool allocated = false; // the current instruction has its temporaries in registers
+        vector<int> lastUse; // index of the last instruction reading each temporary
+        vector<Operand> elementOf; // the array of an element's address
+        vector<Operand> indexOf; // and its index
+        int accumulator; // the temporary in ax, -1 for none
+        vector<int> pushed; // temporaries saved on the stack, the last one on top
+        bool framed = true; // the current function sets bp up
+
+        void findLastUses() {
+            lastUse.assign(ir->temps.size(), -1);
+            for(int i = 0; i < (int)ir->code.size(); i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.a.kind == OPERAND_TEMP) lastUse[instr.a.id] = i;
+                if(instr.b.kind == OPERAND_TEMP) lastUse[instr.b.id] = i;
+            }
+        }
+
+        static bool writesAccumulator(Opcode op) {
+            switch(op) {
+                case IR_CONST: case IR_UNKNOWN: case IR_LOAD: case IR_ELEMENT:
+                case IR_POST_INC: case IR_POST_DEC: case IR_COPY: case IR_NEG:
+                case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD:
+                case IR_RELATION: case IR_SET: case IR_CALL: case IR_PRINT:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // push the temporary in ax if it is read after the instruction at index
+        void saveAccumulator(int index, const Instr &instr) {
+            if(accumulator < 0) return;
+            Operand held{OPERAND_TEMP, accumulator};
+            if(instr.a == held || instr.b == held || instr.dst == held) return;
+            if(lastUse[accumulator] <= index) return;
+            writeIntoCodeFile("\tpush ax\n");
+            pushed.push_back(accumulator);
+            accumulator = -1;
+        }
+
+        // the operand of a binary instruction pushed while the other one was made, into bx.
+        // That is the left one, unless the right one was lowered first (orderByNeed); then
+        // the left one is in ax and true is returned. A folded constant goes to bx and the
+        // other operand to ax, from the stack if it was pushed in between.
+        bool popOperand(const Instr &instr) {
+            if(instr.a.kind == OPERAND_CONST || instr.b.kind == OPERAND_CONST) {
+                bool leftInAx = instr.b.kind == OPERAND_CONST;
+                Operand operand = leftInAx ? instr.a : instr.b;
+                if(!(operand == Operand{OPERAND_TEMP, accumulator})) {
+                    if(!pushed.empty() && operand == Operand{OPERAND_TEMP, pushed.back()}) pushed.pop_back();
+                    writeIntoCodeFile("\tpop ax\n");
+                }
+                writeIntoCodeFile("\tmov bx, ", constantText(*ir, (leftInAx ? instr.b : instr.a).id), "\n");
+                return leftInAx;
+            }
+            bool leftInAx = instr.a == Operand{OPERAND_TEMP, accumulator};
+            Operand operand = leftInAx ? instr.b : instr.a;
+            if(!pushed.empty() && operand == Operand{OPERAND_TEMP, pushed.back()}) pushed.pop_back();
+            writeIntoCodeFile("\tpop bx\n");
+            return leftInAx;
+        }
+
+        // a call in tail position: its arguments, on top of the stack, go into the parameters
+        // of this frame, which the function itself starts over in, or another one returns from
+        void tailCall(const Instr &instr) {
+            for(int k = 0; k < instr.imm; k++) writeIntoCodeFile("\tpop word ptr [bp + ", 4 + 2 * k, "]\n");
+            writeIntoCodeFile("\tmov sp, bp\n");
+            if(instr.c.kind == OPERAND_LABEL) writeIntoCodeFile("\tjmp ", labelText(*ir, instr.c.id), " ; tail call\n");
+            else writeIntoCodeFile("\tpop bp\n\tjmp ", atoms.name(instr.c.id), " ; tail call\n");
+        }
+
+        string memory(Operand operand) const {
+            if(operand.kind == OPERAND_TEMP) { // an element
+                Operand array = elementOf[operand.id];
+                if(array.kind != OPERAND_VAR) return "";
+                const Variable &var = ir->variables[array.id];
+                if(allocated && indexOf[operand.id].kind == OPERAND_CONST) { // a constant address
+                    int offset = 2 * ir->constants[indexOf[operand.id].id].value;
+                    if(var.storage == STORAGE_GLOBAL) return atoms.name(var.name) + "[" + to_string(offset) + "]";
+                    offset = var.offset - offset;
+                    return offset < 0 ? "[bp + " + to_string(-offset) + "]" : "[bp - " + to_string(offset) + "]";
+                }
+                if(allocated) { // the register holds the offset of the element in the array
+                    string index = registerName(registers->reg[operand.id]);
+                    if(var.storage == STORAGE_GLOBAL) return atoms.name(var.name) + "[" + index + "]";
+                    if(var.storage == STORAGE_LOCAL) return "[bp - " + to_string(var.offset) + " + " + index + "]";
+                    return "";
+                }
+                if(var.storage == STORAGE_GLOBAL) return "[si]";
+                if(var.storage == STORAGE_LOCAL) return "[bp - " + to_string(var.offset) + (registers ? " + di]" : " - di]");
+                return "";
+            }
+            if(operand.kind != OPERAND_VAR) return "";
+            const Variable &var = ir->variables[operand.id];
+            if(var.storage == STORAGE_GLOBAL) return atoms.name(var.name);
+            if(var.storage == STORAGE_LOCAL) return "[bp - " + to_string(var.offset) + "]";
+            return "[bp + " + to_string(var.offset) + "]";
+        }
+
+        static const char *statementNote(unsigned char note) {
+            static const char *texts[] = {
+                "; variable declaration of line ", "; for loop in line no ", "; if statement in line no ",
+                "; else statement in line no ", "; while loop in line no ", "; print statement in line no ",
+                "; return statement in line no "
+            };
+            return texts[note];
+        }
+
+        static const char *jumpNote(unsigned char note) {
+            static const char *texts[] = {
+                "", " ; jump to end", " ; jump to true label", " ; jump to false label",
+                " ; jump to statement execution", " ; jump to condition checking",
+                " ; jump to increment/decrement statement"
+            };
+            return texts[note];
+        }
+
+        void selectInstruction(const Instr &instr, int zeroTested) {
+            switch(instr.op) {
+                case IR_FUNC_BEGIN: {
+                    const string &name = atoms.name(instr.a.id);
+                    writeCodeSegment();
+                    writeIntoCodeFile("; definition of function ", name, " started, line no ", instr.line, "\n");
+                    writeProcName(name);
+                    framed = instr.note == 0;
+                    if(framed) writeIntoCodeFile("\tpush bp\n\tmov bp, sp\n");
+                    break;
+                }
+                case IR_FUNC_END:
+                    if(instr.note) writeIntoCodeFile(labelText(*ir, instr.c.id), ":\n");
+                    if(framed) writeIntoCodeFile("\tmov sp, bp\n\tpop bp\n");
+                    writeProcEnd(atoms.name(instr.a.id), instr.imm);
+                    break;
+                case IR_DECLARE: {
+                    const Variable &var = ir->variables[instr.a.id];
+                    if(var.storage == STORAGE_GLOBAL) {
+                        if(instr.imm < 0) writeIntoCodeFile("\t", atoms.name(var.name), " dw 0h\n");
+                        else writeIntoCodeFile("\t", atoms.name(var.name), " dw ", instr.imm, " dup (0)\n");
+                    }
+                    else writeIntoCodeFile("\tsub sp, ", instr.imm < 0 ? 2 : instr.imm * 2, "\n");
+                    break;
+                }
+                case IR_NOTE:
+                    writeIntoCodeFile(statementNote(instr.note), instr.line, "\n");
+                    break;
+                case IR_CONST:
+                    writeIntoCodeFile("\tmov ax, ", constantText(*ir, instr.a.id), "; integer constant of line ", instr.line, " loaded to ax\n");
+                    break;
+                case IR_UNKNOWN:
+                case IR_COPY:
+                    break;
+                case IR_LOAD:
+                    writeIntoCodeFile("\tmov ax, ", memory(instr.a), "; load variable of line ", instr.line, "\n");
+                    break;
+                case IR_STORE:
+                    if(instr.b.kind == OPERAND_CONST) {
+                        writeIntoCodeFile("\tmov word ptr ", memory(instr.a), ", ", constantText(*ir, instr.b.id), " ; assignment operation of line ", instr.line, "\n");
+                        break;
+                    }
+                    writeIntoCodeFile("\tmov ", memory(instr.a), ", ax ; assignment operation of line ", instr.line, "\n");
+                    break;
+                case IR_ELEMENT: {
+                    elementOf[instr.dst.id] = instr.a;
+                    accumulator = -1; // the address goes to si or di
+                    if(instr.b.kind == OPERAND_CONST) writeIntoCodeFile("\tmov ax, ", constantText(*ir, instr.b.id), "\n");
+                    writeIntoCodeFile("\tmov bx, 2\n");
+                    writeIntoCodeFile("\tmul bx\n");
+                    if(instr.a.kind != OPERAND_VAR) return;
+                    const Variable &var = ir->variables[instr.a.id];
+                    if(var.storage == STORAGE_GLOBAL) {
+                        writeIntoCodeFile("\tlea si, ", atoms.name(var.name), "\n");
+                        writeIntoCodeFile("\tadd si, ax\n");
+                    }
+                    else if(var.storage == STORAGE_LOCAL) writeIntoCodeFile("\tmov di, ax\n");
+                    return;
+                }
+                case IR_POST_INC:
+                case IR_POST_DEC: {
+                    string var = memory(instr.a);
+                    bool increment = instr.op == IR_POST_INC;
+                    writeIntoCodeFile("\tmov ax, ", var, "\n");
+                    writeIntoCodeFile(increment ? "\tinc ax\n" : "\tdec ax\n");
+                    writeIntoCodeFile("\tmov ", var, ", ax\n");
+                    writeIntoCodeFile(increment ? "\tdec ax\n" : "\tinc ax\n");
+                    break;
+                }
+                case IR_NEG:
+                    writeIntoCodeFile("\tneg ax\n");
+                    break;
+                case IR_ADD:
+                    popOperand(instr);
+                    writeIntoCodeFile("\tadd bx, ax ; addition operation of line ", instr.line, "\n");
+                    writeIntoCodeFile("\tmov ax, bx\n");
+                    break;
+                case IR_SUB:
+                    if(popOperand(instr)) {
+                        writeIntoCodeFile("\tsub ax, bx ; subtraction operation of line ", instr.line, "\n");
+                        break;
+                    }
+                    writeIntoCodeFile("\tsub bx, ax ; subtraction operation of line ", instr.line, "\n");
+                    writeIntoCodeFile("\tmov ax, bx\n");
+                    break;
+                case IR_MUL:
+                    popOperand(instr);
+                    writeIntoCodeFile("\txchg ax,bx\n");
+                    writeIntoCodeFile("\tmul bx\n");
+                    break;
+                case IR_DIV:
+                case IR_MOD:
+                    if(!popOperand(instr)) writeIntoCodeFile("\txchg ax,bx\n");
+                    writeIntoCodeFile("\tmov dx,0h\n");
+                    writeIntoCodeFile("\tdiv bx\n");
+                    if(instr.op == IR_MOD) writeIntoCodeFile("\tmov ax, dx\n");
+                    break;
+                case IR_RELATION: {
+                    Operator op = Operator(instr.imm);
+                    if(popOperand(instr)) relation(op, "ax", "bx", Operand(), "ax");
+                    else relation(op, "bx", "ax", Operand(), "ax");
+                    break;
+                }
+                case IR_SET:
+                    writeIntoCodeFile("\tmov ax, ", constantText(*ir, instr.a.id));
+                    if(instr.note == SET_RELATION_TRUE) writeIntoCodeFile(" ; result of relational operation true");
+                    else if(instr.note == SET_RELATION_FALSE) writeIntoCodeFile(" ; result of relational operation false");
+                    writeIntoCodeFile("\n");
+                    break;
+                case IR_LABEL:
+                    writeIntoCodeFile(labelText(*ir, instr.c.id), ":\n");
+                    return;
+                case IR_JUMP:
+                    writeIntoCodeFile("\tjmp ", labelText(*ir, instr.c.id), jumpNote(instr.note), "\n");
+                    accumulator = -1; // what follows is reached from elsewhere
+                    return;
+                case IR_JUMP_ZERO:
+                case IR_JUMP_NONZERO:
+                    // the for loop tests its condition twice in a row, with one comparison
+                    if(zeroTested != instr.a.id) writeIntoCodeFile("\tcmp ax, 0\n");
+                    writeIntoCodeFile(instr.op == IR_JUMP_ZERO ? "\tje " : "\tjne ", labelText(*ir, instr.c.id), jumpNote(instr.note), "\n");
+                    return;
+                case IR_JUMP_UNLESS:
+                    writeIntoCodeFile(popOperand(instr) ? "\tcmp ax, bx\n" : "\tcmp bx, ax\n");
+                    writeJumpConditionByRelop(operatorText(Operator(instr.imm)), ir->labels[instr.c.id].number);
+                    return;
+                case IR_ARG:
+                    writeIntoCodeFile("\tpush ax\n");
+                    accumulator = -1;
+                    return;
+                case IR_CALL:
+                    if(instr.c.kind != OPERAND_NONE) {
+                        tailCall(instr);
+                        accumulator = -1;
+                        return;
+                    }
+                    writeIntoCodeFile("\tcall ", atoms.name(instr.a.id), "\n");
+                    break;
+                case IR_RETURN:
+                    if(instr.a.kind == OPERAND_CONST) writeIntoCodeFile("\tmov ax, ", constantText(*ir, instr.a.id), "\n");
+                    writeIntoCodeFile("\tjmp ", labelText(*ir, instr.c.id), "\n");
+                    return;
+                case IR_PRINT:
+                    if(instr.a.kind == OPERAND_VAR && ir->variables[instr.a.id].storage != STORAGE_PARAM) {
+                        writeIntoCodeFile("\tmov ax, ", memory(instr.a), "\n");
+                    }
+                    writeIntoCodeFile("\tcall print_output\n\tcall new_line\n");
+                    accumulator = -1;
+                    return;
+            }
+            if(instr.dst.kind == OPERAND_TEMP) accumulator = instr.dst.id;
+        }
+
+        // t = 1 if x op y, else 0. Without a jump where that is faster by the 8086 timings:
+        // cmp leaves the borrow of an unsigned comparison in CF and sbb ax, ax makes it -1
+        // or 0, so == and != take ax - y, and a signed comparison with a constant compares
+        // x with its sign bit flipped to the constant with its own flipped. Between two
+        // registers one jump over a dec is shorter than flipping both.
+        // x is a register, y a register or the constant operand, not both ax.
+        void relation(Operator op, string x, string y, Operand operand, const string &t) {
+            bool constant = operand.kind == OPERAND_CONST;
+            if(op == OP_EQ || op == OP_NE) { // ax - y is 0 exactly when they are equal
+                if(y == "ax") swap(x, y);
+                move("ax", x);
+                if(!constant || ir->constants[operand.id].value != 0) writeIntoCodeFile("\tsub ax, ", y, "\n");
+                writeIntoCodeFile(op == OP_EQ ? "\tcmp ax, 1\n" : "\tneg ax\n");
+                writeIntoCodeFile("\tsbb ax, ax\n\tneg ax\n");
+                move(t, "ax");
+                return;
+            }
+            if(!constant) {
+                int skip = label_count++;
+                writeIntoCodeFile("\tcmp ", x, ", ", y, "\n");
+                writeIntoCodeFile("\tmov ", t, ", 1\n");
+                writeJumpConditionByRelop(operatorText(negated(op)), skip);
+                writeIntoCodeFile("\tdec ", t, "\n");
+                writeIntoCodeFile("L", skip, ":\n");
+                return;
+            }
+            int k = ir->constants[operand.id].value;
+            if(op == OP_LE || op == OP_GT) { // x <= k is x < k + 1
+                if(k == 32767) {
+                    writeIntoCodeFile("\tmov ", t, ", ", op == OP_LE ? 1 : 0, "\n");
+                    return;
+                }
+                op = op == OP_LE ? OP_LT : OP_GE;
+                k++;
+            }
+            move("ax", x);
+            writeIntoCodeFile("\txor ax, 8000h\n");
+            writeIntoCodeFile("\tcmp ax, ", (unsigned short)(k ^ 0x8000), "\n");
+            writeIntoCodeFile("\tsbb ax, ax\n"); // -1 for x < k
+            writeIntoCodeFile(op == OP_LT ? "\tneg ax\n" : "\tinc ax\n");
+            move(t, "ax");
+        }
+
+        bool inRegister(int t, int index) const {
+            int spillAt = registers->spillAt[t];
+            return registers->reg[t] != REG_NONE && (spillAt < 0 || spillAt > index);
+        }
+
+        // where an operand is read: its register, or ax, popped from the stack, or a folded
+        // constant as an immediate
+        string take(Operand operand, int index) {
+            if(operand.kind == OPERAND_CONST) return constantText(*ir, operand.id);
+            if(inRegister(operand.id, index)) return registerName(registers->reg[operand.id]);
+            writeIntoCodeFile("\tpop ax\n");
+            if(lastUse[operand.id] > index) writeIntoCodeFile("\tpush ax\n");
+            return "ax";
+        }
+
+        // where a temporary is made: its register, or ax when it goes on the stack
+        string target(Operand dst, int index) const {
+            return inRegister(dst.id, index) ? registerName(registers->reg[dst.id]) : "ax";
+        }
+
+        void made(Operand dst, int index) {
+            if(!inRegister(dst.id, index) && lastUse[dst.id] > index) writeIntoCodeFile("\tpush ax\n");
+        }
+
+        void move(const string &to, const string &from) {
+            if(to != from) writeIntoCodeFile("\tmov ", to, ", ", from, "\n");
+        }
+
+        void pushSaved(int call) {
+            for(Register reg : registers->saved.at(call)) writeIntoCodeFile("\tpush ", registerName(reg), "\n");
+        }
+
+        void shift(const char *op, const string &reg, int count) {
+            for(int k = 0; k < count; k++) writeIntoCodeFile("\t", op, " ", reg, ", 1\n");
+        }
+
+        // a mul, div or mod by a constant, without the mul or div where it can
+        void reduce(const Instr &instr, int index, const string &a) {
+            string t = target(instr.dst, index);
+            unsigned c = (unsigned short)ir->constants[instr.b.id].value;
+            int k = exactLog2(c);
+            if(instr.op == IR_MOD) { // by a power of two
+                if(c == 1) writeIntoCodeFile("\tmov ", t, ", 0\n");
+                else {
+                    move(t, a);
+                    writeIntoCodeFile("\tand ", t, ", ", c - 1, "\n");
+                }
+                return;
+            }
+            if(k >= 0) {
+                move(t, a);
+                shift(instr.op == IR_MUL ? "shl" : "shr", t, k);
+                return;
+            }
+            if(instr.op == IR_DIV && c > 0x8000) { // x / c is 1 when x >= c, else 0: no borrow, no dx
+                move(t, a);
+                writeIntoCodeFile("\tcmp ", t, ", ", c, "\n\tsbb ", t, ", ", t, "\n\tinc ", t, "\n");
+                return;
+            }
+            if(instr.op == IR_DIV) {
+                Reciprocal r = reciprocal(c);
+                if(r.add && a == "ax") writeIntoCodeFile("\tpush ax\n");
+                move("ax", a);
+                writeIntoCodeFile("\tmov dx, ", r.multiplier, "\n");
+                writeIntoCodeFile("\tmul dx\n");
+                if(!r.add) {
+                    shift("shr", "dx", r.shift);
+                    move(t, "dx");
+                    return;
+                }
+                if(a == "ax") writeIntoCodeFile("\tpop ax\n");
+                else move("ax", a);
+                writeIntoCodeFile("\tsub ax, dx\n\tshr ax, 1\n\tadd ax, dx\n");
+                shift("shr", "ax", r.shift);
+                move(t, "ax");
+                return;
+            }
+            if(c == 0) {
+                writeIntoCodeFile("\tmov ", t, ", 0\n");
+                return;
+            }
+            if(c == 0xFFFF) {
+                move(t, a);
+                writeIntoCodeFile("\tneg ", t, "\n");
+                return;
+            }
+            int high, low;
+            bool subtract;
+            if(!shiftAndAdd(c, high, low, subtract)) {
+                move("ax", a);
+                writeIntoCodeFile("\tmov dx, ", c, "\n");
+                writeIntoCodeFile("\tmul dx\n");
+                move(t, "ax");
+                return;
+            }
+            // x * (2^(high - low) +- 1) * 2^low, made in the result's register when x stays
+            // in its own, in ax when the result takes x's register, with x copied to bx,
+            // borrowed, when both are ax
+            string x = a, w = t;
+            bool borrowed = a == "ax" && t == "ax";
+            if(borrowed) {
+                writeIntoCodeFile("\tpush bx\n");
+                x = "bx";
+                move(x, a);
+            }
+            else if(t == a) w = "ax";
+            move(w, a);
+            shift("shl", w, high - low);
+            writeIntoCodeFile(subtract ? "\tsub " : "\tadd ", w, ", ", x, "\n");
+            shift("shl", w, low);
+            if(borrowed) writeIntoCodeFile("\tpop bx\n");
+            move(t, w);
+        }
+
+        void selectWithRegisters(int index, int zeroTested) {
+            const Instr &instr = ir->code[index];
+            string a, b;
+            // operands first: a spilled one is on top of the stack, under nothing pushed here
+            if(instr.op != IR_ARG) {
+                bool value = instr.a.kind == OPERAND_TEMP || instr.a.kind == OPERAND_CONST;
+                if(value && instr.op != IR_LOAD && instr.op != IR_STORE && instr.op != IR_POST_INC &&
+                   instr.op != IR_POST_DEC && instr.op != IR_ELEMENT) a = take(instr.a, index);
+                if(instr.b.kind == OPERAND_TEMP || instr.b.kind == OPERAND_CONST) b = take(instr.b, index);
+                if(instr.op == IR_ELEMENT) a = b;
+            }
+            // a live temporary gives its register to the result; after a call, whose
+            // arguments are on the stack, it is pushed once the call returns
+            int evicted = registers->spillBefore[index];
+            if(evicted >= 0 && instr.op != IR_CALL) writeIntoCodeFile("\tpush ", registerName(registers->reg[evicted]), "\n");
+
+            switch(instr.op) {
+                case IR_CONST: {
+                    string t = target(instr.dst, index);
+                    writeIntoCodeFile("\tmov ", t, ", ", constantText(*ir, instr.a.id), "; integer constant of line ", instr.line, " loaded to ", t, "\n");
+                    break;
+                }
+                case IR_UNKNOWN:
+                    break;
+                case IR_LOAD:
+                    writeIntoCodeFile("\tmov ", target(instr.dst, index), ", ", memory(instr.a), "; load variable of line ", instr.line, "\n");
+                    break;
+                case IR_STORE:
+                    writeIntoCodeFile("\tmov ", instr.b.kind == OPERAND_CONST ? "word ptr " : "", memory(instr.a), ", ", b, " ; assignment operation of line ", instr.line, "\n");
+                    return;
+                case IR_ELEMENT: {
+                    elementOf[instr.dst.id] = instr.a;
+                    indexOf[instr.dst.id] = instr.b;
+                    if(fixedElement(*ir, instr)) return;
+                    string t = target(instr.dst, index);
+                    move(t, a);
+                    writeIntoCodeFile("\tshl ", t, ", 1\n");
+                    break;
+                }
+                case IR_POST_INC:
+                case IR_POST_DEC: {
+                    string var = memory(instr.a);
+                    const char *step = instr.op == IR_POST_INC ? "\tinc word ptr " : "\tdec word ptr ";
+                    if(lastUse[instr.dst.id] < 0) { // the old value is not needed
+                        writeIntoCodeFile(step, var, "\n");
+                        return;
+                    }
+                    string t = target(instr.dst, index);
+                    // an element's register may be the result's, so read it before it changes
+                    bool sameRegister = instr.a.kind == OPERAND_TEMP && registers->reg[instr.a.id] == registers->reg[instr.dst.id];
+                    string old = sameRegister ? "ax" : t;
+                    writeIntoCodeFile("\tmov ", old, ", ", var, "\n");
+                    writeIntoCodeFile(step, var, "\n");
+                    move(t, old);
+                    break;
+                }
+                case IR_COPY:
+                    move(target(instr.dst, index), a);
+                    break;
+                case IR_NEG: {
+                    string t = target(instr.dst, index);
+                    move(t, a);
+                    writeIntoCodeFile("\tneg ", t, "\n");
+                    break;
+                }
+                case IR_ADD:
+                case IR_SUB: {
+                    string t = target(instr.dst, index);
+                    bool add = instr.op == IR_ADD;
+                    if(t == b && t != a) {
+                        if(add) writeIntoCodeFile("\tadd ", t, ", ", a, " ; addition operation of line ", instr.line, "\n");
+                        else {
+                            writeIntoCodeFile("\tneg ", t, "\n");
+                            writeIntoCodeFile("\tadd ", t, ", ", a, " ; subtraction operation of line ", instr.line, "\n");
+                        }
+                        break;
+                    }
+                    move(t, a);
+                    writeIntoCodeFile(add ? "\tadd " : "\tsub ", t, ", ", b, add ? " ; addition operation of line " : " ; subtraction operation of line ", instr.line, "\n");
+                    break;
+                }
+                case IR_MUL:
+                case IR_DIV:
+                case IR_MOD: {
+                    if(instr.b.kind == OPERAND_CONST) {
+                        reduce(instr, index, a);
+                        break;
+                    }
+                    // b is not dx: the allocator keeps dx from what lives across these
+                    if(b == "ax") { // popped from the stack: multiply by a, or swap it with a
+                        if(instr.op != IR_MUL) writeIntoCodeFile("\txchg ax, ", a, "\n");
+                        b = a;
+                    }
+                    else move("ax", a);
+                    if(instr.op != IR_MUL) writeIntoCodeFile("\txor dx, dx\n");
+                    writeIntoCodeFile(instr.op == IR_MUL ? "\tmul " : "\tdiv ", b, "\n");
+                    move(target(instr.dst, index), instr.op == IR_MOD ? "dx" : "ax");
+                    break;
+                }
+                case IR_RELATION:
+                    if(instr.a.kind == OPERAND_CONST) relation(mirrored(Operator(instr.imm)), b, a, instr.a, target(instr.dst, index));
+                    else relation(Operator(instr.imm), a, b, instr.b, target(instr.dst, index));
+                    break;
+                case IR_SET: {
+                    writeIntoCodeFile("\tmov ", target(instr.dst, index), ", ", constantText(*ir, instr.a.id));
+                    if(instr.note == SET_RELATION_TRUE) writeIntoCodeFile(" ; result of relational operation true");
+                    else if(instr.note == SET_RELATION_FALSE) writeIntoCodeFile(" ; result of relational operation false");
+                    writeIntoCodeFile("\n");
+                    break;
+                }
+                case IR_JUMP_ZERO:
+                case IR_JUMP_NONZERO:
+                    if(zeroTested != instr.a.id) writeIntoCodeFile("\tcmp ", a, ", 0\n");
+                    writeIntoCodeFile(instr.op == IR_JUMP_ZERO ? "\tje " : "\tjne ", labelText(*ir, instr.c.id), jumpNote(instr.note), "\n");
+                    return;
+                case IR_JUMP_UNLESS:
+                    writeIntoCodeFile("\tcmp ", a, ", ", b, "\n");
+                    writeJumpConditionByRelop(operatorText(Operator(instr.imm)), ir->labels[instr.c.id].number);
+                    return;
+                case IR_ARG: {
+                    int call = registers->savesFor[index];
+                    if(!inRegister(instr.a.id, index)) { // already on top of the stack
+                        if(call < 0) return;
+                        writeIntoCodeFile("\tpop ax\n");
+                        pushSaved(call);
+                        writeIntoCodeFile("\tpush ax\n");
+                        return;
+                    }
+                    if(call >= 0) pushSaved(call);
+                    writeIntoCodeFile("\tpush ", registerName(registers->reg[instr.a.id]), "\n");
+                    return;
+                }
+                case IR_CALL: {
+                    if(registers->savesFor[index] == index) pushSaved(index);
+                    if(instr.c.kind != OPERAND_NONE) {
+                        tailCall(instr);
+                        return;
+                    }
+                    writeIntoCodeFile("\tcall ", atoms.name(instr.a.id), "\n");
+                    const vector<Register> &saved = registers->saved.at(index);
+                    for(auto reg = saved.rbegin(); reg != saved.rend(); reg++) writeIntoCodeFile("\tpop ", registerName(*reg), "\n");
+                    if(evicted >= 0) writeIntoCodeFile("\tpush ", registerName(registers->reg[evicted]), "\n");
+                    if(lastUse[instr.dst.id] < 0) return;
+                    move(target(instr.dst, index), "ax");
+                    break;
+                }
+                case IR_RETURN:
+                    move("ax", a);
+                    writeIntoCodeFile("\tjmp ", labelText(*ir, instr.c.id), "\n");
+                    return;
+                default: // no temporaries
+                    selectInstruction(instr, zeroTested);
+                    return;
+            }
+            made(instr.dst, index);
+        }
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <sstream>
+
+using namespace std;
+
+// Log categories shared by all stages.
+// A category can be switched off at runtime (--log=lexer,parser,symbols,errors selects
+// the ones to keep), or compiled out with -DLOG_DISABLE_<CATEGORY>. -DLOG_PRODUCTION
+// compiles out everything but errors. Log statements are written as
+//     LOG_IF(LOG_LEXER_TOKENS) statement;
+// so a compiled out category leaves no formatting and no calls behind.
+
+enum LogCategory {
+    LOG_LEXER_TOKENS,
+    LOG_PARSER_REDUCTIONS,
+    LOG_SYMBOL_TABLE,
+    LOG_ERRORS,
+    LOG_CATEGORY_COUNT
+};
+
+#ifdef LOG_PRODUCTION
+#define LOG_DISABLE_LEXER_TOKENS
+#define LOG_DISABLE_PARSER_REDUCTIONS
+#define LOG_DISABLE_SYMBOL_TABLE
+#endif
+
+constexpr bool logCompiledIn(LogCategory category) {
+    switch(category) {
+#ifdef LOG_DISABLE_LEXER_TOKENS
+        case LOG_LEXER_TOKENS: return false;
+#endif
+#ifdef LOG_DISABLE_PARSER_REDUCTIONS
+        case LOG_PARSER_REDUCTIONS: return false;
+#endif
+#ifdef LOG_DISABLE_SYMBOL_TABLE
+        case LOG_SYMBOL_TABLE: return false;
+#endif
+#ifdef LOG_DISABLE_ERRORS
+        case LOG_ERRORS: return false;
+#endif
+        default: return true;
+    }
+}
+
+inline bool logRuntimeEnabled[LOG_CATEGORY_COUNT] = {true, true, true, true};
+
+#define LOG_IF(category) if constexpr(logCompiledIn(category)) if(logRuntimeEnabled[category])
+
+inline bool logEnabled(LogCategory category) {
+    return logCompiledIn(category) && logRuntimeEnabled[category];
+}
+
+// keep only the categories named in a comma separated list, returns false on an unknown name
+inline bool selectLogCategories(const string &list) {
+    static const char *names[LOG_CATEGORY_COUNT] = {"lexer", "parser", "symbols", "errors"};
+    for(int i = 0; i < LOG_CATEGORY_COUNT; i++) logRuntimeEnabled[i] = false;
+    stringstream ss(list);
+    string name;
+    while(getline(ss, name, ',')) {
+        if(name.empty()) continue;
+        int i = 0;
+        while(i < LOG_CATEGORY_COUNT && name != names[i]) i++;
+        if(i == LOG_CATEGORY_COUNT) return false;
+        logRuntimeEnabled[i] = true;
+    }
+    return true;
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <charconv>
+#include <exception>
+#include <type_traits>
+#include <algorithm>
+#include <unistd.h>
+
+using namespace std;
+
+// Buffered output file shared by the lexer log, parser log, error log and code file.
+// Messages are formatted straight into a large in-memory buffer; a full buffer is written
+// with a single write, either inline or by an optional background writer thread.
+// Nothing is flushed per message: buffers go out when full, on flush()/close(),
+// when the sink is destroyed at exit, or from the terminate handler on a fatal error.
+class LogSink {
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    FILE *file = nullptr;
+    string buffer;
+
+    bool background = false;
+    thread writer;
+    mutex lock;
+    condition_variable ready, drained;
+    deque<string> pending;
+    bool writing = false, stopping = false;
+
+    // every open sink, so a fatal error can flush them all; sinks are created on
+    // several threads when files are checked in parallel
+    static vector<LogSink *> &sinks() {
+        static vector<LogSink *> all;
+        return all;
+    }
+
+    static mutex &sinksLock() {
+        static mutex lock;
+        return lock;
+    }
+
+    static void installTerminateHandler() {
+        static once_flag installed;
+        call_once(installed, [] {
+            set_terminate([] {
+                flushAll();
+                abort();
+            });
+        });
+    }
+
+    void writeChunk(const string &chunk) {
+        if(!chunk.empty()) fwrite(chunk.data(), 1, chunk.size(), file);
+    }
+
+    void writerLoop() {
+        unique_lock<mutex> guard(lock);
+        while(true) {
+            ready.wait(guard, [this] { return stopping || !pending.empty(); });
+            while(!pending.empty()) {
+                string chunk = std::move(pending.front());
+                pending.pop_front();
+                writing = true;
+                guard.unlock();
+                writeChunk(chunk);
+                guard.lock();
+                writing = false;
+            }
+            drained.notify_all();
+            if(stopping) return;
+        }
+    }
+
+    // pass the filled buffer on to the file
+    void handOff() {
+        if(buffer.empty() || file == nullptr) return;
+        if(background) {
+            string chunk;
+            chunk.reserve(BUFFER_SIZE);
+            chunk.swap(buffer);
+            {
+                lock_guard<mutex> guard(lock);
+                pending.push_back(std::move(chunk));
+            }
+            ready.notify_one();
+        } else {
+            writeChunk(buffer);
+            buffer.clear();
+        }
+    }
+
+    void append(const char *text, size_t length) {
+        buffer.append(text, length);
+        if(buffer.size() >= BUFFER_SIZE) handOff();
+    }
+
+    public:
+        LogSink() {
+            {
+                lock_guard<mutex> guard(sinksLock());
+                sinks().push_back(this);
+            }
+            installTerminateHandler();
+        }
+
+        ~LogSink() {
+            close();
+            lock_guard<mutex> guard(sinksLock());
+            vector<LogSink *> &all = sinks();
+            all.erase(std::remove(all.begin(), all.end(), this), all.end());
+        }
+
+        LogSink(const LogSink &) = delete;
+        LogSink &operator=(const LogSink &) = delete;
+
+        bool open(const string &fileName, bool appendToFile = false, bool backgroundWriter = false) {
+            close();
+            file = fopen(fileName.c_str(), appendToFile ? "a" : "w");
+            if(file == nullptr) return false;
+            setvbuf(file, nullptr, _IONBF, 0); // the sink does its own buffering
+            buffer.reserve(BUFFER_SIZE);
+            background = backgroundWriter;
+            if(background) {
+                stopping = false;
+                writer = thread(&LogSink::writerLoop, this);
+            }
+            return true;
+        }
+
+        bool is_open() const {
+            return file != nullptr;
+        }
+
+        explicit operator bool() const {
+            return file != nullptr;
+        }
+
+        // write out everything buffered so far
+        void flush() {
+            handOff();
+            if(background) {
+                unique_lock<mutex> guard(lock);
+                drained.wait(guard, [this] { return pending.empty() && !writing; });
+            }
+        }
+
+        // throw away everything written so far, the file starts over empty
+        void discard() {
+            if(file == nullptr) return;
+            buffer.clear();
+            if(background) {
+                unique_lock<mutex> guard(lock);
+                pending.clear();
+                drained.wait(guard, [this] { return !writing; });
+            }
+            if(ftruncate(fileno(file), 0) == 0) rewind(file);
+        }
+
+        void close() {
+            if(file == nullptr) return;
+            flush();
+            if(background) {
+                {
+                    lock_guard<mutex> guard(lock);
+                    stopping = true;
+                }
+                ready.notify_one();
+                writer.join();
+                background = false;
+            }
+            fclose(file);
+            file = nullptr;
+        }
+
+        static void flushAll() {
+            lock_guard<mutex> guard(sinksLock());
+            for(LogSink *sink : sinks()) sink->flush();
+        }
+
+        LogSink &operator<<(const string &text) {
+            append(text.data(), text.size());
+            return *this;
+        }
+
+        LogSink &operator<<(const char *text) {
+            append(text, char_traits<char>::length(text));
+            return *this;
+        }
+
+        LogSink &operator<<(char c) {
+            buffer.push_back(c);
+            if(buffer.size() >= BUFFER_SIZE) handOff();
+            return *this;
+        }
+
+        template <typename T, typename enable_if<is_integral<T>::value && !is_same<T, char>::value && !is_same<T, bool>::value, int>::type = 0>
+        LogSink &operator<<(T value) {
+            char digits[24];
+            to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+            append(digits, result.ptr - digits);
+            return *this;
+        }
+};
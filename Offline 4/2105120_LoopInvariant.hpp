@@ -0,0 +1,196 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "2105120_IR.hpp"
+#include "2105120_StrengthReduction.hpp"
+#include "2105120_Loops.hpp"
+
+using namespace std;
+
+// Loop-invariant code motion over the three-address code (-O1).
+// The loops (2105120_Loops.hpp) taken are entered by falling into their label and have no
+// call: the registers living across one are pushed and popped around it, which costs more
+// than the loads saved. An instruction in a loop is invariant when it only makes its
+// temporary and reads
+//  - constants, and temporaries that are invariant or made before the loop
+//  - a variable the loop does not store to or increment
+//  - an element of an array the loop does not store to, at an invariant address
+// Such an instruction runs once in front of the label in place of once per iteration. Its
+// temporary then lives across the whole loop in a register, so a value goes out only
+// while at most two of them live across any loop, which leaves three registers to the
+// expressions in it: the values saving the most go first, and a constant or a constant
+// address alone does not go out, the 8086 takes them as immediates. Loops go innermost
+// first, so a value can leave a nest one loop at a time. Where the allocator can not keep
+// these temporaries in their registers, the caller selects the code as it was before.
+class LoopInvariantMover {
+    public:
+        int hoisted = 0; // instructions moved out of loops
+        int loops = 0;   // loops something was moved out of
+
+        void hoist(IRProgram &program) {
+            ir = &program;
+            forEachLoop(program, [&](const Loop &loop, const vector<Loop> &all) { moveOut(loop, all); });
+        }
+
+    private:
+        static const int MOST_LIVE = 2; // temporaries living across a loop
+
+        IRProgram *ir = nullptr;
+        vector<int> definedAt, definitions;
+
+        void findDefinitions() {
+            definedAt = firstDefinitions(*ir);
+            definitions.assign(ir->temps.size(), 0);
+            for(const Instr &instr : ir->code) {
+                if(instr.dst.kind == OPERAND_TEMP) definitions[instr.dst.id]++;
+            }
+        }
+
+        // roughly what the instruction costs in each iteration
+        int cost(const Instr &instr) const {
+            switch(instr.op) {
+                case IR_CONST: return 0;
+                case IR_ELEMENT: return fixedElement(*ir, instr) ? 0 : 2;
+                case IR_LOAD: return 2;
+                case IR_MUL: case IR_DIV: case IR_MOD: return usesMulDiv(*ir, instr) ? 8 : 2;
+                default: return 1;
+            }
+        }
+
+        // the array of an element's address
+        Atom arrayOf(Operand address) const {
+            return ir->code[definedAt[address.id]].a.id;
+        }
+
+        void moveOut(const Loop &loop, const vector<Loop> &all) {
+            if(!enteredByFallingIn(*ir, loop)) return;
+            findDefinitions();
+            int length = ir->code.size();
+
+            vector<bool> written(ir->variables.size(), false);
+            for(int i = loop.header; i <= loop.back; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_STORE || instr.op == IR_POST_INC || instr.op == IR_POST_DEC) {
+                    written[instr.a.kind == OPERAND_VAR ? instr.a.id : arrayOf(instr.a)] = true;
+                }
+                // a register living across a call is pushed and popped around it, which
+                // costs more than loading the value again
+                else if(instr.op == IR_CALL) return;
+            }
+
+            vector<bool> invariant(ir->temps.size(), false);
+            auto ready = [&](Operand operand) {
+                if(operand.kind != OPERAND_TEMP) return true;
+                if(definitions[operand.id] != 1) return false; // a variable kept in a register
+                return definedAt[operand.id] < loop.header || invariant[operand.id];
+            };
+            for(int i = loop.header + 1; i < loop.back; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.dst.kind != OPERAND_TEMP || definitions[instr.dst.id] != 1) continue;
+                bool is = false;
+                switch(instr.op) {
+                    case IR_CONST:
+                        is = true;
+                        break;
+                    case IR_LOAD:
+                        if(instr.a.kind == OPERAND_VAR) is = !written[instr.a.id];
+                        else is = ready(instr.a) && !written[arrayOf(instr.a)];
+                        break;
+                    case IR_ELEMENT:
+                        is = ready(instr.b);
+                        break;
+                    case IR_COPY:
+                    case IR_NEG:
+                        is = ready(instr.a);
+                        break;
+                    case IR_ADD:
+                    case IR_SUB:
+                    case IR_MUL:
+                    case IR_RELATION:
+                        is = ready(instr.a) && ready(instr.b);
+                        break;
+                    case IR_DIV:
+                    case IR_MOD: // by a temporary it may fault
+                        is = ready(instr.a) && instr.b.kind == OPERAND_CONST;
+                        break;
+                    default:
+                        break;
+                }
+                invariant[instr.dst.id] = is;
+            }
+
+            // a value goes out with the invariant values it is made of
+            vector<bool> moving(length, false);
+            auto gather = [&](int t, vector<int> &tree, auto &self) -> void {
+                int at = definedAt[t];
+                if(at <= loop.header || moving[at] || find(tree.begin(), tree.end(), at) != tree.end()) return;
+                tree.push_back(at);
+                for(const Operand *operand : {&ir->code[at].a, &ir->code[at].b}) {
+                    if(operand->kind == OPERAND_TEMP && invariant[operand->id]) self(operand->id, tree, self);
+                }
+            };
+            // the moved temporaries in registers read by what stays in the loop
+            auto crossing = [&]() {
+                vector<bool> counted(ir->temps.size(), false);
+                int count = 0;
+                for(int i = loop.header; i <= loop.back; i++) {
+                    if(moving[i]) continue;
+                    const Instr &instr = ir->code[i];
+                    for(const Operand *operand : {&instr.a, &instr.b}) {
+                        if(operand->kind != OPERAND_TEMP || counted[operand->id]) continue;
+                        int at = definedAt[operand->id];
+                        if(!moving[at] || fixedElement(*ir, ir->code[at])) continue;
+                        counted[operand->id] = true;
+                        count++;
+                    }
+                }
+                return count;
+            };
+            int room = MOST_LIVE - mostLiveAcross(*ir, definedAt, loop, all);
+            // the values read by what stays in the loop, the ones saving the most first
+            vector<pair<int, vector<int>>> roots; // saving and instructions
+            vector<bool> seen(ir->temps.size(), false);
+            for(int i = loop.header + 1; i <= loop.back; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.dst.kind == OPERAND_TEMP && invariant[instr.dst.id]) continue; // goes out with its user, if at all
+                for(const Operand *operand : {&instr.a, &instr.b}) {
+                    if(operand->kind != OPERAND_TEMP || !invariant[operand->id] || seen[operand->id]) continue;
+                    seen[operand->id] = true;
+                    const Instr &value = ir->code[definedAt[operand->id]];
+                    if(value.op == IR_CONST || fixedElement(*ir, value)) continue;
+                    vector<int> tree;
+                    gather(operand->id, tree, gather);
+                    int saving = 0;
+                    for(int at : tree) saving += cost(ir->code[at]);
+                    roots.push_back({saving, tree});
+                }
+            }
+            stable_sort(roots.begin(), roots.end(), [](const pair<int, vector<int>> &x, const pair<int, vector<int>> &y) { return x.first > y.first; });
+            for(const pair<int, vector<int>> &root : roots) {
+                for(int at : root.second) moving[at] = true;
+                if(crossing() > room) {
+                    for(int at : root.second) moving[at] = false;
+                }
+            }
+
+            int count = 0;
+            vector<Instr> code;
+            code.reserve(length);
+            for(int i = 0; i < length; i++) {
+                if(i == loop.header) {
+                    for(int k = loop.header; k <= loop.back; k++) {
+                        if(moving[k]) code.push_back(ir->code[k]);
+                    }
+                }
+                if(moving[i]) {
+                    count++;
+                    continue;
+                }
+                code.push_back(ir->code[i]);
+            }
+            ir->code = move(code);
+            hoisted += count;
+            if(count > 0) loops++;
+        }
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "2105120_IR.hpp"
+#include "2105120_StrengthReduction.hpp"
+
+using namespace std;
+
+// The loops of the three-address code, for the passes that work on whole loops (-O1).
+// A loop is a label and the last jump back to it. The builder only writes loops entered
+// by falling into their label; a pass that puts code in front of the label checks that,
+// and leaves any other loop alone. A temporary made in front of a loop and read inside
+// it lives up to the jump back, in a register all along (2105120_RegisterAllocator.hpp).
+
+struct Loop {
+    int header; // the label
+    int back;   // the last jump to it
+};
+
+inline bool isJump(Opcode op) {
+    return op == IR_JUMP || op == IR_JUMP_ZERO || op == IR_JUMP_NONZERO || op == IR_JUMP_UNLESS;
+}
+
+inline vector<Loop> findLoops(const IRProgram &program) {
+    vector<Loop> result;
+    vector<int> labelAt(program.labels.size(), -1);
+    for(int i = 0; i < (int)program.code.size(); i++) {
+        const Instr &instr = program.code[i];
+        if(instr.op == IR_LABEL) labelAt[instr.c.id] = i;
+        else if(isJump(instr.op)) {
+            int at = labelAt[instr.c.id];
+            if(at < 0) continue; // forward
+            bool known = false;
+            for(Loop &loop : result) {
+                if(loop.header != at) continue;
+                loop.back = i;
+                known = true;
+            }
+            if(!known) result.push_back(Loop{at, i});
+        }
+    }
+    return result;
+}
+
+// visits the loops innermost first, an inner loop being shorter than the loops around
+// it; visit(loop, loops) may move the code, so the loops are found again for each
+template<class Visit>
+void forEachLoop(IRProgram &program, Visit visit) {
+    vector<Loop> found = findLoops(program);
+    sort(found.begin(), found.end(), [](const Loop &x, const Loop &y) { return x.back - x.header < y.back - y.header; });
+    vector<Operand> headers;
+    for(const Loop &loop : found) headers.push_back(program.code[loop.header].c);
+    for(Operand label : headers) {
+        found = findLoops(program);
+        for(const Loop &loop : found) {
+            if(program.code[loop.header].c == label) {
+                visit(loop, found);
+                break;
+            }
+        }
+    }
+}
+
+// the loop is only entered through its label, by falling into it
+inline bool enteredByFallingIn(const IRProgram &program, const Loop &loop) {
+    int before = loop.header - 1;
+    while(before >= 0 && program.code[before].op == IR_NOTE) before--;
+    if(before < 0 || program.code[before].op == IR_JUMP || program.code[before].op == IR_RETURN) return false;
+    for(int i = 0; i < (int)program.code.size(); i++) {
+        const Instr &instr = program.code[i];
+        if(i >= loop.header && i <= loop.back) continue;
+        if(!isJump(instr.op)) continue;
+        for(int k = loop.header; k <= loop.back; k++) {
+            if(program.code[k].op == IR_LABEL && program.code[k].c == instr.c) return false;
+        }
+    }
+    return true;
+}
+
+// the first definition of each temporary, -1 for none
+inline vector<int> firstDefinitions(const IRProgram &program) {
+    vector<int> result(program.temps.size(), -1);
+    for(int i = 0; i < (int)program.code.size(); i++) {
+        const Instr &instr = program.code[i];
+        if(instr.dst.kind == OPERAND_TEMP && result[instr.dst.id] < 0) result[instr.dst.id] = i;
+    }
+    return result;
+}
+
+// the last read of each temporary, a temporary read in a loop living up to its jump back
+inline vector<int> lastReads(const IRProgram &program, const vector<int> &definedAt, const vector<Loop> &loops) {
+    vector<int> last(program.temps.size(), -1);
+    for(int i = 0; i < (int)program.code.size(); i++) {
+        const Instr &instr = program.code[i];
+        for(const Operand *operand : {&instr.a, &instr.b}) {
+            if(operand->kind == OPERAND_TEMP) last[operand->id] = i;
+        }
+    }
+    bool grown = true;
+    while(grown) {
+        grown = false;
+        for(const Loop &loop : loops) {
+            for(int t = 0; t < (int)last.size(); t++) {
+                if(definedAt[t] < loop.header && last[t] >= loop.header && last[t] < loop.back) {
+                    last[t] = loop.back;
+                    grown = true;
+                }
+            }
+        }
+    }
+    return last;
+}
+
+// temporaries in registers living at the instruction at index: made before it and read at
+// or after it, or inside a loop around it
+inline int liveAt(const IRProgram &program, const vector<int> &definedAt, const vector<int> &last, int index) {
+    int count = 0;
+    for(int t = 0; t < (int)last.size(); t++) {
+        if(definedAt[t] < 0 || fixedElement(program, program.code[definedAt[t]])) continue;
+        if(definedAt[t] < index && last[t] >= index) count++;
+    }
+    return count;
+}
+
+// the most temporaries living across the loop or a loop inside it
+inline int mostLiveAcross(const IRProgram &program, const vector<int> &definedAt, const Loop &loop, const vector<Loop> &loops) {
+    vector<int> last = lastReads(program, definedAt, loops);
+    int most = 0;
+    for(const Loop &inner : loops) {
+        if(inner.header >= loop.header && inner.back <= loop.back) most = max(most, liveAt(program, definedAt, last, inner.header));
+    }
+    return most;
+}
+
+// the most temporaries living at any instruction of the loop
+inline int mostLive(const IRProgram &program, const vector<int> &definedAt, const Loop &loop, const vector<Loop> &loops) {
+    vector<int> last = lastReads(program, definedAt, loops);
+    int most = 0;
+    for(int i = loop.header; i <= loop.back; i++) most = max(most, liveAt(program, definedAt, last, i));
+    return most;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "2105120_IR.hpp"
+#include "2105120_ConstantFolding.hpp"
+#include "2105120_DeadCode.hpp"
+#include "2105120_Inliner.hpp"
+#include "2105120_TailCalls.hpp"
+#include "2105120_FrameLayout.hpp"
+#include "2105120_RegisterPromotion.hpp"
+#include "2105120_LoopInvariant.hpp"
+#include "2105120_RegisterAllocator.hpp"
+#include "2105120_InstructionSelector.hpp"
+
+using namespace std;
+
+// -O levels of the --ast code generator. -O0 selects the three-address code as the grammar
+// actions would write it; -O1 lowers conditions to jumps, folds constants, removes dead
+// code, inlines small functions and the ones called once, makes calls in tail position
+// jumps, reserves each frame at once, keeps the temporaries in registers and strength
+// reduces what has a constant operand, tests loop conditions at the bottom, unrolls loops
+// counted to a constant, keeps the variables a loop changes in registers and moves
+// loop-invariant values in front of loops.
+struct OptimizeOptions {
+    int level = 0;
+    bool registers = false; // temporaries in registers
+    bool orderByNeed = false; // the operand needing more registers lowered first
+    bool fold = false; // constant folding and propagation
+    bool deadCode = false; // dead and unreachable code elimination
+    bool inlining = false; // calls of small functions and of functions called once replaced by their bodies
+    bool tailCalls = false; // calls in tail position made jumps, reusing the frame
+    bool frames = false; // one declaration for the whole frame, no bp where nothing needs it
+    bool jumping = false; // conditions lowered to jumps
+    bool branchless = false; // 1 or 0 of a condition without jumps
+    bool rotate = false; // loop conditions tested at the bottom
+    bool promote = false; // variables changed in loops kept in registers, with registers
+    bool hoist = false; // loop-invariant code motion, with registers
+    int unrollBudget = 0; // AST nodes a counted loop may be copied into, 0 for none
+};
+
+inline OptimizeOptions optimizeLevel(int level) {
+    OptimizeOptions options;
+    options.level = level;
+    options.registers = options.orderByNeed = options.fold = options.deadCode = options.inlining = options.tailCalls =
+        options.frames = options.jumping = options.branchless = options.rotate = options.promote = options.hoist = level > 0;
+    options.unrollBudget = level > 0 ? 64 : 0;
+    return options;
+}
+
+// what the passes did, printed with --stats
+struct OptimizeReport {
+    int constantsFolded = 0;
+    int loadsPropagated = 0;
+    int branchesFolded = 0;
+    int instructionsRemoved = 0;
+    vector<pair<string, int>> deadCodeByFunction; // instructions removed as dead or unreachable
+    int callsInlined = 0;
+    int functionsInlinedAway = 0; // removed, every call of them inlined
+    int inliningGrowth = 0;       // instructions added by inlining
+    vector<pair<string, string>> inliningDecisions; // each called function and what became of its calls
+    int tailCallsToSelf = 0;      // a function calling itself, made a jump to its top
+    int tailCallsToOthers = 0;    // made a jump to the function, which returns to the caller
+    vector<pair<string, pair<int, int>>> frameSizes; // bytes of locals each function reserved, before and after
+    int framesBefore = 0, framesAfter = 0;
+    int framelessFunctions = 0;   // without bp: no locals, parameters or calls
+    int tempsInRegisters = 0;
+    int tempsSpilled = 0;
+    int registersSavedAtCalls = 0;
+    int functionsUnallocated = 0;
+    int strengthReduced = 0;      // mul, div and mod by constants without mul or div
+    int divisionsByReciprocal = 0;
+    int constantAddresses = 0;    // elements at constant indices
+    int variablesPromoted = 0;    // kept in registers over loops
+    int loopsPromotedIn = 0;
+    int invariantsHoisted = 0;    // instructions moved in front of loops
+    int loopsHoistedFrom = 0;
+    int loopsUnrolled = 0;        // copied out in full
+    int loopsPartiallyUnrolled = 0;
+};
+
+inline void countReductions(const IRProgram &ir, const Allocation &allocation, OptimizeReport &report) {
+    for(int i = 0; i < (int)ir.code.size(); i++) {
+        const Instr &instr = ir.code[i];
+        if(allocation.unallocated[i]) continue;
+        if(fixedElement(ir, instr)) report.constantAddresses++;
+        else if(instr.op == IR_MUL || instr.op == IR_DIV || instr.op == IR_MOD) {
+            if(instr.b.kind != OPERAND_CONST) continue;
+            if(!usesMulDiv(ir, instr)) report.strengthReduced++;
+            else if(instr.op == IR_DIV) report.divisionsByReciprocal++;
+        }
+    }
+}
+
+inline void generateCode(IRProgram &ir, const OptimizeOptions &options, OptimizeReport &report) {
+    ConstantFolder folder;
+    DeadCodeEliminator deadCode;
+    auto simplify = [&]() {
+        bool changed = options.fold || options.deadCode;
+        while(changed) { // a folded branch leaves dead code, and removing it can make a relation known
+            changed = options.fold && folder.fold(ir);
+            if(options.deadCode) changed = deadCode.eliminate(ir) || changed;
+        }
+    };
+    simplify();
+    if(options.inlining) { // bodies without their dead code, then folded with the known arguments
+        FunctionInliner inliner;
+        inliner.inlineCalls(ir);
+        report.callsInlined = inliner.inlined;
+        report.functionsInlinedAway = inliner.removed;
+        report.inliningGrowth = inliner.growth;
+        report.inliningDecisions = inliner.decisions;
+        if(inliner.inlined > 0) simplify();
+    }
+    if(options.tailCalls) { // after inlining, which leaves the recursive functions
+        TailCallEliminator tailCalls;
+        tailCalls.eliminate(ir);
+        report.tailCallsToSelf = tailCalls.selfCalls;
+        report.tailCallsToOthers = tailCalls.otherCalls;
+    }
+    if(options.frames) {
+        FrameLayout layout;
+        layout.layOut(ir);
+        report.frameSizes = layout.frames;
+        report.framesBefore = layout.before;
+        report.framesAfter = layout.after;
+        report.framelessFunctions = layout.frameless;
+    }
+    report.constantsFolded = folder.folded;
+    report.loadsPropagated = folder.propagated;
+    report.branchesFolded = folder.branchesRemoved;
+    report.instructionsRemoved = folder.removed + deadCode.removed;
+    for(Atom function : deadCode.functions) {
+        report.deadCodeByFunction.push_back({atoms.name(function), deadCode.removedIn[function]});
+    }
+    if(!options.registers) {
+        InstructionSelector().select(ir);
+        return;
+    }
+    IRProgram unhoisted;
+    if(options.promote || options.hoist) unhoisted = ir;
+    if(options.hoist) {
+        LoopInvariantMover mover;
+        mover.hoist(ir);
+        report.invariantsHoisted = mover.hoisted;
+        report.loopsHoistedFrom = mover.loops;
+    }
+    if(options.promote) {
+        ScalarPromoter promoter;
+        promoter.promote(ir);
+        report.variablesPromoted = promoter.promoted;
+        report.loopsPromotedIn = promoter.loops;
+    }
+    Allocation allocation = RegisterAllocator().allocate(ir);
+    if(allocation.loopSpilled && (options.promote || options.hoist)) { // a promoted or moved value has no register up to its loop's end
+        ir = move(unhoisted);
+        report.variablesPromoted = report.loopsPromotedIn = 0;
+        report.invariantsHoisted = report.loopsHoistedFrom = 0;
+        allocation = RegisterAllocator().allocate(ir);
+    }
+    report.tempsInRegisters = allocation.inRegisters;
+    report.tempsSpilled = allocation.spilled;
+    report.registersSavedAtCalls = allocation.savedRegisters;
+    report.functionsUnallocated = allocation.unallocatedFunctions;
+    countReductions(ir, allocation, report);
+    InstructionSelector().select(ir, &allocation);
+}
+
+inline void printOptimizeReport(ostream &out, const OptimizeReport &report) {
+    out << "constants folded: " << report.constantsFolded << endl;
+    out << "loads of known constants: " << report.loadsPropagated << endl;
+    out << "branches folded: " << report.branchesFolded << endl;
+    out << "three-address instructions removed: " << report.instructionsRemoved << endl;
+    for(const pair<string, int> &function : report.deadCodeByFunction) {
+        if(function.second > 0) out << "  dead or unreachable in " << function.first << ": " << function.second << endl;
+    }
+    out << "calls inlined: " << report.callsInlined << ", functions removed: " << report.functionsInlinedAway
+        << ", instructions added: " << report.inliningGrowth << endl;
+    for(const pair<string, string> &decision : report.inliningDecisions) out << "  " << decision.first << ": " << decision.second << endl;
+    out << "tail calls made jumps: " << report.tailCallsToSelf << " to the function itself, " << report.tailCallsToOthers << " to another" << endl;
+    out << "bytes of locals reserved: " << report.framesBefore << " -> " << report.framesAfter
+        << ", functions without bp: " << report.framelessFunctions << endl;
+    for(const pair<string, pair<int, int>> &frame : report.frameSizes) {
+        if(frame.second.first != frame.second.second) out << "  " << frame.first << ": " << frame.second.first << " -> " << frame.second.second << endl;
+    }
+    out << "temporaries in registers: " << report.tempsInRegisters << endl;
+    out << "temporaries spilled: " << report.tempsSpilled << endl;
+    out << "registers saved at calls: " << report.registersSavedAtCalls << endl;
+    out << "mul, div and mod by constants strength reduced: " << report.strengthReduced << endl;
+    out << "divisions by a reciprocal: " << report.divisionsByReciprocal << endl;
+    out << "elements at constant addresses: " << report.constantAddresses << endl;
+    out << "loops unrolled: " << report.loopsUnrolled << ", partially: " << report.loopsPartiallyUnrolled << endl;
+    out << "variables promoted to registers: " << report.variablesPromoted << " in " << report.loopsPromotedIn << " loops" << endl;
+    out << "loop-invariant instructions hoisted: " << report.invariantsHoisted << " from " << report.loopsHoistedFrom << " loops" << endl;
+    if(report.functionsUnallocated > 0) out << "functions left at -O0: " << report.functionsUnallocated << endl;
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "2105120_IR.hpp"
+#include "2105120_StrengthReduction.hpp"
+
+using namespace std;
+
+// Linear-scan register allocation for the temporaries of the three-address code (-O1).
+// A temporary lives from its first definition to its last use; the intervals are walked
+// in order of their start and each one takes a free register of bx, cx, dx, si and di.
+// ax is left out: it is where mul, div and calls leave their results and where
+// print_output takes its argument, so the selector uses it as a scratch register.
+//  - dx is not given to a temporary that lives across a mul or div, which write dx:ax
+//  - the element at a constant index has a constant address and takes no register
+//  - the address of an array element is an index register: si or di, or bx for a global
+//    array (name[bx]); [bp - n - bx] cannot be encoded
+//  - a called function may change every register, so the registers live across a call
+//    are pushed before its first argument and popped after it returns
+// When no register is free the temporary (the current one, or a live one) that is used
+// last is spilled: pushed, and popped where it is used. Temporaries of one expression are
+// used in the reverse order of their definitions, so the pops always find theirs on top.
+// A live temporary is only pushed when no label lies within its interval, so every path
+// to its uses passes the push. Inside the argument list of a call it is not pushed either,
+// that would land between the arguments; one that lives across the call is already saved
+// and gives up its register until the call returns instead.
+// Element addresses are never pushed, an index register would be needed to pop one into;
+// a function where the allocation still needs that, or an instruction with both operands
+// on the stack, is left to the -O0 code.
+// A temporary read inside a loop it is made in front of lives up to the jump back, and
+// has to stay in its register all along: neither a push nor the -O0 code keeps it for the
+// next iteration, so loopSpilled tells the caller when it does not.
+
+enum Register : signed char {
+    REG_NONE = -1, REG_BX, REG_CX, REG_DX, REG_SI, REG_DI, REGISTER_COUNT
+};
+
+inline const char *registerName(Register reg) {
+    static const char *names[] = {"bx", "cx", "dx", "si", "di"};
+    return names[reg];
+}
+
+struct Allocation {
+    vector<Register> reg;   // REG_NONE for a temporary spilled from its definition on
+    vector<int> spillAt;    // instruction before which a temporary in a register is pushed, -1 for none
+    vector<int> spillBefore; // per instruction: the temporary pushed before it, -1 for none
+    vector<int> savesFor;   // per instruction: the call whose saved registers are pushed before it, -1 for none
+    unordered_map<int, vector<Register>> saved; // per call: the registers pushed around it
+    vector<bool> unallocated; // per instruction: in a function selected as at -O0
+    bool loopSpilled = false; // a temporary living across a loop is not in a register all along
+    int inRegisters = 0, spilled = 0, savedRegisters = 0, unallocatedFunctions = 0;
+};
+
+class RegisterAllocator {
+    public:
+        Allocation allocate(const IRProgram &program) {
+            ir = &program;
+            int temps = program.temps.size(), length = program.code.size();
+            Allocation result;
+            result.reg.assign(temps, REG_NONE);
+            result.spillAt.assign(temps, -1);
+            result.spillBefore.assign(length, -1);
+            result.savesFor.assign(length, -1);
+            result.unallocated.assign(length, false);
+
+            findIntervals();
+            findCalls();
+
+            vector<int> order;
+            for(int t = 0; t < temps; t++) if(start[t] >= 0) order.push_back(t);
+            sort(order.begin(), order.end(), [&](int x, int y) { return start[x] < start[y]; });
+
+            vector<int> holder(REGISTER_COUNT, -1); // temporary in each register
+            vector<pair<int, int>> suspended; // temporary and the call after which it is back
+            for(int t : order) {
+                int at = start[t];
+                // back from a call that saved it
+                for(size_t k = 0; k < suspended.size();) {
+                    if(suspended[k].second <= at) {
+                        holder[result.reg[suspended[k].first]] = suspended[k].first;
+                        suspended.erase(suspended.begin() + k);
+                    }
+                    else k++;
+                }
+                for(int r = 0; r < REGISTER_COUNT; r++) {
+                    if(holder[r] >= 0 && end[holder[r]] <= at) holder[r] = -1;
+                }
+
+                Register reg = freeRegister(t, holder, result);
+                if(reg == REG_NONE) {
+                    // the live temporary used last gives up its register, unless the
+                    // current one is used later still
+                    int victim = -1;
+                    bool victimSaved = false;
+                    int argsFrom = openArguments[at];
+                    for(int r = 0; r < REGISTER_COUNT; r++) {
+                        int other = holder[r];
+                        if(other < 0 || !allowed(t, Register(r))) continue;
+                        bool saved = argsFrom >= 0 && start[other] < argsFrom;
+                        if(saved ? uses[other] > 1 : !pushable(other)) continue; // uses > 1: may be read inside the arguments
+                        if(victim < 0 || end[other] > end[victim]) {
+                            victim = other;
+                            victimSaved = saved;
+                        }
+                    }
+                    if(victim >= 0 && end[victim] >= end[t]) {
+                        reg = result.reg[victim];
+                        holder[reg] = -1;
+                        if(victimSaved) suspended.push_back({victim, callAround(at, argsFrom)});
+                        else {
+                            result.spillAt[victim] = at;
+                            result.spillBefore[at] = victim;
+                            result.spilled++;
+                        }
+                    }
+                }
+                if(reg == REG_NONE) {
+                    result.spillAt[t] = at;
+                    result.spilled++;
+                    continue;
+                }
+                result.reg[t] = reg;
+                holder[reg] = t;
+                result.inRegisters++;
+            }
+
+            // registers live across each call
+            for(const CallSite &call : calls) {
+                result.savesFor[call.firstArgument] = call.call;
+                vector<Register> &saved = result.saved[call.call];
+                for(int t = 0; t < temps; t++) {
+                    if(start[t] < 0 || result.reg[t] == REG_NONE) continue;
+                    if(start[t] >= call.firstArgument || end[t] <= call.call) continue;
+                    if(result.spillAt[t] >= 0 && result.spillAt[t] < call.firstArgument) continue;
+                    saved.push_back(result.reg[t]);
+                }
+                result.savedRegisters += saved.size();
+            }
+            checkFunctions(result);
+            for(int t = 0; t < temps; t++) {
+                if(!acrossLoop[t]) continue;
+                if(result.reg[t] == REG_NONE || result.spillAt[t] >= 0 || result.unallocated[start[t]]) result.loopSpilled = true;
+            }
+            return result;
+        }
+
+    private:
+        struct CallSite {
+            int firstArgument; // the call itself when it has no arguments
+            int call;
+        };
+
+        const IRProgram *ir = nullptr;
+        vector<int> start, end, uses;
+        vector<bool> acrossLoop; // lives across a label after its start that is jumped back to
+        vector<int> mulDivBefore; // number of mul and div instructions before each instruction
+        vector<int> labelsBefore; // number of labels before each instruction
+        vector<CallSite> calls;
+        vector<int> openArguments; // per instruction: first argument of the innermost call whose arguments are being pushed, -1 for none
+
+        void findIntervals() {
+            int temps = ir->temps.size(), length = ir->code.size();
+            start.assign(temps, -1);
+            end.assign(temps, -1);
+            uses.assign(temps, 0);
+            mulDivBefore.assign(length + 1, 0);
+            labelsBefore.assign(length + 1, 0);
+            for(int i = 0; i < length; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.dst.kind == OPERAND_TEMP && !fixedElement(*ir, instr)) {
+                    int t = instr.dst.id;
+                    if(start[t] < 0) start[t] = i;
+                    end[t] = max(end[t], i);
+                }
+                for(const Operand *operand : {&instr.a, &instr.b}) {
+                    if(operand->kind != OPERAND_TEMP || start[operand->id] < 0) continue;
+                    end[operand->id] = max(end[operand->id], i);
+                    uses[operand->id]++;
+                }
+                mulDivBefore[i + 1] = mulDivBefore[i] + usesMulDiv(*ir, instr);
+                labelsBefore[i + 1] = labelsBefore[i] + (instr.op == IR_LABEL);
+            }
+            extendAcrossLoops();
+        }
+
+        // a temporary read in a loop that starts after it is read again in the next iteration
+        void extendAcrossLoops() {
+            int temps = ir->temps.size(), length = ir->code.size();
+            acrossLoop.assign(temps, false);
+            vector<pair<int, int>> loops; // label and a jump back to it
+            vector<int> labelAt(ir->labels.size(), -1);
+            for(int i = 0; i < length; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_LABEL) labelAt[instr.c.id] = i;
+                else if(instr.c.kind == OPERAND_LABEL && instr.op != IR_FUNC_BEGIN && labelAt[instr.c.id] >= 0) loops.push_back({labelAt[instr.c.id], i});
+            }
+            bool grown = true;
+            while(grown) { // the loops around one may grow it again
+                grown = false;
+                for(const pair<int, int> &loop : loops) {
+                    for(int t = 0; t < temps; t++) {
+                        if(start[t] < 0 || start[t] >= loop.first || end[t] < loop.first) continue;
+                        acrossLoop[t] = true;
+                        if(end[t] >= loop.second) continue;
+                        end[t] = loop.second;
+                        grown = true;
+                    }
+                }
+            }
+        }
+
+        void findCalls() {
+            int length = ir->code.size();
+            calls.clear();
+            openArguments.assign(length, -1);
+            vector<int> arguments;
+            for(int i = 0; i < length; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_ARG) arguments.push_back(i);
+                else if(instr.op == IR_CALL) {
+                    int count = min<int>(instr.imm, arguments.size());
+                    int first = count > 0 ? arguments[arguments.size() - count] : i;
+                    arguments.resize(arguments.size() - count);
+                    calls.push_back(CallSite{first, i});
+                    // calls nest, so an inner call marks its range after the outer one
+                    for(int k = first + 1; k < i; k++) openArguments[k] = max(openArguments[k], first);
+                }
+            }
+        }
+
+        // the innermost call whose arguments start at argsFrom and are open at the instruction
+        int callAround(int at, int argsFrom) const {
+            for(const CallSite &call : calls) {
+                if(call.firstArgument == argsFrom && call.call > at) return call.call;
+            }
+            return at;
+        }
+
+        bool pushable(int t) const {
+            return ir->temps[t] == TEMP_WORD && labelsBefore[end[t] + 1] == labelsBefore[start[t] + 1];
+        }
+
+        bool onStack(const Allocation &result, Operand operand, int at) const {
+            if(operand.kind != OPERAND_TEMP) return false;
+            int spillAt = result.spillAt[operand.id];
+            return spillAt >= 0 && spillAt <= at;
+        }
+
+        void checkFunctions(Allocation &result) const {
+            int length = ir->code.size();
+            for(int begin = 0; begin < length; begin++) {
+                if(ir->code[begin].op != IR_FUNC_BEGIN) continue;
+                int end = begin;
+                bool fails = false;
+                for(; end < length && ir->code[end].op != IR_FUNC_END; end++) {
+                    const Instr &instr = ir->code[end];
+                    if(onStack(result, instr.a, end) && onStack(result, instr.b, end)) fails = true;
+                    if(instr.dst.kind == OPERAND_TEMP && ir->temps[instr.dst.id] == TEMP_ADDRESS && result.spillAt[instr.dst.id] >= 0) fails = true;
+                }
+                if(!fails) continue;
+                for(int i = begin; i <= end && i < length; i++) result.unallocated[i] = true;
+                result.unallocatedFunctions++;
+                begin = end;
+            }
+        }
+
+        bool allowed(int t, Register reg) const {
+            if(ir->temps[t] == TEMP_ADDRESS) {
+                if(reg == REG_SI || reg == REG_DI) return true;
+                if(reg != REG_BX) return false;
+                // only a global array can be indexed by bx
+                const Instr &element = ir->code[start[t]];
+                return element.a.kind != OPERAND_VAR || ir->variables[element.a.id].storage == STORAGE_GLOBAL;
+            }
+            if(reg == REG_DX) return mulDivBefore[end[t] + 1] == mulDivBefore[start[t] + 1];
+            return true;
+        }
+
+        // a free register, the one an operand of the defining instruction just left if possible
+        Register freeRegister(int t, const vector<int> &holder, const Allocation &result) const {
+            const Instr &instr = ir->code[start[t]];
+            for(const Operand *operand : {&instr.a, &instr.b}) {
+                if(operand->kind != OPERAND_TEMP) continue;
+                Register reg = result.reg[operand->id];
+                if(reg != REG_NONE && holder[reg] < 0 && allowed(t, reg) && result.spillAt[operand->id] < 0) return reg;
+            }
+            // addresses first in si and di, words first in the others
+            static const Register words[] = {REG_BX, REG_CX, REG_DX, REG_SI, REG_DI};
+            static const Register addresses[] = {REG_SI, REG_DI, REG_BX, REG_CX, REG_DX};
+            const Register *preference = ir->temps[t] == TEMP_ADDRESS ? addresses : words;
+            for(int k = 0; k < REGISTER_COUNT; k++) {
+                Register reg = preference[k];
+                if(holder[reg] < 0 && allowed(t, reg)) return reg;
+            }
+            return REG_NONE;
+        }
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "2105120_IR.hpp"
+#include "2105120_Loops.hpp"
+
+using namespace std;
+
+// Register promotion of the scalar variables a loop changes (-O1).
+// A local, parameter or global the loop stores to or increments is kept in a temporary
+// for the span of the loop, which the allocator keeps in a register up to the jump back:
+//  - it is loaded in front of the label, unless the loop stores to it before anything
+//    can read it, and stored back after the jump back, unless no path from there reads
+//    it again: a local or a parameter read neither after the loop in its function nor
+//    in a loop around it, by that loop or by the load in front of this one
+//  - in the loop a load of it becomes its temporary, or a copy of it when the temporary
+//    changes before the value is used; a store becomes a copy into it and ++ and -- an
+//    add or sub; println, which reads memory, stores it first
+// The loops taken (2105120_Loops.hpp) are entered by falling into their label and only
+// left by falling out of the jump back, or by a return, but not with a global in a
+// register. They have no call: a called function may read or change a global, and the
+// allocator would push and pop the registers around it on every iteration. The variables
+// used most go first, while at most three temporaries live across any loop, counting the
+// values 2105120_LoopInvariant.hpp moved out before this, and at most four at any point
+// in it: an expression spilled in a loop would cost more than the loads saved.
+class ScalarPromoter {
+    public:
+        int promoted = 0; // variables kept in registers over a loop
+        int loops = 0;    // loops they were kept over
+
+        void promote(IRProgram &program) {
+            ir = &program;
+            forEachLoop(program, [&](const Loop &loop, const vector<Loop> &all) { promoteIn(loop, all); });
+        }
+
+    private:
+        static const int MOST_LIVE = 3; // temporaries living across a loop
+        static const int MOST_BUSY = 4; // temporaries living at once in it, one register left for a result
+
+        IRProgram *ir = nullptr;
+
+        bool scalar(Operand operand) const {
+            return operand.kind == OPERAND_VAR && ir->variables[operand.id].length < 0;
+        }
+
+        static bool reads(const Instr &instr, Operand var) {
+            return instr.a == var && (instr.op == IR_LOAD || instr.op == IR_POST_INC || instr.op == IR_POST_DEC || instr.op == IR_PRINT);
+        }
+
+        static bool writes(const Instr &instr, Operand var) {
+            return instr.a == var && (instr.op == IR_STORE || instr.op == IR_POST_INC || instr.op == IR_POST_DEC);
+        }
+
+        // a path from the end of the loop may read the variable
+        bool liveAfter(const Loop &loop, const vector<Loop> &all, Operand var) const {
+            if(ir->variables[var.id].storage == STORAGE_GLOBAL) return true;
+            int end = loop.back;
+            while(ir->code[end].op != IR_FUNC_END) end++;
+            for(int i = loop.back + 1; i < end; i++) {
+                if(reads(ir->code[i], var)) return true;
+            }
+            for(const Loop &around : all) { // read again in a later iteration
+                if(around.header >= loop.header || around.back <= loop.back) continue;
+                if(!storedFirst(loop, var)) return true; // by the load in front of this loop
+                for(int i = around.header; i < loop.header; i++) {
+                    if(reads(ir->code[i], var)) return true;
+                }
+            }
+            return false;
+        }
+
+        // the loop stores to the variable before anything in it can read it
+        bool storedFirst(const Loop &loop, Operand var) const {
+            for(int i = loop.header + 1; i <= loop.back; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_LABEL || isJump(instr.op) || instr.op == IR_RETURN) return false;
+                if(instr.a == var) return instr.op == IR_STORE;
+            }
+            return false;
+        }
+
+        void promoteIn(const Loop &loop, const vector<Loop> &all) {
+            if(!enteredByFallingIn(*ir, loop)) return;
+            vector<int> labelAt(ir->labels.size(), -1);
+            for(int i = 0; i < (int)ir->code.size(); i++) {
+                if(ir->code[i].op == IR_LABEL) labelAt[ir->code[i].c.id] = i;
+            }
+            bool returns = false;
+            vector<int> uses(ir->variables.size(), 0);
+            vector<bool> written(ir->variables.size(), false);
+            for(int i = loop.header; i <= loop.back; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.op == IR_CALL) return;
+                if(instr.op == IR_RETURN) returns = true;
+                else if(isJump(instr.op)) {
+                    int at = labelAt[instr.c.id];
+                    if(at < loop.header || at > loop.back) return; // leaves the loop
+                }
+                if(!scalar(instr.a)) continue;
+                uses[instr.a.id]++;
+                if(writes(instr, instr.a)) written[instr.a.id] = true;
+            }
+
+            vector<Atom> chosen;
+            for(Atom var = 0; var < (int)ir->variables.size(); var++) {
+                if(!written[var] || (returns && ir->variables[var].storage == STORAGE_GLOBAL)) continue;
+                chosen.push_back(var);
+            }
+            stable_sort(chosen.begin(), chosen.end(), [&](Atom x, Atom y) { return uses[x] > uses[y]; });
+            vector<int> definedAt = firstDefinitions(*ir);
+            int room = min(MOST_LIVE - mostLiveAcross(*ir, definedAt, loop, all), MOST_BUSY - mostLive(*ir, definedAt, loop, all));
+            if(room <= 0) return;
+            if((int)chosen.size() > room) chosen.resize(room);
+            if(chosen.empty()) return;
+
+            vector<Operand> temp(ir->variables.size()); // of each chosen variable
+            for(Atom var : chosen) temp[var] = ir->newTemp();
+            vector<Operand> renamed(ir->temps.size()); // a load that became the variable's temporary
+            vector<int> lastRead(ir->temps.size(), -1), definitions(ir->temps.size(), 0);
+            for(int i = loop.header; i <= loop.back; i++) {
+                const Instr &instr = ir->code[i];
+                if(instr.dst.kind == OPERAND_TEMP) definitions[instr.dst.id]++;
+                if(instr.a.kind == OPERAND_TEMP) lastRead[instr.a.id] = i;
+                if(instr.b.kind == OPERAND_TEMP) lastRead[instr.b.id] = i;
+            }
+
+            // the line of the statement around an instruction, for the comments
+            int line = 0;
+            for(int i = loop.back; i > loop.header; i--) {
+                if(ir->code[i].line > 0) line = ir->code[i].line;
+            }
+            vector<Instr> code;
+            code.reserve(ir->code.size() + 3 * chosen.size());
+            auto rename = [&](Operand &operand) {
+                if(operand.kind == OPERAND_TEMP && renamed[operand.id].kind == OPERAND_TEMP) operand = renamed[operand.id];
+            };
+            for(int i = 0; i < (int)ir->code.size(); i++) {
+                Instr instr = ir->code[i];
+                if(i == loop.header) {
+                    for(Atom var : chosen) {
+                        Operand operand{OPERAND_VAR, var};
+                        if(storedFirst(loop, operand)) continue;
+                        Instr load{IR_LOAD};
+                        load.dst = temp[var];
+                        load.a = operand;
+                        load.line = line;
+                        code.push_back(load);
+                    }
+                }
+                if(i <= loop.header || i > loop.back) {
+                    code.push_back(instr);
+                    continue;
+                }
+                if(instr.line > 0) line = instr.line;
+                rename(instr.a);
+                rename(instr.b);
+                Operand var = instr.a;
+                if(!scalar(var) || temp[var.id].kind != OPERAND_TEMP) {
+                    code.push_back(instr);
+                }
+                else if(instr.op == IR_LOAD) {
+                    // the temporary itself, unless one of them changes before the value is used
+                    bool changes = definitions[instr.dst.id] > 1; // a variable kept over an inner loop
+                    for(int k = i + 1; k < lastRead[instr.dst.id]; k++) changes = changes || writes(ir->code[k], var);
+                    if(!changes) renamed[instr.dst.id] = temp[var.id];
+                    else {
+                        instr.op = IR_COPY;
+                        instr.a = temp[var.id];
+                        code.push_back(instr);
+                    }
+                }
+                else if(instr.op == IR_STORE) {
+                    Instr copy{IR_COPY};
+                    copy.dst = temp[var.id];
+                    copy.a = instr.b;
+                    copy.line = line;
+                    code.push_back(copy);
+                }
+                else if(instr.op == IR_POST_INC || instr.op == IR_POST_DEC) {
+                    if(lastRead[instr.dst.id] >= 0) { // the old value is used
+                        Instr old{IR_COPY};
+                        old.dst = instr.dst;
+                        old.a = temp[var.id];
+                        old.line = line;
+                        code.push_back(old);
+                    }
+                    Instr step{instr.op == IR_POST_INC ? IR_ADD : IR_SUB};
+                    step.dst = step.a = temp[var.id];
+                    step.b = ir->constantValue(1);
+                    step.line = line;
+                    code.push_back(step);
+                }
+                else if(instr.op == IR_PRINT) {
+                    Instr store{IR_STORE};
+                    store.a = var;
+                    store.b = temp[var.id];
+                    store.line = line;
+                    code.push_back(store);
+                    code.push_back(instr);
+                }
+                else code.push_back(instr);
+                if(i == loop.back) break;
+            }
+            int resume = loop.back + 1;
+            for(Atom var : chosen) {
+                Operand operand{OPERAND_VAR, var};
+                if(!liveAfter(loop, all, operand)) continue;
+                Instr store{IR_STORE};
+                store.a = operand;
+                store.b = temp[var];
+                store.line = line;
+                code.push_back(store);
+            }
+            code.insert(code.end(), ir->code.begin() + resume, ir->code.end());
+            ir->code = move(code);
+            promoted += chosen.size();
+            loops++;
+        }
+};
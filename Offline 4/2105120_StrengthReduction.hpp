@@ -0,0 +1,92 @@
+#pragma once
+
+#include "2105120_IR.hpp"
+
+using namespace std;
+
+// Strength reduction of the operations with a constant operand (-O1).
+// mul and div take well over 100 cycles on the 8086, a shift by one 2 and an add 3, so
+//  - x * c becomes shifts when c is a power of two, and shifts and one add or sub when it
+//    is 2^p + 2^q or 2^p - 2^q; any other c is multiplied from dx, which mul writes anyway
+//  - x / c is unsigned, as the code divides: a shift right when c is a power of two, a
+//    compare when c is above 8000h and x / c can only be 0 or 1, otherwise the high word
+//    of x times a reciprocal of c, shifted
+//  - x % c is an and when c is a power of two; any other c keeps its div
+//  - the element of an array at a constant index has a constant address: name[2k] or
+//    [bp - n + 2k], and needs no register at all
+// The folder puts a constant into an instruction only where this can use it; the
+// allocator asks which of these still write dx.
+
+inline int exactLog2(unsigned value) {
+    if(value == 0 || (value & (value - 1)) != 0) return -1;
+    int k = 0;
+    while((1u << k) != value) k++;
+    return k;
+}
+
+// c = 2^high + 2^low, or 2^high - 2^low when subtract is set, with high > low
+inline bool shiftAndAdd(unsigned c, int &high, int &low, bool &subtract) {
+    for(low = 0; low < 16; low++) {
+        if(!(c & (1u << low))) continue;
+        unsigned rest = c - (1u << low);
+        high = exactLog2(rest);
+        subtract = false;
+        if(high > low) return true;
+        high = exactLog2(c + (1u << low));
+        subtract = true;
+        return high > low && high < 16;
+    }
+    return false;
+}
+
+// x / d = (high word of x * multiplier) >> shift for every 16 bit x. When the multiplier
+// needs 17 bits, add is set and t = high word of x * multiplier gives
+// x / d = (t + ((x - t) >> 1)) >> shift.
+struct Reciprocal {
+    unsigned multiplier;
+    int shift;
+    bool add;
+};
+
+inline Reciprocal reciprocal(unsigned d) {
+    int bits = 0; // 2^bits >= d
+    while((1u << bits) < d) bits++;
+    for(int s = 0; s <= bits; s++) {
+        unsigned long long power = 1ull << (16 + s);
+        unsigned long long m = (power + d - 1) / d;
+        if(m < 0x10000 && m * d - power <= (1ull << s)) return Reciprocal{unsigned(m), s, false};
+    }
+    unsigned long long m = (0x10000ull * ((1ull << bits) - d)) / d + 1;
+    return Reciprocal{unsigned(m), bits - 1, true};
+}
+
+// the instruction can take the constant as its right operand
+inline bool takesConstant(Opcode op, int value) {
+    unsigned c = (unsigned short)value;
+    switch(op) {
+        case IR_MUL: return true;
+        case IR_DIV: return c != 0; // a division by 0 is left for the program to fault on
+        case IR_MOD: return exactLog2(c) >= 0;
+        default: return false;
+    }
+}
+
+// the code of the instruction still has a mul or div in it, which write dx
+inline bool usesMulDiv(const IRProgram &program, const Instr &instr) {
+    if(instr.op != IR_MUL && instr.op != IR_DIV && instr.op != IR_MOD) return false;
+    if(instr.b.kind != OPERAND_CONST) return true;
+    unsigned c = (unsigned short)program.constants[instr.b.id].value;
+    if(c <= 1 || exactLog2(c) >= 0) return false;
+    if(instr.op == IR_DIV) return c < 0x8000; // above, a compare
+    if(instr.op == IR_MOD) return true;
+    int high, low;
+    bool subtract;
+    return c != 0xFFFF && !shiftAndAdd(c, high, low, subtract); // x * 0FFFFh is -x
+}
+
+// an element at a constant index of a global or local array
+inline bool fixedElement(const IRProgram &program, const Instr &instr) {
+    if(instr.op != IR_ELEMENT || instr.b.kind != OPERAND_CONST || instr.a.kind != OPERAND_VAR) return false;
+    Storage storage = program.variables[instr.a.id].storage;
+    return storage == STORAGE_GLOBAL || storage == STORAGE_LOCAL;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "2105120_IR.hpp"
+#include "2105120_AsmWriter.hpp"
+
+using namespace std;
+
+// Tail calls over the three-address code (-O1).
+// A call whose value the function returns right away, or that a return without a value
+// or the end of the function follows, is in tail position: nothing of the frame is needed
+// after it. Its arguments are still pushed, then popped into the parameters of the frame
+// in place of the call
+//  - a call of the function itself jumps back to a label at the top of its body, with
+//    the locals given up first, so a recursion of any depth runs in one frame
+//  - a call of another function leaves the frame and jumps to it, which returns to the
+//    caller of this one; only where both take as many bytes of parameters, as the ret
+//    of the called function then drops the right bytes
+// The call keeps its place in the code with c naming where it goes (IR_CALL), and the
+// return behind it goes. main has no frame to return from and is left as it is.
+class TailCallEliminator {
+    public:
+        int selfCalls = 0;  // calls of the function itself made jumps
+        int otherCalls = 0; // calls of other functions made jumps
+
+        void eliminate(IRProgram &program) {
+            ir = &program;
+            unordered_map<Atom, int> parameterBytes; // of each function defined
+            for(const Instr &instr : ir->code) {
+                if(instr.op == IR_FUNC_END) parameterBytes[instr.a.id] = instr.imm;
+            }
+            vector<Instr> code;
+            code.reserve(ir->code.size() + 1);
+            for(int begin = 0; begin < (int)ir->code.size(); begin++) {
+                if(ir->code[begin].op != IR_FUNC_BEGIN) {
+                    code.push_back(ir->code[begin]);
+                    continue;
+                }
+                int end = begin;
+                while(ir->code[end].op != IR_FUNC_END) end++;
+                Atom function = ir->code[begin].a.id;
+                int bytes = ir->code[end].imm;
+                Operand top; // the label calls of the function itself jump to
+                int first = code.size();
+                int dropped = -1; // the return behind a call made a jump
+                for(int i = begin; i <= end; i++) {
+                    if(i == dropped) continue;
+                    Instr instr = ir->code[i];
+                    if(instr.op != IR_CALL || atoms.name(function) == "main") {
+                        code.push_back(instr);
+                        continue;
+                    }
+                    int next = i + 1;
+                    while(next < end && ir->code[next].op == IR_NOTE) next++;
+                    const Instr &after = ir->code[next];
+                    bool tail = (after.op == IR_RETURN && (after.a == instr.dst || after.a.kind == OPERAND_NONE)) || after.op == IR_FUNC_END;
+                    if(tail && instr.a.id == function && instr.imm * 2 == bytes) {
+                        if(top.kind == OPERAND_NONE) top = ir->newLabel(label_count++);
+                        instr.c = top;
+                        selfCalls++;
+                    }
+                    else if(tail && parameterBytes.count(instr.a.id) && parameterBytes[instr.a.id] == bytes
+                            && instr.imm * 2 == bytes && atoms.name(instr.a.id) != "main") {
+                        instr.c = instr.a;
+                        otherCalls++;
+                    }
+                    else tail = false;
+                    code.push_back(instr);
+                    if(tail && after.op == IR_RETURN) dropped = next;
+                }
+                if(top.kind != OPERAND_NONE) {
+                    Instr label{IR_LABEL};
+                    label.c = top;
+                    code.insert(code.begin() + first + 1, label);
+                }
+                begin = end;
+            }
+            ir->code = move(code);
+        }
+
+    private:
+        IRProgram *ir = nullptr;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include "antlr4-runtime.h"
+#include "2105120_AST.hpp"
+#include "2105120_TwoStageParse.hpp"
+
+using namespace std;
+
+// Parsing for --ast, one top-level unit at a time.
+// Once a unit is in the AST its rule contexts are released, and so are the tokens before
+// it, so the parse tree and the token buffer only ever hold about one unit.
+
+// a token stream that can free the tokens the parser has finished with
+class UnitTokenStream : public antlr4::CommonTokenStream {
+    size_t released = 0; // tokens before this index are gone
+
+    public:
+        using antlr4::CommonTokenStream::CommonTokenStream;
+
+        // the token just before 'index' is kept, the parser may still look back at it;
+        // the slots stay so the token indexes do not change
+        void releaseTokensBefore(size_t index) {
+            for(; released + 1 < index && released < _tokens.size(); released++) _tokens[released].reset();
+        }
+};
+
+// parse every unit into the AST; the actions of an SLL attempt that gave up only built
+// nodes, so restarting a unit just drops them and rewinds to its first token
+template <typename Parser>
+Program parseUnits(Parser &parser, UnitTokenStream &tokens, bool twoStage, bool releaseTokens, int &fallbacks) {
+    vector<Node *> units;
+    while(tokens.LA(1) != antlr4::Token::EOF) {
+        size_t begin = tokens.index();
+        Arena::Mark mark = astArena.mark();
+        auto unit = [&] { return parser.unit(); };
+        auto restart = [&] {
+            astArena.rollback(mark);
+            tokens.seek(begin);
+        };
+        if(twoStage) units.push_back(parseTwoStage(parser, unit, restart, fallbacks)->node);
+        else units.push_back(unit()->node);
+
+        if(tokens.index() == begin) tokens.consume(); // a token no unit can start with
+        parser.releaseParseTree();
+        if(releaseTokens) tokens.releaseTokensBefore(tokens.index());
+    }
+    return Program{astArena.copy(units)};
+}
@@ -2,17 +2,26 @@
 #include <fstream>
 #include <string>
 #include <stack>
+#include <chrono>
 #include "antlr4-runtime.h"
 #include "C8086Lexer.h"
 #include "C8086Parser.h"
+#include "C8086AstParser.h"
 #include "2105120_SymbolTable.hpp"
+#include "2105120_LogSink.hpp"
+#include "2105120_LogCategory.hpp"
+#include "2105120_ParseStats.hpp"
+#include "2105120_TwoStageParse.hpp"
+#include "2105120_UnitParse.hpp"
+#include "2105120_IRBuilder.hpp"
+#include "2105120_Optimize.hpp"
 #include "2105120_optimizer.hpp"
 
 using namespace antlr4;
 using namespace std;
 
-ofstream lexLogFile;
-ofstream asmCodeFile;
+LogSink lexLogFile;
+LogSink asmCodeFile;
 SymbolTable symbolTable(7, "sdbm"); // Initialize symbol table with 7 buckets and sdbm hash function
 bool codeSegmentStarted = false;
 int label_count = 0;
@@ -20,11 +29,110 @@ stack<string> currentFunctions;
 int localVarCount = 0;
 bool isReturnPresent = false;
 
+void writeAsmHeader() {
+    asmCodeFile << ".model small\n"
+                << ".stack 100h\n\n"
+                << ".data ; data definition goes here\n"
+                << "\tnumber db \"00000$\"\n";
+}
+
+// put everything the grammar actions write back to where it was before the parse;
+// the lexer log is kept since the token stream is not lexed again
+void restartCompilation(antlr4::Parser &parser) {
+    symbolTable.reset();
+    codeSegmentStarted = false;
+    label_count = 0;
+    currentFunctions = stack<string>();
+    localVarCount = 0;
+    isReturnPresent = false;
+
+    asmCodeFile.discard();
+    writeAsmHeader();
+    parser.reset(); // also rewinds the token stream
+}
+
+// code written by the grammar actions while parsing
+void compileWithActions(UnitTokenStream &tokens, bool twoStage, int repeat, ParseStats &stats) {
+    C8086Parser parser(&tokens);
+    parser.removeErrorListeners();
+
+    auto parse = [&]() -> tree::ParseTree * {
+        if (!twoStage) return parser.start();
+        return parseTwoStage(parser, [&] { restartCompilation(parser); }, stats.fullLLFallbacks);
+    };
+    if (repeat > 1) tokens.fill(); // time the parses only, not the lexing of the first one
+    measureParse(stats, parse, [&] { restartCompilation(parser); }, repeat);
+}
+
+// --ast: parse into the AST unit by unit without building a parse tree, lower the AST to
+// three-address code and select instructions for it. Repeated parses need the tokens
+// again, so they are only released when parsing once.
+void compileWithAst(UnitTokenStream &tokens, bool twoStage, int repeat, const string &irFileName,
+                    const OptimizeOptions &options, ParseStats &stats, OptimizeReport &report) {
+    C8086AstParser parser(&tokens);
+    parser.removeErrorListeners();
+    parser.setBuildParseTree(false);
+
+    Program program;
+    auto parse = [&]() -> tree::ParseTree * {
+        program = parseUnits(parser, tokens, twoStage, repeat == 1, stats.fullLLFallbacks);
+        return nullptr;
+    };
+    if (repeat > 1) tokens.fill();
+    measureParse(stats, parse, [&] {
+        astArena.reset();
+        parser.reset();
+    }, repeat);
+
+    auto begin = chrono::steady_clock::now();
+    IRBuilder builder(options.orderByNeed, options.jumping, options.branchless, options.rotate, options.unrollBudget);
+    IRProgram ir = builder.build(program);
+    report.loopsUnrolled = builder.unrolled;
+    report.loopsPartiallyUnrolled = builder.partiallyUnrolled;
+    generateCode(ir, options, report);
+    auto end = chrono::steady_clock::now();
+    if (!irFileName.empty()) {
+        ofstream irFile(irFileName);
+        printIR(irFile, ir);
+    }
+    stats.passMilliseconds = chrono::duration<double, milli>(end - begin).count();
+    stats.astBytes = astArena.bytesUsed();
+    stats.peakMemoryKB = peakMemoryKB();
+}
+
 int main(int argc, const char* argv[]) {
     if (argc < 2) {
-        cerr << "Usage: " << argv[0] << " <input_file>" << endl;
+        cerr << "Usage: " << argv[0] << " <input_file> [--async-log] [--log=lexer,parser,symbols,errors] [--stats] [--repeat=N] [--ll] [--ast] [--dump-ir] [-O0|-O1] [--unroll-budget=N]" << endl;
         return 1;
     }
+    bool asyncLog = false; // drain the output buffers on background writer threads
+    bool printStats = false; // parse time, context count and peak memory on stderr
+    int repeat = 1; // parse this many times, to time parses with a warm decision DFA
+    bool twoStage = true; // --ll parses with full LL prediction only
+    bool useAst = false; // --ast generates code from the AST instead of in the grammar actions
+    bool dumpIr = false; // --dump-ir writes the three-address code of --ast to output/code.ir
+    OptimizeOptions optimize; // -O1 keeps temporaries in registers, needs --ast
+    int unrollBudget = -1; // --unroll-budget=N: AST nodes a counted loop may be copied into at -O1
+    for (int i = 2; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--async-log") asyncLog = true;
+        else if (option == "--stats") printStats = true;
+        else if (option == "--ll") twoStage = false;
+        else if (option == "--ast") useAst = true;
+        else if (option == "--dump-ir") useAst = dumpIr = true;
+        else if (option == "-O0" || option == "-O1") {
+            optimize = optimizeLevel(option[2] - '0');
+            if (optimize.level > 0) useAst = true;
+        }
+        else if (option.rfind("--unroll-budget=", 0) == 0 && (unrollBudget = atoi(option.c_str() + 16)) >= 0) continue;
+        else if (option.rfind("--repeat=", 0) == 0 && (repeat = atoi(option.c_str() + 9)) > 0) continue;
+        else if (option.rfind("--log=", 0) == 0 && selectLogCategories(option.substr(6))) continue;
+        else {
+            cerr << "Unknown option: " << option << endl;
+            return 1;
+        }
+    }
+    if (unrollBudget >= 0 && optimize.level > 0) optimize.unrollBudget = unrollBudget;
 
     ifstream inputFile(argv[1]);
     if (!inputFile.is_open()) {
@@ -36,38 +144,38 @@ int main(int argc, const char* argv[]) {
     string lexLogFileName = outputDirectory + "lexerLog.txt";
     system(("mkdir -p " + outputDirectory).c_str());
 
-    lexLogFile.open(lexLogFileName);
+    lexLogFile.open(lexLogFileName, false, asyncLog);
     if (!lexLogFile.is_open()) {
         cerr << "Error opening lexer log file: " << lexLogFileName << endl;
         return 1;
     }
 
     string asmCodeFileName = outputDirectory + "code.asm";
-    asmCodeFile.open(asmCodeFileName);
+    asmCodeFile.open(asmCodeFileName, false, asyncLog);
     if (!asmCodeFile.is_open()) {
         cerr << "Error opening assembly code file: " << asmCodeFileName << endl;
         lexLogFile.close();
         return 1;
     }
 
-    asmCodeFile << ".model small\n"
-                << ".stack 100h\n\n"
-                << ".data ; data definition goes here\n"
-                << "\tnumber db \"00000$\"\n";
+    writeAsmHeader();
 
     ANTLRInputStream input(inputFile);
     C8086Lexer lexer(&input);
-    CommonTokenStream tokens(&lexer);
-    C8086Parser parser(&tokens);
-    parser.removeErrorListeners();
+    UnitTokenStream tokens(&lexer);
 
-    parser.start();
+    ParseStats stats;
+    OptimizeReport report;
+    if (useAst) compileWithAst(tokens, twoStage, repeat, dumpIr ? outputDirectory + "code.ir" : "", optimize, stats, report);
+    else compileWithActions(tokens, twoStage, repeat, stats);
+    if (printStats) printParseStats(cerr, stats);
+    if (printStats && optimize.level > 0) printOptimizeReport(cerr, report);
 
     {
         ifstream lib("printProc.lib");
         if (lib) {
             asmCodeFile << "\n; ===== runtime print support =====\n";
-            asmCodeFile << lib.rdbuf();
+            asmCodeFile << string(istreambuf_iterator<char>(lib), istreambuf_iterator<char>());
         } else {
             std::cerr << "Warning: could not open printProc.lib; continuing without it.\n";
         }
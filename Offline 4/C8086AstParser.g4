@@ -0,0 +1,260 @@
+parser grammar C8086AstParser;
+
+// Same rules and alternatives as C8086Parser.g4, so both parse every input the same way,
+// but the actions only build the typed AST of 2105120_AST.hpp; code is generated
+// afterwards from it, through the three-address code of 2105120_IR.hpp. The driver calls unit() once
+// per top-level unit and frees the rule contexts and tokens of each unit after it.
+
+options {
+    tokenVocab = C8086Lexer;
+}
+
+@parser::header {
+	#include <vector>
+	#include <string>
+	#include "C8086Lexer.h"
+	#include "2105120_AST.hpp"
+}
+
+@parser::members {
+	Atom atomOf(antlr4::Token *token) {
+		return atoms.intern(token->getText());
+	}
+
+	// with tree building off nothing refers to the rule contexts of a finished unit,
+	// but the parser still owns them until they are released
+	void releaseParseTree() {
+		_tracker.reset();
+	}
+}
+
+
+start : program
+        ;
+
+program : unit ( unit )*
+	    ;
+
+unit returns [Node *node = nullptr]
+     : vd=var_declaration {$node = $vd.node;}
+     | fd=func_declaration {$node = $fd.node;}
+     | fn=func_definition {$node = $fn.node;}
+     ;
+
+func_declaration returns [Function *node = nullptr]
+				: ts=type_specifier ID LPAREN pl=parameter_list RPAREN SEMICOLON
+				{
+					$node = newFunction(NODE_FUNC_DECL, $ts.type, atomOf($ID), $ID->getLine(), $pl.params, nullptr);
+				}
+		        | ts=type_specifier ID LPAREN RPAREN SEMICOLON
+				{
+					$node = newFunction(NODE_FUNC_DECL, $ts.type, atomOf($ID), $ID->getLine(), Array<Param>(), nullptr);
+				}
+		        ;
+
+func_definition returns [Function *node = nullptr]
+				: ts=type_specifier ID LPAREN pl=parameter_list RPAREN cs=compound_statement
+				{
+					$node = newFunction(NODE_FUNC_DEF, $ts.type, atomOf($ID), $ID->getLine(), $pl.params, $cs.node);
+				}
+		        | ts=type_specifier ID LPAREN RPAREN cs=compound_statement
+				{
+					$node = newFunction(NODE_FUNC_DEF, $ts.type, atomOf($ID), $ID->getLine(), Array<Param>(), $cs.node);
+				}
+ 		        ;
+
+
+parameter_list returns [Array<Param> params] locals [std::vector<Param> items]
+				: ( ts=type_specifier id=ID
+				{
+					$items.push_back({$ts.type, atomOf($id)});
+				}
+		        | ts=type_specifier
+				{
+					$items.push_back({$ts.type, NO_ATOM});
+				}
+				)
+				( COMMA ts=type_specifier id=ID
+				{
+					$items.push_back({$ts.type, atomOf($id)});
+				}
+		        | COMMA ts=type_specifier
+				{
+					$items.push_back({$ts.type, NO_ATOM});
+				}
+				)*
+				{
+					$params = astArena.copy($items);
+				}
+ 		        ;
+
+
+compound_statement returns [Compound *node = nullptr]
+					: LCURL st=statements RCURL
+					{
+						$node = newCompound($LCURL->getLine(), $st.list);
+					}
+ 		           | LCURL RCURL
+				   {
+						$node = newCompound($LCURL->getLine(), Array<Stmt *>());
+					}
+ 		           ;
+
+var_declaration returns [VarDecl *node = nullptr]
+				: ts=type_specifier dl=declaration_list SEMICOLON
+				{
+					$node = newVarDecl($ts.type, $ts.start->getLine(), $dl.declarators);
+				}
+                ;
+
+
+type_specifier returns [TypeSpecifier type = SPEC_INT]
+				: INT {$type = SPEC_INT;}
+ 		       | FLOAT {$type = SPEC_FLOAT;}
+ 		       | VOID {$type = SPEC_VOID;}
+ 		       ;
+
+declaration_list returns [Array<Declarator> declarators] locals [std::vector<Declarator> items]
+				 : ( id=ID
+				 {
+					$items.push_back({atomOf($id), $id->getLine(), -1});
+				 }
+ 		         | id=ID LTHIRD size=CONST_INT RTHIRD
+				 {
+					$items.push_back({atomOf($id), $id->getLine(), stoi($size->getText())});
+				 }
+				 )
+				 ( COMMA id=ID
+				 {
+					$items.push_back({atomOf($id), $id->getLine(), -1});
+				 }
+ 		         | COMMA id=ID LTHIRD size=CONST_INT RTHIRD
+				 {
+					$items.push_back({atomOf($id), $id->getLine(), stoi($size->getText())});
+				 }
+				 )*
+				 {
+					$declarators = astArena.copy($items);
+				 }
+ 		         ;
+
+statements returns [Array<Stmt *> list] locals [std::vector<Stmt *> items]
+			: ( s=statement {$items.push_back($s.node);} )+
+			{
+				$list = astArena.copy($items);
+			}
+	       ;
+
+statement returns [Stmt *node = nullptr]
+		  : vd=var_declaration {$node = $vd.node;}
+	      | es=expression_statement {$node = newExprStmt($es.start->getLine(), $es.node);}
+	      | cs=compound_statement {$node = $cs.node;}
+	      | FOR LPAREN init=expression_statement test=expression_statement step=expression RPAREN body=statement
+		  {
+			$node = newFor($FOR->getLine(), $init.node, $test.node, $step.node, $body.node);
+		  }
+	      | IF LPAREN condition=expression RPAREN body=statement
+		  {
+			$node = newIf($IF->getLine(), $condition.node, $body.node);
+		  }
+		  | IF LPAREN condition=expression RPAREN body=statement ELSE elseBody=statement
+		  {
+			$node = newIf($IF->getLine(), $condition.node, $body.node, $elseBody.node, $ELSE->getLine());
+		  }
+	      | WHILE LPAREN condition=expression RPAREN body=statement
+		  {
+			$node = newWhile($WHILE->getLine(), $condition.node, $body.node);
+		  }
+	      | PRINTLN LPAREN ID RPAREN SEMICOLON
+		  {
+			$node = newPrintln($PRINTLN->getLine(), atomOf($ID));
+		  }
+	      | RETURN e=expression SEMICOLON
+		  {
+			$node = newReturn($RETURN->getLine(), $e.node);
+		  }
+	      ;
+
+expression_statement returns [Expr *node = nullptr]
+						: SEMICOLON
+			            | e=expression SEMICOLON {$node = $e.node;}
+			            ;
+
+variable returns [VarRef *node = nullptr]
+		 : ID {$node = newVarRef(atomOf($ID), $ID->getLine(), nullptr);}
+	     | ID LTHIRD e=expression RTHIRD {$node = newVarRef(atomOf($ID), $ID->getLine(), $e.node);}
+	     ;
+
+ expression returns [Expr *node = nullptr]
+ 			: le=logic_expression {$node = $le.node;}
+	        | v=variable ASSIGNOP le=logic_expression
+			{
+				$node = newAssign($ASSIGNOP->getLine(), $v.node, $le.node);
+			}
+	        ;
+
+logic_expression returns [Expr *node = nullptr]
+				 : left=rel_expression {$node = $left.node;}
+		         | left=rel_expression LOGICOP right=rel_expression
+				 {
+					$node = newBinary(binaryOperator($LOGICOP->getText()), $LOGICOP->getLine(), $left.node, $right.node);
+				 }
+		         ;
+
+rel_expression returns [Expr *node = nullptr]
+				: left=simple_expression {$node = $left.node;}
+		        | left=simple_expression RELOP right=simple_expression
+				{
+					$node = newBinary(binaryOperator($RELOP->getText()), $RELOP->getLine(), $left.node, $right.node);
+				}
+		        ;
+
+simple_expression returns [Expr *node = nullptr]
+				  : left=term {$node = $left.node;}
+		          ( op=ADDOP right=term
+				  {
+					$node = newBinary(binaryOperator($op->getText()), $op->getLine(), $node, $right.node);
+				  }
+				  )*
+		          ;
+
+term returns [Expr *node = nullptr]
+	 :	left=unary_expression {$node = $left.node;}
+     (  mul=MULOP right=unary_expression
+	 {
+		$node = newBinary(binaryOperator($mul->getText()), $mul->getLine(), $node, $right.node);
+	 }
+	 )*
+     ;
+
+unary_expression returns [Expr *node = nullptr]
+				: ADDOP u=unary_expression
+				{
+					$node = newUnary($ADDOP->getText() == "-" ? OP_NEG : OP_PLUS, $ADDOP->getLine(), $u.node);
+				}
+		         | NOT u=unary_expression {$node = newUnary(OP_NOT, $NOT->getLine(), $u.node);}
+		         | f=factor {$node = $f.node;}
+		         ;
+
+factor returns [Expr *node = nullptr]
+		: v=variable {$node = newVarAccess(NODE_LOAD, $v.node, $v.start->getLine());}
+	    | ID LPAREN al=argument_list RPAREN {$node = newCall(atomOf($ID), $ID->getLine(), $al.args);}
+	    | LPAREN e=expression RPAREN {$node = $e.node;}
+        | CONST_INT {$node = newConstant(NODE_CONST_INT, atomOf($CONST_INT), $CONST_INT->getLine());}
+        | CONST_FLOAT {$node = newConstant(NODE_CONST_FLOAT, atomOf($CONST_FLOAT), $CONST_FLOAT->getLine());}
+        | v=variable INCOP {$node = newVarAccess(NODE_POST_INC, $v.node, $INCOP->getLine());}
+        | v=variable DECOP {$node = newVarAccess(NODE_POST_DEC, $v.node, $DECOP->getLine());}
+        ;
+
+argument_list returns [Array<Expr *> args]
+			  : a=arguments {$args = $a.args;}
+			  |
+			  ;
+
+arguments returns [Array<Expr *> args] locals [std::vector<Expr *> items]
+		  : le=logic_expression {$items.push_back($le.node);}
+	      ( COMMA le=logic_expression {$items.push_back($le.node);} )*
+		  {
+			$args = astArena.copy($items);
+		  }
+	      ;
@@ -9,106 +9,14 @@ options {
 	#include <fstream>
 	#include <stack>
 	#include "C8086Lexer.h"
-	#include "2105120_SymbolTable.hpp"
-
-	extern std::ofstream asmCodeFile;
-	extern SymbolTable symbolTable;
-	extern bool codeSegmentStarted;
-	extern int label_count;
-	extern stack<std::string> currentFunctions;
-	extern int localVarCount;
-	extern bool isReturnPresent;
-}
-
-@parser::members {
-	void writeIntoCodeFile(const std::string code) {
-		asmCodeFile << code;
-		asmCodeFile.flush();
-	}
-	void writeCodeSegment() {
-		if(codeSegmentStarted == false) {
-			writeIntoCodeFile(".code\n");
-			codeSegmentStarted = true;
-		}
-	}
-	void writeProcName(const std::string procName) {
-		writeIntoCodeFile(procName + " proc\n");
-		if(procName == "main") {
-			writeIntoCodeFile("\tmov ax, @data\n\tmov ds, ax\n\n");
-		}
-		currentFunctions.push(procName);
-	}
-	void writeProcEnd(const std::string procName, int paramSize) {
-		if(procName == "main")
-		{
-			writeIntoCodeFile("\tmov ah, 4ch\n\tint 21h\n");
-		}
-		else
-		{
-			if(paramSize == 0)
-				writeIntoCodeFile("\tret\n");
-			else
-				writeIntoCodeFile("\tret " + std::to_string(paramSize) + "\n");
-		}
-		writeIntoCodeFile(procName + " endp\n\n");
-		currentFunctions.pop();
-	}
-
-	void writeLabel(std::string label)
-	{
-		writeIntoCodeFile("L" + label + ":\n");
-	}
-
-	void writeJumpConditionByRelop(const std::string optr, int falseLabel)
-	{
-		std::string jmpStr;
-		if(optr == "<=") jmpStr = "jnle";
-		else if(optr == "!=") jmpStr = "je";
-		else if(optr == "==") jmpStr = "jne";
-		else if(optr == "<") jmpStr = "jge";
-		else if(optr == ">") jmpStr = "jle";
-		else if(optr == ">=") jmpStr = "jnge";
-
-		writeIntoCodeFile("\t" + jmpStr + " L" + std::to_string(falseLabel) + "\n");
-	}
-
-	void declareVariable(std::string varName)
-	{
-		if(symbolTable.getCurrentScopeId() == "1") // global scope
-		{
-			writeIntoCodeFile("\t" + varName + " dw 0h\n");
-			symbolTable.insert(varName, "global");
-		}
-		else // local scope
-		{
-			localVarCount++;
-			writeIntoCodeFile("\tsub sp, 2\n");
-			symbolTable.insert(varName, "local", localVarCount * 2);
-		}
-	}
-
-	void declareArray(std::string arrName, int size)
-	{
-		if(symbolTable.getCurrentScopeId() == "1") // global scope
-		{
-			writeIntoCodeFile("\t" + arrName + " dw " + std::to_string(size) + " dup (0)\n");
-			symbolTable.insert(arrName, "global");
-		}
-		else // local scope
-		{
-			localVarCount += size;
-			writeIntoCodeFile("\tsub sp, " + std::to_string(size * 2) + "\n");
-			symbolTable.insert(arrName, "local", localVarCount * 2, size);
-		}
-	}
+	#include "2105120_AsmWriter.hpp"
 }
 
 
 start : program
         ;
 
-program : program unit 
-	    | unit
+program : unit ( unit )*
 	    ;
 	
 unit : var_declaration
@@ -127,7 +35,7 @@ func_definition
 				} 
 				ID 
 				{
-					writeIntoCodeFile("; definition of function " + $ID->getText() + " started, line no " + std::to_string($ID->getLine()) + "\n");
+					writeIntoCodeFile("; definition of function ", $ID->getText(), " started, line no ", $ID->getLine(), "\n");
 					writeProcName($ID->getText());
 				} 
 				LPAREN 
@@ -144,7 +52,7 @@ func_definition
 				}
 				RPAREN compound_statement 
 				{
-					if(isReturnPresent == true) writeIntoCodeFile("L" + currentFunctions.top() + "end:\n");
+					if(isReturnPresent == true) writeIntoCodeFile("L", currentFunctions.top(), "end:\n");
 					isReturnPresent = false;
 					writeIntoCodeFile("\tmov sp, bp\n\tpop bp\n");
 					writeProcEnd($ID->getText(), paramSize * 2);
@@ -157,12 +65,12 @@ func_definition
 				} 
 				ID 
 				{
-					writeIntoCodeFile("; definition of function " + $ID->getText() + " started, line no " + std::to_string($ID->getLine()) + "\n");
+					writeIntoCodeFile("; definition of function ", $ID->getText(), " started, line no ", $ID->getLine(), "\n");
 					writeProcName($ID->getText());
 				} 
 				LPAREN {symbolTable.enterScope(); writeIntoCodeFile("\tpush bp\n\tmov bp, sp\n");} RPAREN compound_statement
 				{
-					if(isReturnPresent == true) writeIntoCodeFile("L" + currentFunctions.top() + "end:\n");
+					if(isReturnPresent == true) writeIntoCodeFile("L", currentFunctions.top(), "end:\n");
 					isReturnPresent = false;
 					writeIntoCodeFile("\tmov sp, bp\n\tpop bp\n");
 					writeProcEnd($ID->getText(), 0);
@@ -173,17 +81,21 @@ func_definition
 
 
 parameter_list returns [std::vector<std::string> paramNames]
-				: pl=parameter_list COMMA type_specifier ID
+				: ( type_specifier id=ID
+				{
+					$paramNames.push_back($id->getText());
+				}
+		        | type_specifier
+				)
+				( COMMA type_specifier id=ID
 				{
-					$paramNames = $pl.paramNames;
-					$paramNames.push_back($ID->getText());
+					$paramNames.push_back($id->getText());
 				}
-		        | parameter_list COMMA type_specifier
- 		        | type_specifier ID
+		        | COMMA type_specifier
 				{
-					$paramNames.push_back($ID->getText());
+					$paramNames.clear(); // a nameless parameter drops the names before it
 				}
-		        | type_specifier
+				)*
  		        ;
 
  		
@@ -202,7 +114,7 @@ compound_statement : LCURL {symbolTable.enterScope();} statements RCURL
 var_declaration 
 				: ts=type_specifier 
 				{
-					writeIntoCodeFile("; variable declaration of line " + std::to_string($ts.start->getLine()) + "\n");
+					writeIntoCodeFile("; variable declaration of line ", $ts.start->getLine(), "\n");
 				} declaration_list SEMICOLON
                 ;
 
@@ -213,28 +125,29 @@ type_specifier : INT
  		       ;
  		
 declaration_list
-				 : declaration_list COMMA ID
+				 : ( id=ID
 				 {
-					declareVariable($ID->getText());
+					declareVariable($id->getText());
 				 }
- 		         | declaration_list COMMA ID LTHIRD CONST_INT RTHIRD
+ 		         | id=ID LTHIRD size=CONST_INT RTHIRD
 				 {
-					int arrSize = stoi($CONST_INT->getText());
-					declareArray($ID->getText(), arrSize);					
+					int arrSize = stoi($size->getText());
+					declareArray($id->getText(), arrSize);
 				 }
- 		         | ID
+				 )
+				 ( COMMA id=ID
 				 {
-					declareVariable($ID->getText());
+					declareVariable($id->getText());
 				 }
- 		         | ID LTHIRD CONST_INT RTHIRD
+ 		         | COMMA id=ID LTHIRD size=CONST_INT RTHIRD
 				 {
-					int arrSize = stoi($CONST_INT->getText());
-					declareArray($ID->getText(), arrSize);
+					int arrSize = stoi($size->getText());
+					declareArray($id->getText(), arrSize);					
 				 }
+				 )*
  		         ;
  		  
-statements : s=statement[-1]
-	       | statements s=statement[-1]
+statements : ( s=statement[-1] )+
 	       ;
 	   
 statement [int endLabelInherited]
@@ -243,50 +156,50 @@ statement [int endLabelInherited]
 	      | compound_statement
 	      | FOR
 		  {
-			writeIntoCodeFile("; for loop in line no " + std::to_string($FOR->getLine()) + "\n");
+			writeIntoCodeFile("; for loop in line no ", $FOR->getLine(), "\n");
 		  } LPAREN expression_statement 
 		  {
 			int conditionLabel = label_count++;
 			int endLabel = label_count++;
 			int statementLabel = label_count++;
 			int incrementLabel = label_count++;
-			writeLabel(std::to_string(conditionLabel));
+			writeLabel(conditionLabel);
 		  } 
 		  expression_statement
 		  {
 			writeIntoCodeFile("\tcmp ax, 0\n");
-			writeIntoCodeFile("\tje L" + std::to_string(endLabel) + " ; jump to end\n");
-			writeIntoCodeFile("\tjne L" + std::to_string(statementLabel) + " ; jump to statement execution\n");
-			writeLabel(std::to_string(incrementLabel));
+			writeIntoCodeFile("\tje L", endLabel, " ; jump to end\n");
+			writeIntoCodeFile("\tjne L", statementLabel, " ; jump to statement execution\n");
+			writeLabel(incrementLabel);
 		  } 
 		  expression
 		  {
-			writeIntoCodeFile("\tjmp L" + std::to_string(conditionLabel) + " ; jump to condition checking\n");
-			writeLabel(std::to_string(statementLabel));
+			writeIntoCodeFile("\tjmp L", conditionLabel, " ; jump to condition checking\n");
+			writeLabel(statementLabel);
 		  } 
 		  RPAREN s=statement[-1]
 		  {
-			writeIntoCodeFile("\tjmp L" + std::to_string(incrementLabel) + " ; jump to increment/decrement statement\n");
-			writeLabel(std::to_string(endLabel));
+			writeIntoCodeFile("\tjmp L", incrementLabel, " ; jump to increment/decrement statement\n");
+			writeLabel(endLabel);
 		  }
 	      | IF
 		  {
-			writeIntoCodeFile("; if statement in line no " + std::to_string($IF->getLine()) + "\n");
+			writeIntoCodeFile("; if statement in line no ", $IF->getLine(), "\n");
 		  } LPAREN expression RPAREN
 		  {
 			int falseLabel;
 			if($endLabelInherited >= 0) falseLabel = $endLabelInherited;
 			else falseLabel = label_count++;
 			writeIntoCodeFile("\tcmp ax, 0\n");
-			writeIntoCodeFile("\tje L" + std::to_string(falseLabel) + " ; jump to false label\n");
+			writeIntoCodeFile("\tje L", falseLabel, " ; jump to false label\n");
 		  }
 		  s=statement[falseLabel]
 		  {
-			if($endLabelInherited < 0) writeLabel(std::to_string(falseLabel)); // use the same falseLabel here
+			if($endLabelInherited < 0) writeLabel(falseLabel); // use the same falseLabel here
 		  }
 		  | IF 
 		  {
-			writeIntoCodeFile("; if statement in line no " + std::to_string($IF->getLine()) + "\n");			
+			writeIntoCodeFile("; if statement in line no ", $IF->getLine(), "\n");			
 		  } LPAREN expression RPAREN
 		  {
 			int falseLabel = label_count++;
@@ -294,63 +207,63 @@ statement [int endLabelInherited]
 			if($endLabelInherited >= 0) endLabel = $endLabelInherited;
 			else endLabel = label_count++;
 			writeIntoCodeFile("\tcmp ax, 0\n");
-			writeIntoCodeFile("\tje L" + std::to_string(falseLabel) + " ; jump to false label\n");
+			writeIntoCodeFile("\tje L", falseLabel, " ; jump to false label\n");
 		  }
 		  s=statement[-1]
 		  {
-			writeIntoCodeFile("\tjmp L" + std::to_string(endLabel) + " ; jump to end\n");
-			writeLabel(std::to_string(falseLabel));
+			writeIntoCodeFile("\tjmp L", endLabel, " ; jump to end\n");
+			writeLabel(falseLabel);
 		  }
 		  ELSE
 		  {
-			writeIntoCodeFile("; else statement in line no " + std::to_string($ELSE->getLine()) + "\n");
+			writeIntoCodeFile("; else statement in line no ", $ELSE->getLine(), "\n");
 		  } s=statement[endLabel]
 		  {
-			if($endLabelInherited < 0) writeLabel(std::to_string(endLabel));
+			if($endLabelInherited < 0) writeLabel(endLabel);
 		  }
 	      | WHILE 
 		  {
-			writeIntoCodeFile("; while loop in line no " + std::to_string($WHILE->getLine()) + "\n");
+			writeIntoCodeFile("; while loop in line no ", $WHILE->getLine(), "\n");
 		  } LPAREN
 		  {
 			int conditionLabel = label_count++;
 			int endLabel = label_count++;
-			writeLabel(std::to_string(conditionLabel));
+			writeLabel(conditionLabel);
 		  } 
 		  expression
 		  {
 			writeIntoCodeFile("\tcmp ax, 0\n");
-			writeIntoCodeFile("\tje L" + std::to_string(endLabel) + " ; jump to end\n");
+			writeIntoCodeFile("\tje L", endLabel, " ; jump to end\n");
 		  } 
 		  RPAREN s=statement[-1]
 		  {
-			writeIntoCodeFile("\tjmp L" + std::to_string(conditionLabel) + " ; jump to condition checking\n");
-			writeLabel(std::to_string(endLabel));
+			writeIntoCodeFile("\tjmp L", conditionLabel, " ; jump to condition checking\n");
+			writeLabel(endLabel);
 		  }
 	      | PRINTLN 
 		  {
-			writeIntoCodeFile("; print statement in line no " + std::to_string($PRINTLN->getLine()) + "\n");
+			writeIntoCodeFile("; print statement in line no ", $PRINTLN->getLine(), "\n");
 		  } LPAREN ID RPAREN SEMICOLON
 		  {
 			SymbolInfo * info = symbolTable.lookup($ID->getText());
 			if(info->getType() == "global")
 			{
-				writeIntoCodeFile("\tmov ax, " + $ID->getText() + "\n");
+				writeIntoCodeFile("\tmov ax, ", $ID->getText(), "\n");
 			}
 			else if(info->getType() == "local")
 			{
 				std::string varName = "[bp - " + std::to_string(info->getStackOffset()) + "]";
-				writeIntoCodeFile("\tmov ax, " + varName + "\n");
+				writeIntoCodeFile("\tmov ax, ", varName, "\n");
 			}
 			writeIntoCodeFile("\tcall print_output\n\tcall new_line\n");
 		  }
 	      | RETURN 
 		  {
-			writeIntoCodeFile("; return statement in line no " + std::to_string($RETURN->getLine()) + "\n");
+			writeIntoCodeFile("; return statement in line no ", $RETURN->getLine(), "\n");
 		  } expression SEMICOLON
 		  {
 			isReturnPresent = true;
-			writeIntoCodeFile("\tjmp L" + currentFunctions.top() + "end\n");
+			writeIntoCodeFile("\tjmp L", currentFunctions.top(), "end\n");
 		  }
 	      ;
 	  
@@ -382,7 +295,7 @@ variable returns [std::string varName]
 			SymbolInfo * info = symbolTable.lookup($ID->getText());
 			if(info->getType() == "global")
 			{
-				writeIntoCodeFile("\tlea si, " + $ID->getText() + "\n");
+				writeIntoCodeFile("\tlea si, ", $ID->getText(), "\n");
 				writeIntoCodeFile("\tadd si, ax\n");
 				$varName = "[si]";
 			}
@@ -398,7 +311,7 @@ variable returns [std::string varName]
  			: logic_expression	
 	        | v=variable ASSIGNOP logic_expression 
 			{
-				writeIntoCodeFile("\tmov " + $v.varName + ", ax ; assignment operation of line " + std::to_string($ASSIGNOP->getLine()) + "\n");
+				writeIntoCodeFile("\tmov ", $v.varName, ", ax ; assignment operation of line ", $ASSIGNOP->getLine(), "\n");
 			}	
 	        ;
 			
@@ -413,12 +326,12 @@ logic_expression
 					if(optr == "||")
 					{
 						writeIntoCodeFile("\tcmp ax, 0\n");
-						writeIntoCodeFile("\tjne L" + std::to_string(shortLabel) + " ; jump to true label\n");
+						writeIntoCodeFile("\tjne L", shortLabel, " ; jump to true label\n");
 					}
 					else if(optr == "&&")
 					{
 						writeIntoCodeFile("\tcmp ax, 0\n");
-						writeIntoCodeFile("\tje L" + std::to_string(shortLabel) + " ; jump to false label\n");
+						writeIntoCodeFile("\tje L", shortLabel, " ; jump to false label\n");
 					}
 				 } 
 				 rel_expression 
@@ -426,22 +339,22 @@ logic_expression
 					if(optr == "||") 
 					{
 						writeIntoCodeFile("\tcmp ax, 0\n");
-						writeIntoCodeFile("\tjne L" + std::to_string(shortLabel) + " ; jump to true label\n");
+						writeIntoCodeFile("\tjne L", shortLabel, " ; jump to true label\n");
 						writeIntoCodeFile("\tmov ax, 0\n");
-						writeIntoCodeFile("\tjmp L" + std::to_string(endLabel) + " ; jump to end\n");
-						writeLabel(std::to_string(shortLabel));
+						writeIntoCodeFile("\tjmp L", endLabel, " ; jump to end\n");
+						writeLabel(shortLabel);
 						writeIntoCodeFile("\tmov ax, 1\n");
-						writeLabel(std::to_string(endLabel));
+						writeLabel(endLabel);
 					} 
 					else if(optr == "&&") 
 					{
 						writeIntoCodeFile("\tcmp ax, 0\n");
-						writeIntoCodeFile("\tje L" + std::to_string(shortLabel) + " ; jump to false label\n");
+						writeIntoCodeFile("\tje L", shortLabel, " ; jump to false label\n");
 						writeIntoCodeFile("\tmov ax, 1\n");
-						writeIntoCodeFile("\tjmp L" + std::to_string(endLabel) + " ; jump to end\n");
-						writeLabel(std::to_string(shortLabel));
+						writeIntoCodeFile("\tjmp L", endLabel, " ; jump to end\n");
+						writeLabel(shortLabel);
 						writeIntoCodeFile("\tmov ax, 0\n");
-						writeLabel(std::to_string(endLabel));
+						writeLabel(endLabel);
 					}
 				 }	
 		         ;
@@ -456,41 +369,42 @@ rel_expression
 					int endLabel = label_count++;
 					writeJumpConditionByRelop($RELOP->getText(), falseLabel);
 					writeIntoCodeFile("\tmov ax, 1 ; result of relational operation true\n");
-					writeIntoCodeFile("\tjmp L" + std::to_string(endLabel) + "\n");
-					writeLabel(std::to_string(falseLabel));
+					writeIntoCodeFile("\tjmp L", endLabel, "\n");
+					writeLabel(falseLabel);
 					writeIntoCodeFile("\tmov ax, 0 ; result of relational operation false\n");
-					writeLabel(std::to_string(endLabel));
+					writeLabel(endLabel);
 				}
 		        ;
 				
 simple_expression
 				  : term 
-		          | simple_expression ADDOP {writeIntoCodeFile("\tpush ax\n");} term 
+		          ( op=ADDOP {writeIntoCodeFile("\tpush ax\n");} term 
 				  {
 					writeIntoCodeFile("\tpop bx\n");
-					if($ADDOP->getText() == "+")
+					if($op->getText() == "+")
 					{
-						writeIntoCodeFile("\tadd bx, ax ; addition operation of line " + std::to_string($ADDOP->getLine()) + "\n");
+						writeIntoCodeFile("\tadd bx, ax ; addition operation of line ", $op->getLine(), "\n");
 					}
 					else 
 					{
-						writeIntoCodeFile("\tsub bx, ax ; subtraction operation of line " + std::to_string($ADDOP->getLine()) + "\n");
+						writeIntoCodeFile("\tsub bx, ax ; subtraction operation of line ", $op->getLine(), "\n");
 					}
 					writeIntoCodeFile("\tmov ax, bx\n");
 				  }
+				  )*
 		          ;
 					
 term
 	 :	unary_expression
-     |  term MULOP {writeIntoCodeFile("\tpush ax\n");} unary_expression
+     (  mul=MULOP {writeIntoCodeFile("\tpush ax\n");} unary_expression
 	 {
 		writeIntoCodeFile("\tpop bx\n");
 		writeIntoCodeFile("\txchg ax,bx\n");
-		if($MULOP->getText() == "*")
+		if($mul->getText() == "*")
 		{
 			writeIntoCodeFile("\tmul bx\n");
 		}
-		else if($MULOP->getText() == "/")
+		else if($mul->getText() == "/")
 		{
 			writeIntoCodeFile("\tmov dx,0h\n");
 			writeIntoCodeFile("\tdiv bx\n");
@@ -502,6 +416,7 @@ term
 			writeIntoCodeFile("\tmov ax, dx\n");		
 		}
 	 }
+	 )*
      ;
 
 unary_expression
@@ -519,31 +434,31 @@ unary_expression
 factor
 		: v=variable 
 		{
-			writeIntoCodeFile("\tmov ax, " + $v.varName + "; load variable of line " + std::to_string($v.start->getLine()) + "\n");
+			writeIntoCodeFile("\tmov ax, ", $v.varName, "; load variable of line ", $v.start->getLine(), "\n");
 		}
 	    | ID LPAREN argument_list RPAREN
 		{
 			std::string funcName = $ID->getText();
-			writeIntoCodeFile("\tcall " + funcName + "\n");
+			writeIntoCodeFile("\tcall ", funcName, "\n");
 		}
 	    | LPAREN expression RPAREN
         | CONST_INT 
 		{
-			writeIntoCodeFile("\tmov ax, " + $CONST_INT->getText() + "; integer constant of line " + std::to_string($CONST_INT->getLine()) + " loaded to ax\n");
+			writeIntoCodeFile("\tmov ax, ", $CONST_INT->getText(), "; integer constant of line ", $CONST_INT->getLine(), " loaded to ax\n");
 		}
         | CONST_FLOAT
         | v=variable INCOP 
 		{
-			writeIntoCodeFile("\tmov ax, " + $v.varName + "\n");
+			writeIntoCodeFile("\tmov ax, ", $v.varName, "\n");
 			writeIntoCodeFile("\tinc ax\n");
-			writeIntoCodeFile("\tmov " + $v.varName + ", ax\n");
+			writeIntoCodeFile("\tmov ", $v.varName, ", ax\n");
 			writeIntoCodeFile("\tdec ax\n");
 		}
         | v=variable DECOP
 		{
-			writeIntoCodeFile("\tmov ax, " + $v.varName + "\n");
+			writeIntoCodeFile("\tmov ax, ", $v.varName, "\n");
 			writeIntoCodeFile("\tdec ax\n");
-			writeIntoCodeFile("\tmov " + $v.varName + ", ax\n");	
+			writeIntoCodeFile("\tmov ", $v.varName, ", ax\n");	
 			writeIntoCodeFile("\tinc ax\n");		
 		}
         ;
@@ -554,12 +469,13 @@ argument_list
 			  ;
 	
 arguments
-		  : arguments COMMA logic_expression
+		  : logic_expression
 		  {
 			writeIntoCodeFile("\tpush ax\n");
 		  }
-	      | logic_expression
+	      ( COMMA logic_expression
 		  {
 			writeIntoCodeFile("\tpush ax\n");
 		  }
+		  )*
 	      ;
\ No newline at end of file
@@ -0,0 +1,68 @@
+#!/bin/bash
+set -e
+
+# Compares code generated in the grammar actions with code generated from the AST (--ast).
+# Both run from one build in bench/ast on every input and on a generated program with many
+# functions; code.asm and optimized_code.asm must match. Each run prints the --stats
+# numbers, the peak memory of the two ways is the one to compare.
+# usage: ./bench-ast.sh [functions in the generated program, default 5000]
+
+ANTLR_JAR="/usr/local/lib/antlr-4.13.2-complete.jar"
+INCLUDE_DIR="/usr/local/include/antlr4-runtime"
+LIB_DIR="/usr/local/lib"
+FUNCTIONS=${1:-5000}
+
+dir="bench/ast"
+mkdir -p "$dir"
+
+# many top-level units, so the parse tree and the token buffer of the whole program are
+# large while the ones of a single unit are not
+{
+    echo "int g, a[10];"
+    for ((i = 0; i < FUNCTIONS; i++)); do
+        echo "int f$i(int x, int y){"
+        echo "    int i, s, t[5];"
+        echo "    s = 0;"
+        echo "    for(i = 0; i < 5; i++){ t[i] = x * i + y; s = s + t[i] % 7; }"
+        echo "    if(s > x && s != y) s = s - 1; else if(s < 0 || x == 0) s = -s;"
+        echo "    while(s > 100) s = s / 2;"
+        echo "    return s;"
+        echo "}"
+    done
+    echo "int main(){"
+    echo "    int x;"
+    echo "    x = f0(1, 2) + g;"
+    echo "    println(x);"
+    echo "}"
+} > "$dir/long.c"
+
+cp C8086Lexer.g4 C8086Parser.g4 C8086AstParser.g4 2105120_main.cpp printProc.lib *.hpp "$dir/"
+(
+    cd "$dir"
+    java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Lexer.g4
+    java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Parser.g4
+    java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086AstParser.g4
+    g++ -std=c++17 -O2 -I"$INCLUDE_DIR" -c C8086Lexer.cpp C8086Parser.cpp C8086AstParser.cpp 2105120_main.cpp
+    g++ -std=c++17 C8086Lexer.o C8086Parser.o C8086AstParser.o 2105120_main.o -L"$LIB_DIR" -lantlr4-runtime -o 2105120_main.out -pthread
+)
+
+status=0
+for input in input/*.c "$dir/long.c"; do
+    echo "== $input"
+    case "$input" in /*) path="$input" ;; *) path="$(pwd)/$input" ;; esac
+    for way in actions ast; do
+        echo "-- $way"
+        option=""
+        if [ "$way" = ast ]; then option="--ast"; fi
+        (cd "$dir" && LD_LIBRARY_PATH="$LIB_DIR" ./2105120_main.out "$path" --stats $option > /dev/null)
+        rm -rf "$dir/output-$way"
+        mv "$dir/output" "$dir/output-$way"
+    done
+    for out in code.asm optimized_code.asm; do
+        if ! cmp -s "$dir/output-actions/$out" "$dir/output-ast/$out"; then
+            echo "DIFFERENT: $out"
+            status=1
+        fi
+    done
+done
+exit $status
@@ -0,0 +1,64 @@
+#!/bin/bash
+set -e
+
+# Compares the iterative grammar (C8086Parser.g4) with the left recursive one it replaced
+# (leftRecursiveParser.g4). Both are built into bench/<variant>, run on every input and on
+# a generated long program, and their lexer logs and asm must match. Each run prints the
+# --stats numbers: parse time, rule contexts, tree depth and peak memory.
+# usage: ./bench-grammar.sh [lines in the generated program, default 20000]
+
+ANTLR_JAR="/usr/local/lib/antlr-4.13.2-complete.jar"
+INCLUDE_DIR="/usr/local/include/antlr4-runtime"
+LIB_DIR="/usr/local/lib"
+LINES=${1:-20000}
+
+mkdir -p bench
+
+# a long program: many declarations, statements and long operator chains
+{
+    echo "int f(int a, int b, int c){"
+    echo "    return a + b * c;"
+    echo "}"
+    echo "int main(){"
+    echo -n "    int x, y, z"
+    for ((i = 0; i < 200; i++)); do echo -n ", v$i"; done
+    echo ";"
+    echo "    x = 1; y = 2; z = 3;"
+    for ((i = 0; i < LINES; i++)); do
+        echo "    x = x + y * z - f(x, y, z) + 1 + 2 + 3 + 4 * 5 * 6;"
+    done
+    echo "    println(x);"
+    echo "}"
+} > bench/long.c
+
+for variant in C8086Parser leftRecursiveParser; do
+    dir="bench/$variant"
+    mkdir -p "$dir"
+    cp C8086Lexer.g4 C8086AstParser.g4 2105120_main.cpp printProc.lib *.hpp "$dir/"
+    cp "$variant.g4" "$dir/C8086Parser.g4"
+    (
+        cd "$dir"
+        java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Lexer.g4
+        java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Parser.g4
+        java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086AstParser.g4
+        g++ -std=c++17 -O2 -I"$INCLUDE_DIR" -c C8086Lexer.cpp C8086Parser.cpp C8086AstParser.cpp 2105120_main.cpp
+        g++ -std=c++17 C8086Lexer.o C8086Parser.o C8086AstParser.o 2105120_main.o -L"$LIB_DIR" -lantlr4-runtime -o 2105120_main.out -pthread
+    )
+done
+
+status=0
+for input in input/*.c bench/long.c; do
+    echo "== $input"
+    for variant in C8086Parser leftRecursiveParser; do
+        dir="bench/$variant"
+        echo "-- $variant"
+        (cd "$dir" && LD_LIBRARY_PATH="$LIB_DIR" ./2105120_main.out "../../$input" --stats > /dev/null) || echo "failed (left recursive trees can overflow the stack)"
+    done
+    for out in lexerLog.txt code.asm optimized_code.asm; do
+        if ! cmp -s "bench/C8086Parser/output/$out" "bench/leftRecursiveParser/output/$out"; then
+            echo "DIFFERENT: $out"
+            status=1
+        fi
+    done
+done
+exit $status
@@ -13,3 +13,6 @@ done
 
 # Remove the 'output' directory if it exists
 rm -rf output
+
+# Remove the grammar benchmark builds
+rm -rf bench
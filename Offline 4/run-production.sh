@@ -0,0 +1,23 @@
+#!/bin/bash
+set -e
+
+# Same as run.sh, but built with optimization and with every log category except
+# errors compiled out (-DLOG_PRODUCTION), so token logging costs nothing at all.
+
+ANTLR_JAR="/usr/local/lib/antlr-4.13.2-complete.jar"
+INCLUDE_DIR="/usr/local/include/antlr4-runtime"
+LIB_DIR="/usr/local/lib"
+SRC_FILES="2105120_main.cpp"
+
+# === Generate Lexer & Parser with Visitors ===
+java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Lexer.g4
+java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Parser.g4
+java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086AstParser.g4
+
+
+
+# === Compile ===
+g++ -std=c++17 -O2 -DLOG_PRODUCTION -I"$INCLUDE_DIR" -c C8086Lexer.cpp C8086Parser.cpp C8086AstParser.cpp $SRC_FILES
+g++ -std=c++17 C8086Lexer.o C8086Parser.o C8086AstParser.o 2105120_main.o -L"$LIB_DIR" -lantlr4-runtime -o 2105120_main_production.out -pthread
+
+LD_LIBRARY_PATH=/usr/local/lib ./2105120_main_production.out "$@"
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace std;
+
+// Runs a command a number of times and prints the best wall time in seconds and the
+// largest peak resident memory in KB of those runs, for the regression harness.
+// The command's standard output goes to /dev/null. Exits with the command's status
+// when a run fails.
+// usage: measure <runs> <command> [arguments...]
+int main(int argc, char *argv[]) {
+    if(argc < 3) {
+        cerr << "usage: " << argv[0] << " <runs> <command> [arguments...]" << endl;
+        return 2;
+    }
+    int runs = atoi(argv[1]);
+    if(runs < 1) runs = 1;
+
+    double best = -1;
+    long peakKB = 0;
+    for(int run = 0; run < runs; run++) {
+        auto begin = chrono::steady_clock::now();
+        pid_t child = fork();
+        if(child < 0) {
+            perror("fork");
+            return 2;
+        }
+        if(child == 0) {
+            int null = open("/dev/null", O_WRONLY);
+            if(null >= 0) dup2(null, STDOUT_FILENO);
+            execvp(argv[2], argv + 2);
+            perror(argv[2]);
+            _exit(127);
+        }
+        int status = 0;
+        rusage usage;
+        if(wait4(child, &status, 0, &usage) < 0) {
+            perror("wait4");
+            return 2;
+        }
+        auto end = chrono::steady_clock::now();
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            cerr << argv[2] << " failed" << endl;
+            return WIFEXITED(status) ? WEXITSTATUS(status) : 2;
+        }
+        double seconds = chrono::duration<double>(end - begin).count();
+        if(best < 0 || seconds < best) best = seconds;
+        if(usage.ru_maxrss > peakKB) peakKB = usage.ru_maxrss;
+    }
+    cout.setf(ios::fixed);
+    cout.precision(4);
+    cout << best << " " << peakKB << endl;
+    return 0;
+}
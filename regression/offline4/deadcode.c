@@ -0,0 +1,40 @@
+int g;
+
+int early(int x){
+	if(x > 10) return 1;
+	return 2;
+	g = 99;
+	return 3;
+}
+
+int main(){
+	int a,b,i;
+	a = 4;
+	b = a * 100;
+	b = 7;
+	if(0) {
+		g = 1;
+		println(g);
+	}
+	if(1) a = a + 1;
+	else a = 1000;
+	println(a);
+	println(b);
+	i = 0;
+	while(0) {
+		i = i + 1;
+	}
+	for(i=0;i<3;i++){
+		b = b + i;
+		a = b * 2;
+	}
+	println(b);
+	g = 0;
+	a = early(5);
+	println(a);
+	a = early(50);
+	println(a);
+	println(g);
+	return 0;
+	println(a);
+}
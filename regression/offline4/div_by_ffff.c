@@ -0,0 +1,32 @@
+int g[4], gb[4];
+
+int main(){
+	int a,b,c,e,i,s,y,z,w;
+	a = 3;
+	b = 5;
+	c = 7;
+	e = 11;
+	g[0] = 1;
+	g[1] = -1;
+	g[2] = 65535;
+	g[3] = 40000;
+	s = 0;
+	i = 0;
+	while(i < 4){
+		s = s + a*b + c*e + g[i] / -1;
+		println(s);
+		i++;
+	}
+	gb[3] = 9;
+	gb[1] = 4;
+	y = 5;
+	z = -1;
+	w = (gb[3] + gb[y%4]) + (z / 65535);
+	println(w);
+	z = 40000;
+	w = (gb[3] + gb[y%4]) + (z / 65535) + (z / 32769) + (z / 50000);
+	println(w);
+	w = y * -1 + z % 65535;
+	println(w);
+	return 0;
+}
@@ -0,0 +1,38 @@
+int t[6];
+
+int main(){
+	int i,x,q,r,s;
+	t[0] = 0;
+	t[1] = 7;
+	t[2] = 1000;
+	t[3] = 32767;
+	t[4] = -1;
+	t[5] = -30000;
+	s = 0;
+	for(i=0;i<6;i++){
+		x = t[i];
+		q = x / 2;
+		println(q);
+		q = x / 3;
+		println(q);
+		q = x / 7;
+		println(q);
+		q = x / 10;
+		println(q);
+		q = x / 1000;
+		println(q);
+		q = x / 32768;
+		println(q);
+		r = x % 8;
+		println(r);
+		r = x % 10;
+		println(r);
+		r = x % 7;
+		println(r);
+		q = x * 3 + x * 7 + x * 8 - x * 15;
+		println(q);
+		s = s + x / 5 + x % 5;
+	}
+	println(s);
+	return 0;
+}
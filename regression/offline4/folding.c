@@ -0,0 +1,29 @@
+int g;
+
+int main(){
+	int a,b,c;
+	a = 2 + 3 * 4;
+	println(a);
+	b = (100 - 7) / 3 % 10;
+	println(b);
+	c = -(6 * 7) + 50;
+	println(c);
+	a = 32767 + 1;
+	println(a);
+	b = 300 * 300;
+	println(b);
+	c = (3 < 5) + (7 >= 8) + (4 == 4) + (2 != 2);
+	println(c);
+	a = (1 && 0) + (0 || 5) + (2 && 3);
+	println(a);
+	g = a * 0 + b * 1 + c - c;
+	println(g);
+	b = a + 0;
+	c = b * 2 + 0 * g;
+	println(c);
+	a = -1 / 2;
+	println(a);
+	b = -7 % 3;
+	println(b);
+	return 0;
+}
@@ -0,0 +1,50 @@
+int depth;
+
+int stir(){
+	depth = depth * 5 + 3;
+	depth = depth % 1000;
+	depth = depth * 7 + 11;
+	depth = depth % 997;
+	depth = depth + depth / 3;
+	depth = depth - depth % 9;
+	return depth;
+}
+
+int blocks(int n){
+	int s;
+	s = 0;
+	{
+		int a, b;
+		a = n * 2;
+		b = a + 1;
+		s = s + a * b;
+	}
+	{
+		int c, d, e;
+		c = n;
+		d = n + 3;
+		e = c * d;
+		s = s + c + d - e;
+	}
+	while(n > 0){
+		int k;
+		k = n % 3;
+		s = s + k;
+		n--;
+	}
+	return s;
+}
+
+int main(){
+	int r;
+	depth = 0;
+	r = stir();
+	println(r);
+	r = stir() + stir();
+	println(r);
+	r = blocks(10);
+	println(r);
+	r = blocks(3) + blocks(4);
+	println(r);
+	return 0;
+}
@@ -0,0 +1,50 @@
+int depth;
+
+int square(int x){
+	return x * x;
+}
+
+int add3(int a, int b, int c){
+	return a + b + c;
+}
+
+int leaf(){
+	return depth + 1;
+}
+
+void mark(){
+	depth = depth + 10;
+}
+
+int fib(int n){
+	int a,b,t,i;
+	a = 0;
+	b = 1;
+	for(i=0;i<n;i++){
+		t = a + b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+int main(){
+	int r,i;
+	r = square(12);
+	println(r);
+	r = add3(1, square(3), 100);
+	println(r);
+	depth = 0;
+	mark();
+	mark();
+	r = leaf();
+	println(r);
+	r = 0;
+	for(i=0;i<10;i++){
+		r = r + square(i) - add3(i, i, 1);
+	}
+	println(r);
+	r = fib(20);
+	println(r);
+	return 0;
+}
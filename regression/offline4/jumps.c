@@ -0,0 +1,48 @@
+int calls;
+
+int bump(int v){
+	calls = calls + 1;
+	return v;
+}
+
+int main(){
+	int a,b,c,i,m,n;
+	a = 5;
+	b = -3;
+	c = 0;
+	if(a > b) c = 1;
+	println(c);
+	if(a < b) c = 2;
+	else c = 3;
+	println(c);
+	m = a;
+	if(b > m) m = b;
+	println(m);
+	c = 0;
+	for(i=-3;i<4;i++){
+		if(i < 0) c = c - i;
+		else if(i == 0) c = c + 100;
+		else c = c + i * 10;
+	}
+	println(c);
+	n = 0;
+	i = 0;
+	while(i < 20){
+		if((i > 5) && (i < 12)) n = n + 1;
+		if((i < 2) || (i > 17)) n = n + 100;
+		i++;
+	}
+	println(n);
+	calls = 0;
+	if(bump(0) && bump(1)) c = 7;
+	else c = 8;
+	println(c);
+	if(bump(2) || bump(3)) c = 9;
+	println(c);
+	c = bump(0) && bump(5);
+	println(c);
+	c = bump(4) || bump(5);
+	println(c);
+	println(calls);
+	return 0;
+}
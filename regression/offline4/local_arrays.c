@@ -0,0 +1,60 @@
+int fill(int n){
+	int a[4], s, i;
+	for(i=0;i<4;i++){
+		a[i] = n + i;
+	}
+	s = 0;
+	for(i=0;i<4;i++){
+		s = s + a[i] * (i + 1);
+	}
+	return s;
+}
+
+int pick(int k){
+	int t[3], u;
+	t[0] = 5;
+	t[1] = 6;
+	t[2] = 7;
+	u = t[k % 3] + t[0];
+	return u;
+}
+
+int main(){
+	int r, b[2], i;
+	b[0] = 1;
+	b[1] = 2;
+	r = fill(10);
+	println(r);
+	{
+		int x[3], y;
+		x[0] = 100;
+		x[1] = 200;
+		x[2] = 300;
+		y = x[0] + x[1] + x[2];
+		r = y;
+	}
+	println(r);
+	{
+		int z[2], w;
+		z[1] = 9;
+		z[0] = 4;
+		w = z[1] - z[0];
+		r = w;
+	}
+	println(r);
+	r = b[0] + b[1];
+	println(r);
+	r = 0;
+	for(i=0;i<5;i++){
+		int c[2];
+		c[0] = i;
+		c[1] = i * i;
+		r = r + c[0] + c[1];
+	}
+	println(r);
+	r = pick(4) + fill(0);
+	println(r);
+	r = b[1] * 10 + b[0];
+	println(r);
+	return 0;
+}
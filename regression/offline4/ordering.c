@@ -0,0 +1,41 @@
+int g, h[3];
+
+int next(int v){
+	g = g * 10 + v;
+	return g;
+}
+
+int main(){
+	int a,b,c,d,e,r;
+	a = 2;
+	b = 3;
+	c = 5;
+	d = 7;
+	e = 11;
+	h[0] = 13;
+	h[1] = 17;
+	h[2] = 19;
+	r = a + b * (c + d * (e - a));
+	println(r);
+	r = ((a * b + c) * (d - e) + a) * b - (c + d) * (e + a * (b + c));
+	println(r);
+	r = a - (b - (c - (d - (e - h[a % 3]))));
+	println(r);
+	r = (((a - b) - c) - d) - (e * h[1] - h[2] * (h[0] - a));
+	println(r);
+	r = h[0] * h[1] + h[1] * h[2] + h[2] * h[0] - (a + b) * (c + d) * (e + h[2]);
+	println(r);
+	r = a / (b + 0) + (c * d) % (e - a) + (h[2] - h[0]) / (b - a + 1);
+	println(r);
+	g = 0;
+	r = next(1) + next(2) * next(3);
+	println(r);
+	println(g);
+	g = 0;
+	r = g + (a * (b + next(4)));
+	println(r);
+	r = (next(5) - g) * (b + c * (d + next(6)));
+	println(r);
+	println(g);
+	return 0;
+}
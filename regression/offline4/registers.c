@@ -0,0 +1,54 @@
+int g;
+
+int twice(int x){
+	return x + x;
+}
+
+int main(){
+	int a,b,c,d,e,f,h,i,s;
+	a = 1;
+	b = 2;
+	c = 3;
+	d = 4;
+	e = 5;
+	f = 6;
+	h = 7;
+	s = 0;
+	for(i=0;i<20;i++){
+		s = s + a * b + c * d + e * f + h;
+		a = a + 1;
+		b = b + c;
+		c = c - 1;
+		d = twice(d) % 100;
+		e = e + d;
+		f = f * 3 % 17;
+		h = h + a - b + c - d + e - f;
+	}
+	println(s);
+	println(a);
+	println(b);
+	println(c);
+	println(d);
+	println(e);
+	println(f);
+	println(h);
+	g = 0;
+	for(i=0;i<5;i++){
+		g = g + i;
+		s = g * 2;
+	}
+	println(g);
+	println(s);
+	a = 0;
+	b = 1;
+	c = 0;
+	for(i=0;i<30;i++){
+		a = a + i;
+		b = b * 3 % 1000;
+		c = c + a - b;
+	}
+	println(a);
+	println(b);
+	println(c);
+	return 0;
+}
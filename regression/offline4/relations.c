@@ -0,0 +1,31 @@
+int w[5];
+
+int main(){
+	int a,b,c,i,m;
+	a = 5;
+	b = -3;
+	c = a <= 5;
+	println(c);
+	c = b >= 0;
+	println(c);
+	c = (a == 5) + (b != -3);
+	println(c);
+	c = (a > 0) && (b > 0);
+	println(c);
+	c = (a > 0) || (b > 0);
+	println(c);
+	w[0] = -2;
+	w[1] = 0;
+	w[2] = 7;
+	w[3] = 32767;
+	w[4] = -32768;
+	m = 0;
+	for(i=0;i<5;i++){
+		a = w[i];
+		c = (a < 1) + (a >= 0) * 2 + (a == 7) * 4 + (a != 0) * 8 + (a > -2) * 16 + (a <= 7) * 32;
+		println(c);
+		m = m + (a > m);
+	}
+	println(m);
+	return 0;
+}
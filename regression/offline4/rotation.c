@@ -0,0 +1,50 @@
+int v[6];
+
+int main(){
+	int i,n,s,k,a,b;
+	n = 0;
+	s = 0;
+	for(i=0;i<n;i++){
+		s = s + 1;
+	}
+	println(s);
+	i = 10;
+	while(i < 5){
+		s = s + 1;
+	}
+	println(s);
+	a = 3;
+	b = 4;
+	s = 0;
+	i = 0;
+	while(i < 10){
+		k = a * b + 1;
+		s = s + k + i;
+		i++;
+	}
+	println(s);
+	println(k);
+	s = 0;
+	i = 100;
+	while(i > 0){
+		s = s + i % 10;
+		i = i / 10;
+	}
+	println(s);
+	v[0] = 4;
+	v[1] = 8;
+	v[2] = 15;
+	v[3] = 16;
+	v[4] = 23;
+	v[5] = 42;
+	n = 6;
+	s = 0;
+	i = 0;
+	while(i < n){
+		s = s + v[i] * (a + b);
+		i++;
+	}
+	println(s);
+	println(i);
+	return 0;
+}
@@ -0,0 +1,45 @@
+int gcd(int a, int b){
+	if(b == 0) return a;
+	return gcd(b, a % b);
+}
+
+int sum(int n, int acc){
+	if(n == 0) return acc;
+	return sum(n - 1, acc + n);
+}
+
+int fact(int n){
+	if(n < 2) return 1;
+	return n * fact(n - 1);
+}
+
+int isOdd(int n);
+
+int isEven(int n){
+	if(n == 0) return 1;
+	return isOdd(n - 1);
+}
+
+int isOdd(int n){
+	if(n == 0) return 0;
+	return isEven(n - 1);
+}
+
+int main(){
+	int r;
+	r = gcd(1071, 462);
+	println(r);
+	r = sum(200, 0);
+	println(r);
+	r = sum(1000, 0);
+	println(r);
+	r = fact(7);
+	println(r);
+	r = isEven(31);
+	println(r);
+	r = isOdd(31);
+	println(r);
+	r = isEven(500);
+	println(r);
+	return 0;
+}
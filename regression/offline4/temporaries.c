@@ -0,0 +1,29 @@
+int g;
+
+int twice(int x){
+	return x + x;
+}
+
+int main(){
+	int a,b,c,d,r,i;
+	a = 3;
+	b = 4;
+	c = 5;
+	d = 6;
+	r = (a + b) * (c + d) - (a - b) * (c - d) + (a * b) * (c * d);
+	println(r);
+	r = ((a + 1) * (b + 2) + (c + 3) * (d + 4)) * ((a + 5) * (b + 6) - (c + 7) * (d + 8));
+	println(r);
+	r = twice(a + b) * (c + twice(d)) + twice(twice(a) * b);
+	println(r);
+	g = 0;
+	for(i=0;i<6;i++){
+		g = g + (i + a) * (i + b) - twice(i) * (c - i);
+	}
+	println(g);
+	r = a * (b * (c * (d * (a + b))));
+	println(r);
+	r = (((((a + b) + c) + d) + a) + b) * (((c - d) - a) - b);
+	println(r);
+	return 0;
+}
@@ -0,0 +1,41 @@
+int v[8], u[40];
+
+int main(){
+	int i,j,s;
+	s = 0;
+	for(i=0;i<8;i++){
+		v[i] = i * i;
+	}
+	for(i=0;i<8;i++){
+		s = s + v[i];
+	}
+	println(s);
+	s = 0;
+	for(i=0;i<4;i++){
+		for(j=0;j<3;j++){
+			s = s + i * 3 + j;
+		}
+	}
+	println(s);
+	s = 1;
+	for(i=5;i>0;i--){
+		s = s * 2;
+	}
+	println(s);
+	println(i);
+	for(i=0;i<37;i++){
+		u[i] = i + 1;
+	}
+	s = 0;
+	for(i=3;i<37;i++){
+		s = s + u[i] * 2 - i;
+	}
+	println(s);
+	println(i);
+	s = 0;
+	for(i=0;i<1;i++){
+		s = s + 5;
+	}
+	println(s);
+	return 0;
+}
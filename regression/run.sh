@@ -0,0 +1,217 @@
+#!/bin/bash
+
+# Golden output and performance regression run over the sample files:
+#   Offline 1   2105120/sample_input.txt            -> sample_output.txt
+#   Offline 3   sample_io/inputN.txt, sampleio_abs/ -> logN.txt (parserLog), errorN.txt (errorLog)
+#   Offline 4   input/NAME.c                        -> offline4/samples/NAME.txt
+#               offline4/NAME.c                     -> offline4/NAME.txt
+#               each compiled at -O0 and at -O1, the code run by sim8086, and what the
+#               program prints compared with the expected output of the source; with
+#               offline4/NAME.O1.txt instead of NAME.txt it is checked at -O1 only
+# Every stage is built once into regression/work, every sample is run through it and its
+# outputs are compared byte for byte with the expected files; a missing expected file
+# fails the case, but for the error logs of Offline 3. Wall time (best of $RUNS runs),
+# peak memory and output bytes of each case go to regression/work/results.tsv and are
+# compared with regression/baseline.tsv. The run fails on any output difference, on a
+# failed build or run, and on a case slower than its baseline by more than $THRESHOLD
+# percent (and by more than $MIN_DELTA seconds, so timer noise on tiny runs is ignored).
+# A case the baseline has no row for is reported NEW and its time is not checked; a stage
+# with no rows at all fails the run. Only --update-baseline writes the baseline, with the
+# rows of this run in place of the old ones, and only when the run passes.
+# usage: regression/run.sh [--update-baseline]
+#   STAGES="1 3 4" stages to run
+#   RUNS=5         runs per case, the best time counts
+#   THRESHOLD=25   allowed slowdown in percent
+#   MIN_DELTA=0.02 slowdowns below this many seconds never fail
+
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+HERE="$ROOT/regression"
+WORK="$HERE/work"
+BASELINE="$HERE/baseline.tsv"
+RESULTS="$WORK/results.tsv"
+
+ANTLR_JAR="/usr/local/lib/antlr-4.13.2-complete.jar"
+INCLUDE_DIR="/usr/local/include/antlr4-runtime"
+LIB_DIR="/usr/local/lib"
+
+STAGES=${STAGES:-"1 3 4"}
+RUNS=${RUNS:-5}
+THRESHOLD=${THRESHOLD:-25}
+MIN_DELTA=${MIN_DELTA:-0.02}
+UPDATE=0
+if [ "${1:-}" = "--update-baseline" ]; then UPDATE=1; fi
+
+rm -rf "$WORK"
+mkdir -p "$WORK"
+g++ -std=c++17 -O2 "$HERE/measure.cpp" -o "$WORK/measure" || exit 1
+g++ -std=c++17 -O2 "$HERE/sim8086.cpp" -o "$WORK/sim8086" || exit 1
+
+status=0
+echo -e "case\tstatus\tseconds\tpeak_kb\toutput_bytes" > "$RESULTS"
+
+# run_case <name> <directory to run in> <"actual:expected" pairs separated by ;> [<function>] -- <command...>
+# an expected file ending in ? may be missing, any other one must exist; the function, when
+# given, runs in the directory after the command and before the comparison
+run_case() {
+    local name="$1" dir="$2" pairs="$3" after=""
+    shift 3
+    if [ "$1" != "--" ]; then after="$1"; shift; fi
+    shift
+    local result="ok" measured seconds="-" peak="-" bytes=0 pair actual expected list
+    if measured=$(cd "$dir" && LD_LIBRARY_PATH="$LIB_DIR" "$WORK/measure" "$RUNS" "$@") &&
+       { [ -z "$after" ] || (cd "$dir" && "$after"); }; then
+        read -r seconds peak <<< "$measured"
+        IFS=';' read -ra list <<< "$pairs"
+        for pair in "${list[@]}"; do
+            actual="$dir/${pair%%:*}"
+            expected="${pair#*:}"
+            if [ "${expected%\?}" != "$expected" ]; then
+                expected="${expected%\?}"
+                [ -f "$expected" ] || continue # no expected file for this output
+            elif [ ! -f "$expected" ]; then
+                result="MISSING"
+                echo "$name: no expected file $expected"
+                continue
+            fi
+            bytes=$((bytes + $(wc -c < "$actual")))
+            if ! cmp -s "$actual" "$expected"; then
+                result="DIFFERENT"
+                echo "$name: ${pair%%:*} differs from $expected"
+                diff "$actual" "$expected" | head -5
+            fi
+        done
+    else
+        result="FAILED"
+    fi
+    [ "$result" = ok ] || status=1
+    echo -e "$name\t$result\t$seconds\t$peak\t$bytes" >> "$RESULTS"
+}
+
+for stage in $STAGES; do
+    case "$stage" in
+    1)
+        src="$ROOT/Offline 1/2105120"
+        build="$WORK/offline1"
+        mkdir -p "$build"
+        if ! g++ -std=c++17 -O2 "$src/2105120_main.cpp" -o "$build/2105120_main.out"; then
+            echo "Offline 1: build failed"
+            status=1
+            continue
+        fi
+        run_case "offline1/sample" "$build" "output.txt:$src/sample_output.txt" -- ./2105120_main.out "$src/sample_input.txt" output.txt
+        ;;
+    3)
+        src="$ROOT/Offline 3"
+        build="$WORK/offline3"
+        mkdir -p "$build"
+        cp "$src/C8086Lexer.g4" "$src/C8086Parser.g4" "$src/Ctester.cpp" "$src"/*.hpp "$build/"
+        if ! (
+            cd "$build" &&
+            java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Lexer.g4 &&
+            java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Parser.g4 &&
+            g++ -std=c++17 -O2 -w -I"$INCLUDE_DIR" -c C8086Lexer.cpp C8086Parser.cpp Ctester.cpp &&
+            g++ -std=c++17 C8086Lexer.o C8086Parser.o Ctester.o -L"$LIB_DIR" -lantlr4-runtime -o Ctester.out -pthread
+        ); then
+            echo "Offline 3: build failed"
+            status=1
+            continue
+        fi
+        for set in sample_io sampleio_abs; do
+            for input in "$src/$set"/input*.txt; do
+                n=$(basename "$input" .txt)
+                n=${n#input}
+                run_case "offline3/$set/$n" "$build" "output/parserLog.txt:$src/$set/log$n.txt;output/errorLog.txt:$src/$set/error$n.txt?" -- ./Ctester.out "$input"
+            done
+        done
+        ;;
+    4)
+        src="$ROOT/Offline 4"
+        build="$WORK/offline4"
+        mkdir -p "$build"
+        cp "$src"/*.g4 "$src"/*.hpp "$src/2105120_main.cpp" "$src/printProc.lib" "$build/"
+        if ! (
+            cd "$build" &&
+            java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Lexer.g4 &&
+            java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086Parser.g4 &&
+            java -Xmx500M -cp "$ANTLR_JAR:." org.antlr.v4.Tool -Dlanguage=Cpp C8086AstParser.g4 &&
+            g++ -std=c++17 -O2 -w -I"$INCLUDE_DIR" -c C8086Lexer.cpp C8086Parser.cpp C8086AstParser.cpp 2105120_main.cpp &&
+            g++ -std=c++17 C8086Lexer.o C8086Parser.o C8086AstParser.o 2105120_main.o -L"$LIB_DIR" -lantlr4-runtime -o 2105120_main.out -pthread
+        ); then
+            echo "Offline 4: build failed"
+            status=1
+            continue
+        fi
+        run_program() {
+            "$WORK/sim8086" output/code.asm > output/program.txt 2> output/sim.txt || { cat output/sim.txt; return 1; }
+        }
+        for input in "$src"/input/*.c "$HERE"/offline4/*.c; do
+            [ -f "$input" ] || continue # no test programs
+            n=$(basename "$input" .c)
+            expected="$HERE/offline4/$n.txt"
+            case "$input" in "$src"/input/*) expected="$HERE/offline4/samples/$n.txt" ;; esac
+            for level in 0 1; do
+                wanted="$expected"
+                if [ ! -f "$expected" ] && [ -f "${expected%.txt}.O1.txt" ]; then
+                    wanted="${expected%.txt}.O$level.txt"
+                    [ -f "$wanted" ] || continue # checked at the other level only
+                fi
+                rm -f "$build/output/code.asm" "$build/output/program.txt"
+                run_case "offline4/$n/O$level" "$build" "output/program.txt:$wanted" run_program -- ./2105120_main.out "$input" -O$level
+            done
+        done
+        ;;
+    *)
+        echo "unknown stage $stage"
+        status=1
+        ;;
+    esac
+done
+
+# compare with the baseline: case, seconds and peak memory from both, one line per case
+baseline="$BASELINE"
+if [ ! -f "$baseline" ] || [ $UPDATE -eq 1 ]; then
+    baseline="$WORK/no-baseline.tsv"
+    echo "case" > "$baseline"
+fi
+if ! awk -F'\t' -v threshold="$THRESHOLD" -v minDelta="$MIN_DELTA" '
+    NR == FNR { if (FNR > 1) { time[$1] = $3; peak[$1] = $4 } next }
+    FNR == 1 { printf "%-28s %-10s %10s %10s %10s %10s %12s\n", "case", "status", "seconds", "baseline", "peak KB", "baseline", "output bytes"; next }
+    {
+        base = ($1 in time) ? time[$1] : "-"
+        note = ""
+        if (base != "-" && $3 != "-" && $3 > base * (1 + threshold / 100) && $3 - base > minDelta) {
+            note = "  SLOWER"
+            slow = 1
+        }
+        if (base == "-") note = "  NEW, time not checked"
+        printf "%-28s %-10s %10s %10s %10s %10s %12s%s\n", $1, $2, $3, base, $4, ($1 in peak) ? peak[$1] : "-", $5, note
+    }
+    END { exit slow }
+' "$baseline" "$RESULTS"; then
+    echo "time regression above $THRESHOLD%"
+    status=1
+fi
+
+# a stage without a single baseline row would pass however slow it got
+if [ $UPDATE -eq 0 ]; then
+    for stage in $STAGES; do
+        if ! awk -F'\t' -v prefix="offline$stage/" 'index($1, prefix) == 1 { found = 1 } END { exit !found }' "$baseline"; then
+            echo "NO BASELINE for Offline $stage: its times are not checked, record them with --update-baseline"
+            status=1
+        fi
+    done
+fi
+
+if [ $UPDATE -eq 1 ]; then
+    if [ $status -ne 0 ]; then
+        echo "not updating the baseline, the run failed"
+    else
+        # the rows of this run, and the old rows of the cases it did not run
+        [ -f "$BASELINE" ] || head -1 "$RESULTS" > "$BASELINE"
+        awk -F'\t' 'NR == FNR { if (FNR > 1) ran[$1] = 1; print; next } FNR > 1 && !($1 in ran)' "$RESULTS" "$BASELINE" > "$WORK/baseline.tsv"
+        cp "$WORK/baseline.tsv" "$BASELINE"
+        echo "baseline updated: $BASELINE"
+    fi
+fi
+
+exit $status
@@ -0,0 +1,475 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+
+using namespace std;
+
+// Runs the 8086 assembly of the Offline 4 compiler (output/code.asm) and prints what the
+// program prints, for the regression harness. It knows what the code generator and
+// printProc.lib write: the small model, dw and db data, procs and labels, the integer
+// instructions they use and int 21h functions 2, 9 and 4Ch. Carriage returns are left out
+// of the output. Exits with 1 on anything else, on a division fault and when the program
+// runs more than <limit> instructions; the number it ran goes to standard error.
+// usage: sim8086 <file.asm> [limit]
+
+enum Register { AX, CX, DX, BX, SP, BP, SI, DI, DS };
+
+struct Operand {
+    enum Kind { NONE, REG16, REG8, IMMEDIATE, MEMORY } kind = NONE;
+    int reg = 0;       // REG16: a Register; REG8: the Register of the word, with high set for ah..dh
+    bool high = false;
+    int value = 0;     // IMMEDIATE: the value; MEMORY: the displacement with the address of a symbol
+    vector<pair<int, int>> index; // MEMORY: sign and Register of each register added
+    int size = 0;      // 8 or 16 when written as byte ptr or word ptr, or for a register
+    string label;      // a jump or call target
+};
+
+struct Instruction {
+    string op;
+    Operand a, b;
+    int target = -1; // of a jump or call
+    int line = 0;
+};
+
+[[noreturn]] void fail(int line, const string &message) {
+    cerr << "line " << line << ": " << message << endl;
+    exit(1);
+}
+
+string trim(const string &s) {
+    size_t begin = s.find_first_not_of(" \t\r"), end = s.find_last_not_of(" \t\r");
+    return begin == string::npos ? "" : s.substr(begin, end - begin + 1);
+}
+
+string lower(string s) {
+    for(char &c : s) c = tolower((unsigned char)c);
+    return s;
+}
+
+// the line without its comment, a ; inside quotes is kept
+string uncomment(const string &line) {
+    bool quoted = false;
+    for(size_t i = 0; i < line.size(); i++) {
+        if(line[i] == '"' || line[i] == '\'') quoted = !quoted;
+        if(line[i] == ';' && !quoted) return line.substr(0, i);
+    }
+    return line;
+}
+
+bool isName(const string &s) {
+    if(s.empty() || !(isalpha((unsigned char)s[0]) || s[0] == '_' || s[0] == '@')) return false;
+    for(char c : s) if(!isalnum((unsigned char)c) && c != '_' && c != '@') return false;
+    return true;
+}
+
+class Machine {
+    public:
+        bool load(istream &in) {
+            string raw;
+            int line = 0;
+            bool data = false;
+            vector<pair<string, int>> unresolved; // labels named by jumps and calls, and where
+            while(getline(in, raw)) {
+                line++;
+                string s = trim(uncomment(raw));
+                string word = lower(s.substr(0, s.find_first_of(" \t")));
+                if(s.empty() || word == ".model" || word == ".stack" || word == "end") continue;
+                if(word == ".data") { data = true; continue; }
+                if(word == ".code") { data = false; continue; }
+                if(data) { define(s, line); continue; }
+
+                istringstream words(s);
+                string first, second;
+                words >> first >> second;
+                if(lower(second) == "proc") { labels[first] = code.size(); continue; }
+                if(lower(second) == "endp") continue;
+                size_t colon = s.find(':');
+                if(colon != string::npos && isName(trim(s.substr(0, colon)))) {
+                    labels[trim(s.substr(0, colon))] = code.size();
+                    s = trim(s.substr(colon + 1));
+                    if(s.empty()) continue;
+                }
+
+                Instruction instr;
+                instr.line = line;
+                size_t space = s.find_first_of(" \t");
+                instr.op = lower(s.substr(0, space));
+                string rest = space == string::npos ? "" : trim(s.substr(space));
+                size_t comma = rest.find(',');
+                if(!rest.empty()) instr.a = operand(trim(rest.substr(0, comma)), line);
+                if(comma != string::npos) instr.b = operand(trim(rest.substr(comma + 1)), line);
+                if(!instr.a.label.empty()) unresolved.push_back({instr.a.label, (int)code.size()});
+                code.push_back(instr);
+            }
+            for(const auto &[label, at] : unresolved) {
+                const Instruction &instr = code[at];
+                bool branch = instr.op == "call" || instr.op[0] == 'j';
+                if(!branch) fail(instr.line, "unknown operand " + label);
+                if(!labels.count(label)) fail(instr.line, "no label " + label);
+                code[at].target = labels[label];
+            }
+            return labels.count("main");
+        }
+
+        // runs main until it calls int 21h function 4Ch
+        void run(long long limit) {
+            regs[SP] = 0xFFFE;
+            push(0xFFFF); // a return from main ends up here
+            int pc = labels["main"];
+            while(true) {
+                if(pc < 0 || pc >= (int)code.size()) fail(0, "ran off the code");
+                if(++executed > limit) fail(code[pc].line, "more than " + to_string(limit) + " instructions");
+                const Instruction &instr = code[pc++];
+                if(step(instr, pc)) return;
+            }
+        }
+
+        string output;
+        long long executed = 0;
+
+    private:
+        vector<Instruction> code;
+        map<string, int> labels;
+        map<string, int> symbols; // data addresses
+        int dataEnd = 0x100;
+        uint8_t memory[65536] = {};
+        uint16_t regs[9] = {};
+        bool zero = false, sign = false, carry = false, overflow = false;
+
+        void define(const string &s, int line) {
+            istringstream words(s);
+            string name, kind, value;
+            words >> name >> kind;
+            getline(words, value);
+            kind = lower(kind);
+            value = trim(value);
+            symbols[name] = dataEnd;
+            if(kind == "db" && value.size() >= 2 && value[0] == '"') {
+                for(size_t i = 1; i + 1 < value.size(); i++) memory[dataEnd++] = value[i];
+            }
+            else if(kind == "dw") {
+                size_t dup = lower(value).find("dup");
+                dataEnd += 2 * (dup == string::npos ? 1 : atoi(value.c_str()));
+            }
+            else fail(line, "unknown data " + s);
+        }
+
+        static int registerNumber(const string &name) {
+            static const char *names[] = {"ax", "cx", "dx", "bx", "sp", "bp", "si", "di", "ds"};
+            for(int i = 0; i < 9; i++) if(name == names[i]) return i;
+            return -1;
+        }
+
+        bool immediate(const string &text, int &value) {
+            string t = lower(text);
+            if(t.size() == 3 && t[0] == '\'' && t[2] == '\'') { value = (unsigned char)text[1]; return true; }
+            if(t == "@data") { value = 0; return true; }
+            bool negative = !t.empty() && t[0] == '-';
+            string digits = negative ? t.substr(1) : t;
+            if(digits.empty() || !isdigit((unsigned char)digits[0])) return false;
+            char *end = nullptr;
+            long v = digits.back() == 'h' ? strtol(digits.c_str(), &end, 16) : strtol(digits.c_str(), &end, 10);
+            if(*end != '\0' && !(digits.back() == 'h' && end == &digits[digits.size() - 1])) return false;
+            value = (int)(negative ? -v : v);
+            return true;
+        }
+
+        Operand operand(string text, int line) {
+            Operand op;
+            string t = lower(text);
+            if(t.rfind("byte ptr", 0) == 0) { op.size = 8; text = trim(text.substr(8)); }
+            else if(t.rfind("word ptr", 0) == 0) { op.size = 16; text = trim(text.substr(8)); }
+            t = lower(text);
+            int reg = registerNumber(t);
+            if(reg >= 0) {
+                op.kind = Operand::REG16;
+                op.reg = reg;
+                op.size = 16;
+                return op;
+            }
+            if(t.size() == 2 && (t[1] == 'l' || t[1] == 'h') && registerNumber(string(1, t[0]) + "x") >= 0) {
+                op.kind = Operand::REG8;
+                op.reg = registerNumber(string(1, t[0]) + "x");
+                op.high = t[1] == 'h';
+                op.size = 8;
+                return op;
+            }
+            if(immediate(text, op.value)) {
+                op.kind = Operand::IMMEDIATE;
+                return op;
+            }
+            size_t bracket = text.find('[');
+            string name = trim(text.substr(0, bracket));
+            if(bracket == string::npos && !symbols.count(name)) {
+                op.label = name;
+                return op;
+            }
+            op.kind = Operand::MEMORY;
+            if(!name.empty()) {
+                if(!symbols.count(name)) fail(line, "unknown symbol " + name);
+                op.value = symbols[name];
+            }
+            if(bracket == string::npos) return op;
+            string inside = text.substr(bracket + 1, text.find(']') - bracket - 1);
+            int sign = 1;
+            string term;
+            for(size_t i = 0; i <= inside.size(); i++) {
+                char c = i < inside.size() ? inside[i] : '+';
+                if(c != '+' && c != '-') { term += c; continue; }
+                term = lower(trim(term));
+                if(!term.empty()) {
+                    int value;
+                    if(registerNumber(term) >= 0) op.index.push_back({sign, registerNumber(term)});
+                    else if(immediate(term, value)) op.value += sign * value;
+                    else fail(line, "unknown address " + text);
+                }
+                sign = c == '-' ? -1 : 1;
+                term.clear();
+            }
+            return op;
+        }
+
+        uint16_t address(const Operand &op) const {
+            int at = op.value;
+            for(const auto &[sign, reg] : op.index) at += sign * regs[reg];
+            return (uint16_t)at;
+        }
+
+        static int width(const Operand &a, const Operand &b) {
+            return a.size == 8 || b.size == 8 ? 8 : 16;
+        }
+
+        int get(const Operand &op, int size, int line) const {
+            switch(op.kind) {
+                case Operand::REG16: return regs[op.reg];
+                case Operand::REG8: return op.high ? regs[op.reg] >> 8 : regs[op.reg] & 0xFF;
+                case Operand::IMMEDIATE: return op.value & (size == 8 ? 0xFF : 0xFFFF);
+                case Operand::MEMORY: {
+                    uint16_t at = address(op);
+                    return size == 8 ? memory[at] : memory[at] | memory[(uint16_t)(at + 1)] << 8;
+                }
+                default: fail(line, "bad operand");
+            }
+        }
+
+        void put(const Operand &op, int value, int size, int line) {
+            switch(op.kind) {
+                case Operand::REG16: regs[op.reg] = value; break;
+                case Operand::REG8:
+                    if(op.high) regs[op.reg] = (regs[op.reg] & 0x00FF) | (value & 0xFF) << 8;
+                    else regs[op.reg] = (regs[op.reg] & 0xFF00) | (value & 0xFF);
+                    break;
+                case Operand::MEMORY: {
+                    uint16_t at = address(op);
+                    memory[at] = value;
+                    if(size == 16) memory[(uint16_t)(at + 1)] = value >> 8;
+                    break;
+                }
+                default: fail(line, "bad destination");
+            }
+        }
+
+        void push(int value) {
+            regs[SP] -= 2;
+            memory[regs[SP]] = value;
+            memory[(uint16_t)(regs[SP] + 1)] = value >> 8;
+        }
+
+        int pop() {
+            int value = memory[regs[SP]] | memory[(uint16_t)(regs[SP] + 1)] << 8;
+            regs[SP] += 2;
+            return value;
+        }
+
+        void setZeroSign(int value, int size) {
+            int mask = size == 8 ? 0xFF : 0xFFFF;
+            zero = (value & mask) == 0;
+            sign = (value >> (size - 1)) & 1;
+        }
+
+        bool condition(const string &op, bool &known) const {
+            known = true;
+            bool less = sign != overflow;
+            if(op == "je" || op == "jz") return zero;
+            if(op == "jne" || op == "jnz") return !zero;
+            if(op == "jl" || op == "jnge") return less;
+            if(op == "jge" || op == "jnl") return !less;
+            if(op == "jle" || op == "jng") return zero || less;
+            if(op == "jg" || op == "jnle") return !zero && !less;
+            if(op == "jb" || op == "jnae" || op == "jc") return carry;
+            if(op == "jae" || op == "jnb" || op == "jnc") return !carry;
+            if(op == "jbe" || op == "jna") return carry || zero;
+            if(op == "ja" || op == "jnbe") return !carry && !zero;
+            if(op == "js") return sign;
+            if(op == "jns") return !sign;
+            known = false;
+            return false;
+        }
+
+        static int signedWord(int value) {
+            return (int16_t)(uint16_t)value;
+        }
+
+        // executes one instruction, true when the program exits
+        bool step(const Instruction &instr, int &pc) {
+            const string &op = instr.op;
+            const Operand &a = instr.a, &b = instr.b;
+            int line = instr.line;
+            if(op == "mov") {
+                int size = width(a, b);
+                put(a, get(b, size, line), size, line);
+            }
+            else if(op == "add" || op == "adc" || op == "sub" || op == "sbb" || op == "cmp") {
+                int size = width(a, b), mask = size == 8 ? 0xFF : 0xFFFF;
+                int x = get(a, size, line), y = get(b, size, line), r;
+                if(op == "add" || op == "adc") {
+                    r = x + y + (op == "adc" && carry);
+                    carry = r > mask;
+                    overflow = (((x ^ r) & (y ^ r)) >> (size - 1)) & 1;
+                }
+                else {
+                    r = x - y - (op == "sbb" && carry);
+                    carry = r < 0;
+                    overflow = (((x ^ y) & (x ^ r)) >> (size - 1)) & 1;
+                }
+                r &= mask;
+                setZeroSign(r, size);
+                if(op != "cmp") put(a, r, size, line);
+            }
+            else if(op == "inc" || op == "dec") {
+                int size = width(a, b), mask = size == 8 ? 0xFF : 0xFFFF, top = 1 << (size - 1);
+                int x = get(a, size, line), r = (op == "inc" ? x + 1 : x - 1) & mask;
+                overflow = op == "inc" ? r == top : x == top;
+                setZeroSign(r, size);
+                put(a, r, size, line);
+            }
+            else if(op == "neg") {
+                int size = width(a, b), mask = size == 8 ? 0xFF : 0xFFFF;
+                int x = get(a, size, line), r = -x & mask;
+                carry = x != 0;
+                overflow = x == (1 << (size - 1));
+                setZeroSign(r, size);
+                put(a, r, size, line);
+            }
+            else if(op == "not") {
+                int size = width(a, b);
+                put(a, ~get(a, size, line), size, line);
+            }
+            else if(op == "and" || op == "or" || op == "xor" || op == "test") {
+                int size = width(a, b);
+                int x = get(a, size, line), y = get(b, size, line);
+                int r = op == "or" ? x | y : op == "xor" ? x ^ y : x & y;
+                carry = overflow = false;
+                setZeroSign(r, size);
+                if(op != "test") put(a, r, size, line);
+            }
+            else if(op == "xchg") {
+                int size = width(a, b);
+                int x = get(a, size, line), y = get(b, size, line);
+                put(a, y, size, line);
+                put(b, x, size, line);
+            }
+            else if(op == "mul") {
+                unsigned r = (unsigned)regs[AX] * (unsigned)get(a, 16, line);
+                regs[AX] = r;
+                regs[DX] = r >> 16;
+                carry = overflow = regs[DX] != 0;
+            }
+            else if(op == "imul") {
+                int r = signedWord(regs[AX]) * signedWord(get(a, 16, line));
+                regs[AX] = r;
+                regs[DX] = (unsigned)r >> 16;
+                carry = overflow = r != signedWord(r);
+            }
+            else if(op == "div") {
+                unsigned divisor = get(a, 16, line), dividend = (unsigned)regs[DX] << 16 | regs[AX];
+                if(divisor == 0 || dividend / divisor > 0xFFFF) fail(line, "divide overflow");
+                regs[AX] = dividend / divisor;
+                regs[DX] = dividend % divisor;
+            }
+            else if(op == "idiv") {
+                long long divisor = signedWord(get(a, 16, line));
+                long long dividend = (int32_t)((unsigned)regs[DX] << 16 | regs[AX]);
+                if(divisor == 0 || dividend / divisor < -32768 || dividend / divisor > 32767) fail(line, "divide overflow");
+                regs[AX] = dividend / divisor;
+                regs[DX] = dividend % divisor;
+            }
+            else if(op == "cwd") regs[DX] = regs[AX] & 0x8000 ? 0xFFFF : 0;
+            else if(op == "shl" || op == "sal" || op == "shr" || op == "sar") {
+                int size = a.size == 8 ? 8 : 16, mask = size == 8 ? 0xFF : 0xFFFF;
+                int x = get(a, size, line), count = get(b, 8, line) & 0x1F;
+                for(int i = 0; i < count; i++) {
+                    if(op == "shl" || op == "sal") {
+                        carry = (x >> (size - 1)) & 1;
+                        x = (x << 1) & mask;
+                    }
+                    else {
+                        carry = x & 1;
+                        x = op == "shr" ? x >> 1 : (x >> 1) | (x & (1 << (size - 1)));
+                    }
+                }
+                if(count > 0) setZeroSign(x, size);
+                put(a, x, size, line);
+            }
+            else if(op == "push") push(get(a, 16, line));
+            else if(op == "pop") put(a, pop(), 16, line);
+            else if(op == "lea") put(a, b.kind == Operand::MEMORY ? address(b) : get(b, 16, line), 16, line);
+            else if(op == "call") {
+                push(pc);
+                pc = instr.target;
+            }
+            else if(op == "ret") {
+                pc = pop();
+                if(a.kind == Operand::IMMEDIATE) regs[SP] += a.value;
+                if(pc == 0xFFFF) fail(line, "main returned");
+            }
+            else if(op == "jmp") pc = instr.target;
+            else if(op == "int") {
+                int function = regs[AX] >> 8;
+                if(a.value != 0x21) fail(line, "unknown interrupt");
+                if(function == 0x4C) return true;
+                if(function == 2) {
+                    char c = regs[DX] & 0xFF;
+                    if(c != '\r') output += c;
+                }
+                else if(function == 9) {
+                    for(uint16_t at = regs[DX]; memory[at] != '$'; at++) output += (char)memory[at];
+                }
+                else fail(line, "unknown int 21h function");
+            }
+            else {
+                bool known;
+                bool taken = condition(op, known);
+                if(!known) fail(line, "unknown instruction " + op);
+                if(taken) pc = instr.target;
+            }
+            return false;
+        }
+};
+
+int main(int argc, char *argv[]) {
+    if(argc < 2) {
+        cerr << "usage: " << argv[0] << " <file.asm> [limit]" << endl;
+        return 2;
+    }
+    ifstream in(argv[1]);
+    if(!in) {
+        cerr << "cannot open " << argv[1] << endl;
+        return 2;
+    }
+    static Machine machine;
+    if(!machine.load(in)) {
+        cerr << argv[1] << ": no main proc" << endl;
+        return 1;
+    }
+    machine.run(argc > 2 ? atoll(argv[2]) : 100000000);
+    cout << machine.output;
+    cerr << "instructions " << machine.executed << endl;
+    return 0;
+}